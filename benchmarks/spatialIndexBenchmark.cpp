@@ -0,0 +1,93 @@
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <vector>
+
+#include "../src/collision.h"
+#include "../src/jobSystem.h"
+#include "../src/linearQuadTree.h"
+#include "../src/quadTree.h"
+#include "../src/spatialHashGrid.h"
+
+/*Moves agents around the window and has every agent query its neighbourhood each frame, like the enemies looking for separation neighbours.
+Prints the time spent updating and querying per frame and how many stored colliders a query tested on average, so indexes can be compared at the same load.
+Run it from a release build, the agent counts are the ones the waves reach*/
+namespace {
+	const float worldWidth = 1280.f;
+	const float worldHeight = 720.f;
+	const float agentRadius = 16.f;
+	const float neighbourRadius = 64.f;
+	const unsigned int frameCount = 30;
+	//The node capacity the game gives its quadtrees
+	const unsigned int nodeCapacity = 100;
+	//The cell size the game gives its hash grids
+	const float cellSize = 32.f;
+
+	void RunBenchmark(const char* name, SpatialIndex<unsigned int>& spatialIndex, const unsigned int& agentCount) {
+		std::mt19937 randomEngine(1);
+		std::uniform_real_distribution<float> x(agentRadius, worldWidth - agentRadius);
+		std::uniform_real_distribution<float> y(agentRadius, worldHeight - agentRadius);
+		std::uniform_real_distribution<float> step(-3.f, 3.f);
+
+		std::vector<std::shared_ptr<Collider>> agents;
+		for (unsigned int i = 0; i < agentCount; i++) {
+			std::shared_ptr<Circle> circle = std::make_shared<Circle>();
+			circle->Init(Vector2<float>(x(randomEngine), y(randomEngine)), agentRadius);
+			agents.push_back(circle);
+			spatialIndex.Insert(i, circle, 1);
+		}
+		spatialIndex.Rebuild();
+		spatialIndex.ResetStatistics();
+
+		std::shared_ptr<Circle> neighbourhood = std::make_shared<Circle>();
+		std::vector<unsigned int> objectsFound;
+		double updateMilliseconds = 0.0;
+		double queryMilliseconds = 0.0;
+		for (unsigned int frame = 0; frame < frameCount; frame++) {
+			const std::chrono::steady_clock::time_point updateStart = std::chrono::steady_clock::now();
+			for (unsigned int i = 0; i < agentCount; i++) {
+				const Vector2<float> position = agents[i]->GetPosition();
+				agents[i]->SetPosition(Vector2<float>(std::clamp(position.x + step(randomEngine), agentRadius, worldWidth - agentRadius), std::clamp(position.y + step(randomEngine), agentRadius, worldHeight - agentRadius)));
+				spatialIndex.Update(i, agents[i], 1);
+			}
+			spatialIndex.Rebuild();
+			const std::chrono::steady_clock::time_point queryStart = std::chrono::steady_clock::now();
+			for (unsigned int i = 0; i < agentCount; i++) {
+				neighbourhood->Init(agents[i]->GetPosition(), neighbourRadius);
+				objectsFound.clear();
+				spatialIndex.Query(neighbourhood, objectsFound, allCollisionLayers);
+			}
+			const std::chrono::steady_clock::time_point queryEnd = std::chrono::steady_clock::now();
+			updateMilliseconds += std::chrono::duration<double, std::milli>(queryStart - updateStart).count();
+			queryMilliseconds += std::chrono::duration<double, std::milli>(queryEnd - queryStart).count();
+		}
+
+		std::cout << name << ", " << agentCount << " agents: update " << updateMilliseconds / frameCount << " ms, query " << queryMilliseconds / frameCount
+			<< " ms per frame, " << spatialIndex.GetCandidatesPerQuery() << " candidates per query" << std::endl;
+	}
+}
+
+int main() {
+	jobSystem = std::make_shared<JobSystem>();
+	jobSystem->Init(1);
+
+	QuadTreeNode boundary;
+	boundary.rectangle = std::make_shared<AABB>();
+	boundary.rectangle->Init(Vector2<float>(worldWidth / 2, worldHeight / 2), worldHeight, worldWidth);
+
+	for (const unsigned int agentCount : { 1000, 3000, 10000 }) {
+		QuadTree<unsigned int> quadTree(boundary, nodeCapacity);
+		RunBenchmark("Quadtree", quadTree, agentCount);
+		QuadTree<unsigned int> looseQuadTree(boundary, nodeCapacity, QuadTreeType::Loose);
+		RunBenchmark("Loose quadtree", looseQuadTree, agentCount);
+		SpatialHashGrid<unsigned int> spatialHashGrid(*boundary.rectangle, cellSize);
+		RunBenchmark("Spatial hash grid", spatialHashGrid, agentCount);
+		LinearQuadTree<unsigned int> linearQuadTree(nodeCapacity);
+		RunBenchmark("Linear quadtree", linearQuadTree, agentCount);
+	}
+
+	jobSystem->ShutDown();
+	return 0;
+}
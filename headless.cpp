@@ -0,0 +1,149 @@
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <iostream>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "src/enemyManager.h"
+#include "src/fixedTimestep.h"
+#include "src/gameEngine.h"
+#include "src/jobSystem.h"
+#include "src/nullRenderBackend.h"
+#include "src/playerCharacter.h"
+#include "src/projectileManager.h"
+#include "src/sprite.h"
+#include "src/stateStack.h"
+#include "src/universalFunctions.h"
+
+//Printed for --help
+const char* usage =
+	"Usage: TheOneTrueKingHeadless [options]\n"
+	"\t--mode survival|formation|bossrush|all\tthe modes to run in any letter case, all by default\n"
+	"\t--steps N\tsimulation steps per mode, 3600 by default which is one minute of game time\n"
+	"\t--workers N\tthreads of the job system, the hardware threads by default\n"
+	"\t--seed N\tseed of the random engine so two runs spawn the same enemies, 1 by default\n"
+	"\t--help\tprints this and exits";
+
+/*Runs the game modes without a window for benchmarks on machines with no display or GPU, run it from the repository root so it finds res.
+The player stands in the middle holding the fire button toward the cursor, when it dies the mode starts over.
+The options are listed in usage above*/
+int main(int argc, char* argv[]) {
+	std::vector<GameMode> gameModes = { GameMode::Survival, GameMode::Formation, GameMode::BossRush };
+	unsigned int stepCount = 3600;
+	unsigned int workerCount = std::thread::hardware_concurrency();
+	unsigned int seed = 1;
+	for (int i = 1; i < argc; i += 2) {
+		const std::string argument = argv[i];
+		if (argument == "--help") {
+			std::cout << usage << std::endl;
+			return 0;
+		}
+		if (i + 1 == argc) {
+			std::cerr << "Missing value for " << argument << std::endl;
+			return 1;
+		}
+		std::string value = argv[i + 1];
+		if (argument == "--mode") {
+			std::transform(value.begin(), value.end(), value.begin(), [](const unsigned char character) { return (char)std::tolower(character); });
+			if (value == "survival") {
+				gameModes = { GameMode::Survival };
+			} else if (value == "formation") {
+				gameModes = { GameMode::Formation };
+			} else if (value == "bossrush") {
+				gameModes = { GameMode::BossRush };
+			} else if (value != "all") {
+				std::cerr << "Unknown mode " << argv[i + 1] << ", use survival, formation, bossrush or all" << std::endl;
+				return 1;
+			}
+		} else if (argument == "--steps" || argument == "--workers" || argument == "--seed") {
+			//stoul throws on text that does not start with a number, signs, trailing text and numbers too large are rejected here too
+			unsigned int number = 0;
+			try {
+				std::size_t parsedLength = 0;
+				const unsigned long parsedNumber = std::stoul(value, &parsedLength);
+				if (!std::isdigit((unsigned char)value[0]) || parsedLength != value.size() || parsedNumber > std::numeric_limits<unsigned int>::max()) {
+					throw std::invalid_argument(value);
+				}
+				number = (unsigned int)parsedNumber;
+			} catch (const std::exception&) {
+				std::cerr << "Invalid value for " << argument << std::endl;
+				return 1;
+			}
+			if (argument == "--steps") {
+				stepCount = number;
+			} else if (argument == "--workers") {
+				workerCount = number;
+			} else {
+				seed = number;
+			}
+		} else {
+			std::cerr << "Unknown argument " << argument << std::endl;
+			return 1;
+		}
+	}
+
+	std::shared_ptr<NullRenderBackend> nullRenderBackend = std::make_shared<NullRenderBackend>();
+	nullRenderBackend->SetCursorPosition(Vector2<float>(windowWidth * 0.75f, windowHeight * 0.5f));
+	renderBackend = nullRenderBackend;
+	randomEngine.seed(seed);
+
+	InitSimulation(workerCount);
+	if (playerCharacters.back()->GetSprite()->GetWidth() <= 0.f) {
+		std::cerr << "Could not read the sprites, run from the repository root" << std::endl;
+		return 1;
+	}
+	gameStateHandler->AddState(std::make_shared<MenuState>());
+	deltaTime = fixedTimestep->GetStepSeconds();
+	mouseButtons[SDL_BUTTON_LEFT].state = true;
+	runningGame = true;
+
+	const char* gameModeNames[] = { "BossRush", "Formation", "Survival" };
+	std::cout << "Workers " << jobSystem->GetWorkerCount() << ", " << stepCount << " steps per mode, seed " << seed << std::endl;
+	for (unsigned int i = 0; i < gameModes.size(); i++) {
+		unsigned int deathCount = 0;
+		unsigned int peakEnemyCount = 0;
+		double slowestStepMilliseconds = 0.0;
+		gameStateHandler->BackToFirstState();
+		gameStateHandler->SetGameMode(gameModes[i]);
+
+		const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+		for (unsigned int step = 0; step < stepCount; step++) {
+			//The mode starts again on the first step and whenever the player has died, like pressing restart
+			if (step == 0 || playerCharacters.back()->GetCurrentHealth() <= 0) {
+				deathCount += step == 0 ? 0 : 1;
+				gameStateHandler->BackToFirstState();
+				switch (gameModes[i]) {
+				case GameMode::BossRush:
+					gameStateHandler->AddState(std::make_shared<BossRushGameState>());
+					break;
+				case GameMode::Formation:
+					gameStateHandler->AddState(std::make_shared<FormationGameState>());
+					break;
+				default:
+					gameStateHandler->AddState(std::make_shared<SurvivalGameState>());
+					break;
+				}
+			}
+			const std::chrono::steady_clock::time_point stepStart = std::chrono::steady_clock::now();
+			jobSystem->BeginFrame();
+			frameNumber++;
+			StorePreviousStates();
+			cursorPosition = universalFunctions->GetCursorPosition();
+			gameStateHandler->UpdateState();
+			slowestStepMilliseconds = std::max(slowestStepMilliseconds, std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - stepStart).count());
+			peakEnemyCount = std::max(peakEnemyCount, (unsigned int)enemyManager->GetActiveObjects().size());
+		}
+		const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+		std::cout << gameModeNames[(unsigned int)gameModes[i]] << ": " << stepCount / seconds << " steps per second, "
+			<< seconds * 1000.0 / stepCount << " ms per step, slowest " << slowestStepMilliseconds << " ms, peak enemies " << peakEnemyCount
+			<< ", projectiles " << projectileManager->GetActiveObjects().size() << ", wave " << enemyManager->GetWaveNumber()
+			<< ", deaths " << deathCount << std::endl;
+	}
+	jobSystem->ShutDown();
+	return 0;
+}
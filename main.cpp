@@ -11,18 +11,29 @@
 #include "ImGui/imgui_impl_sdl.h"
 
 #include "src/bossBoar.h"
+#include "src/boundingVolumeHierarchy.h"
+#include "src/broadPhase.h"
 #include "src/collision.h"
+#include "src/commandBuffer.h"
 #include "src/debugDrawer.h"
 #include "src/enemyBase.h"
 #include "src/enemyManager.h"
+#include "src/fixedTimestep.h"
+#include "src/flowField.h"
 #include "src/gameEngine.h"
 #include "src/imGuiManager.h"
+#include "src/jobSystem.h"
+#include "src/layeredSpatialIndex.h"
+#include "src/objectBase.h"
 #include "src/obstacleManager.h"
 #include "src/playerCharacter.h"
 #include "src/projectileManager.h"
 #include "src/quadTree.h"
 #include "src/searchSortAlgorithms.h"
 #include "src/rayCast.h"
+#include "src/sdlRenderBackend.h"
+#include "src/spatialHashGrid.h"
+#include "src/spatialIndex.h"
 #include "src/sprite.h"
 #include "src/stateStack.h"
 #include "src/steeringBehavior.h"
@@ -30,7 +41,7 @@
 #include "src/textSprite.h"
 #include "src/universalFunctions.h"
 #include "src/vector2.h"
-#include "src/WeaponManager.h"
+#include "src/weaponManager.h"
 
 int main(int argc, char* argv[]) {
 	HWND windowHandle = GetConsoleWindow();
@@ -41,43 +52,24 @@ int main(int argc, char* argv[]) {
 	IMG_Init(1);
 
 	window = SDL_CreateWindow(gameTitle, SDL_WINDOWPOS_CENTERED, SDL_WINDOWPOS_CENTERED, windowWidth, windowHeight, 0);
-	renderer = SDL_CreateRenderer(window, -1, SDL_RENDERER_ACCELERATED);
+	renderer = SDL_CreateRenderer(window, -1, SDL_RENDERER_ACCELERATED | SDL_RENDERER_PRESENTVSYNC);
 
-	collisionCheck = std::make_shared<CollisionCheck>();
-	enemyManager = std::make_shared<EnemyManager>();
-	gameStateHandler = std::make_shared<GameStateHandler>();
-	debugDrawer = std::make_shared<DebugDrawer>();
+	renderBackend = std::make_shared<SDLRenderBackend>(renderer);
 	imGuiHandler = std::make_shared<ImGuiHandler>();
-	obstacleManager = std::make_shared<ObstacleManager>();
-	projectileManager = std::make_shared<ProjectileManager>();
-	playerCharacters.emplace_back(std::make_shared<PlayerCharacter>(0.f, Vector2<float>(windowWidth * 0.5f, windowHeight * 0.5f)));
-	searchSort = std::make_shared<SearchSortAlgorithms>();
-	rayCast = std::make_shared<RayCast>();
-
-	timerHandler = std::make_shared<TimerHandler>();
-	universalFunctions = std::make_shared<UniversalFunctions>();
-	weaponManager = std::make_shared<WeaponManager>();
-
-	QuadTreeNode quadTreeNode;
-	quadTreeNode.rectangle = std::make_shared<AABB>();
-	quadTreeNode.rectangle->Init(Vector2(windowWidth * 0.5f, windowHeight * 0.5f), windowHeight, windowWidth);
-	objectBaseQuadTree = std::make_shared<QuadTree<std::shared_ptr<ObjectBase>>>(quadTreeNode, 100);
-	obstacleQuadTree = std::make_shared<QuadTree<std::shared_ptr<ObjectBase>>>(quadTreeNode, 25);
-	projectileQuadTree = std::make_shared<QuadTree<std::shared_ptr<ObjectBase>>>(quadTreeNode, 200);
 
 	//Init here
-	cursorPosition = universalFunctions->GetCursorPosition();
-	enemyManager->Init();
-	for (unsigned int i = 0; i < playerCharacters.size(); i++) {
-		playerCharacters[i]->Init();
-	}
+	InitSimulation(std::thread::hardware_concurrency());
 	imGuiHandler->Init();
-	projectileManager->Init();
-	obstacleManager->Init();
-	weaponManager->Init();
 
 	gameStateHandler->AddState(std::make_shared<MenuState>());
 
+	//Runs the simulation as fast as it can without rendering, for benchmarks and soak tests. F1 switches it on and off
+	for (int i = 1; i < argc; i++) {
+		if (std::string(argv[i]) == "--fast-forward") {
+			fixedTimestep->SetFastForward(true);
+		}
+	}
+
 	Uint64 previous_ticks = SDL_GetPerformanceCounter();
 	runningGame = true;
 
@@ -85,17 +77,16 @@ int main(int argc, char* argv[]) {
 	int scanCode = 0;
 	Uint64 ticks;
 	Uint64 delta_ticks;
+	deltaTime = fixedTimestep->GetStepSeconds();
 
 	while (runningGame) {
-		ImGui_ImplSDL2_NewFrame(window);
-		ImGui::NewFrame();
-
-		frameNumber++;
+		jobSystem->BeginFrame();
 		ticks = SDL_GetPerformanceCounter();
 		delta_ticks = ticks - previous_ticks;
 		previous_ticks = ticks;
-		deltaTime = (float)delta_ticks / (float)SDL_GetPerformanceFrequency();
+		fixedTimestep->AddFrameTime((float)delta_ticks / (float)SDL_GetPerformanceFrequency());
 
+		//Input counts for the next simulation step, a frame that runs no step keeps it for the one after
 		while (SDL_PollEvent(&eventType)) {
 			ImGui_ImplSDL2_ProcessEvent(&eventType);
 			switch (eventType.type) {
@@ -108,13 +99,17 @@ int main(int argc, char* argv[]) {
 					if (eventType.key.repeat) {
 						break;
 					}
-					keys[scanCode].changeFrame = frameNumber;
+					if (scanCode == SDL_SCANCODE_F1) {
+						fixedTimestep->SetFastForward(!fixedTimestep->GetIsFastForward());
+						SDL_SetWindowTitle(window, gameTitle);
+					}
+					keys[scanCode].changeFrame = frameNumber + 1;
 					keys[scanCode].state = true;
 					break;
 				}
 				case SDL_KEYUP: {
 					scanCode = eventType.key.keysym.scancode;
-					keys[scanCode].changeFrame = frameNumber;
+					keys[scanCode].changeFrame = frameNumber + 1;
 					keys[scanCode].state = false;
 					break;
 				}
@@ -122,23 +117,37 @@ int main(int argc, char* argv[]) {
 					if (eventType.key.repeat) {
 						break;
 					}
-					mouseButtons[eventType.button.button].changeFrame = frameNumber;
+					mouseButtons[eventType.button.button].changeFrame = frameNumber + 1;
 					mouseButtons[eventType.button.button].state = true;
 					break;
 				}
 				case SDL_MOUSEBUTTONUP: {
-					mouseButtons[eventType.button.button].changeFrame = frameNumber;
+					mouseButtons[eventType.button.button].changeFrame = frameNumber + 1;
 					mouseButtons[eventType.button.button].state = false;
 				}
 			}
 		}
 
-		//Update here
-		cursorPosition = universalFunctions->GetCursorPosition();
-		gameStateHandler->UpdateState();
+		//Update here, every step moves the game by the same deltaTime. In fast-forward the steps run back to back for a tenth of a second
+		const Uint64 fastForwardEnd = ticks + SDL_GetPerformanceFrequency() / 10;
+		while (fixedTimestep->ConsumeStep()) {
+			frameNumber++;
+			StorePreviousStates();
+			cursorPosition = universalFunctions->GetCursorPosition();
+			gameStateHandler->UpdateState();
+			if (fixedTimestep->GetIsFastForward() && (!runningGame || SDL_GetPerformanceCounter() >= fastForwardEnd)) {
+				break;
+			}
+		}
+		if (fixedTimestep->GetIsFastForward()) {
+			SDL_SetWindowTitle(window, (std::string(gameTitle) + " - fast-forward, " + std::to_string(fixedTimestep->GetStepsThisFrame() * 10) + " steps per second").c_str());
+			continue;
+		}
+
+		ImGui_ImplSDL2_NewFrame(window);
+		ImGui::NewFrame();
 
-		SDL_SetRenderDrawColor(renderer, 75, 75, 75, 255);
-		SDL_RenderClear(renderer);
+		renderBackend->Clear({ 75, 75, 75, 255 });
 
 		//Render images here
 		gameStateHandler->RenderState();
@@ -150,16 +159,49 @@ int main(int argc, char* argv[]) {
 		//Render text here
 		gameStateHandler->RenderStateText();
 
-		//objectBaseQuadTree->Render();
-		objectBaseQuadTree->Clear();
-		projectileQuadTree->Clear();
+		//spatialIndex->Render();
+
+		//Average number of colliders each spatial index query had to test this frame
+		imGuiHandler->ShowFloatValue("SpatialIndex", "Candidates per query", spatialIndex->GetCandidatesPerQuery());
+		spatialIndex->ResetStatistics();
+
+		imGuiHandler->ShowFloatValue("NeighbourLists", "Rebuilt per frame", enemyManager->GetNeighbourListRebuildRate());
+
+		//Enemies in every AI level of detail and how many of them steered this frame
+		const AILevelOfDetailStatistics& levelOfDetailStatistics = enemyManager->GetLevelOfDetailStatistics();
+		imGuiHandler->ShowFloat2Value("AILevelOfDetail", "Full", (float)levelOfDetailStatistics.population[(unsigned int)AILevelOfDetail::Full],
+			(float)levelOfDetailStatistics.steered[(unsigned int)AILevelOfDetail::Full]);
+		imGuiHandler->ShowFloat2Value("AILevelOfDetail", "Reduced", (float)levelOfDetailStatistics.population[(unsigned int)AILevelOfDetail::Reduced],
+			(float)levelOfDetailStatistics.steered[(unsigned int)AILevelOfDetail::Reduced]);
+		imGuiHandler->ShowFloat2Value("AILevelOfDetail", "Dormant", (float)levelOfDetailStatistics.population[(unsigned int)AILevelOfDetail::Dormant],
+			(float)levelOfDetailStatistics.steered[(unsigned int)AILevelOfDetail::Dormant]);
+		imGuiHandler->ShowFloatValue("AILevelOfDetail", "Steering ms", levelOfDetailStatistics.steeringMilliseconds);
+		imGuiHandler->SliderFloat("AILevelOfDetail", "Full distance", enemyManager->GetLevelOfDetailSettings().fullDistance, 0.f, 1500.f);
+		imGuiHandler->SliderFloat("AILevelOfDetail", "Screen margin", enemyManager->GetLevelOfDetailSettings().screenMargin, 0.f, 500.f);
+
+		//flowField->Render();
+		imGuiHandler->ShowFloatValue("FlowField", "Rebuilds", (float)flowField->GetRebuildCount());
+		imGuiHandler->ShowFloatValue("FlowField", "Last rebuild ms", flowField->GetRebuildMilliseconds());
+
+		//Share of the last frame every worker spent running jobs, worker 0 is the main thread
+		for (unsigned int i = 0; i < jobSystem->GetWorkerUtilisation().size(); i++) {
+			imGuiHandler->ShowFloatValue("JobSystem", ("Worker " + std::to_string(i)).c_str(), jobSystem->GetWorkerUtilisation()[i]);
+		}
+		imGuiHandler->ShowFloatValue("CommandBuffer", "Commands last tick", (float)commandBuffer->GetFlushedCommandCount());
+
+		//Steps run this frame, how far the objects are drawn past the last one and the time the clamp has dropped
+		imGuiHandler->ShowFloatValue("FixedTimestep", "Steps this frame", (float)fixedTimestep->GetStepsThisFrame());
+		imGuiHandler->ShowFloatValue("FixedTimestep", "Interpolation", fixedTimestep->GetInterpolation());
+		imGuiHandler->ShowFloatValue("FixedTimestep", "Dropped seconds", fixedTimestep->GetDroppedSeconds());
 		
 		imGuiHandler->Render();
 
-		SDL_RenderPresent(renderer);
-		SDL_Delay(16);
+		//The display's refresh paces the rendering, the simulation keeps its own rate through the fixed timestep
+		renderBackend->Present();
 	}
+	jobSystem->ShutDown();
 	imGuiHandler->ShutDown();
+	renderBackend = nullptr;
 	SDL_DestroyWindow(window);
 	SDL_Quit();
 	std::exit(0);
@@ -1,4 +1,5 @@
 #include "bossBoar.h"
+#include "commandBuffer.h"
 #include "debugDrawer.h"
 #include "decisionTree.h"
 #include "playerCharacter.h"
@@ -32,12 +33,13 @@ BoarBoss::BoarBoss() : EnemyBase(EnemyType::Boss) {
 
 	_behaviorData.separationThreshold = _behaviorData.characterRadius * 1.5f;
 	_behaviorData.decayCoefficient = 10000.f;
+	_behaviorData.maxSeparationNeighbours = 6;
 
 	_prioritySteering = std::make_shared<PrioritySteering>();
 	_blendSteering = std::make_shared<BlendSteering>();
 
-	_blendSteering->AddSteeringBehavior(BehaviorAndWeight(std::make_shared<ArriveBehavior>(), 1.f));
-	_blendSteering->AddSteeringBehavior(BehaviorAndWeight(std::make_shared<FaceBehavior>(), 1.f));
+	_blendSteering->AddSteeringBehavior(GetSteeringBehavior(SteeringBehaviorType::Arrive));
+	_blendSteering->AddSteeringBehavior(GetSteeringBehavior(SteeringBehaviorType::Face));
 	_prioritySteering->AddGroup(*_blendSteering);
 
 	_healthTextSprite = std::make_shared<TextSprite>();
@@ -53,9 +55,11 @@ void BoarBoss::Init() {
 
 	_position = Vector2<float>(windowWidth * 0.9f, windowHeight * 0.3f);
 	_direction = _targetPosition - _position;
+	ResetPreviousState();
 
 	_healthTextSprite->Init(fontType, 24, std::to_string(_currentHealth).c_str(), { 255, 255, 255, 255 });
 	_healthTextSprite->SetPosition(Vector2<float>(windowWidth * 0.5f, windowHeight * 0.9f));
+	SetSteeringPipeline(SteeringPipelineType::BoarBoss);
 	
 	if (!_decisionTree) {
 		CreateDecisionTree();
@@ -63,11 +67,12 @@ void BoarBoss::Init() {
 	MakeDecision();
 }
 
-void BoarBoss::Update() {
+void BoarBoss::PrepareSteering() {
 	_oldPosition = _position;
 	_targetPosition = playerCharacters.back()->GetPosition();
-	_steeringOutput = _prioritySteering->Steering(_behaviorData, *this);
+}
 
+void BoarBoss::Update() {
 	if (_decisionTreeAction) {
 		if (_decisionTreeAction->ExecuteAction()) {
 			MakeDecision();
@@ -76,7 +81,7 @@ void BoarBoss::Update() {
 }
 
 void BoarBoss::Render() {
-	_sprite->RenderWithOrientation(0, _position, _orientation);
+	_sprite->RenderWithOrientation(0, GetRenderPosition(), GetRenderOrientation());
 }
 
 void BoarBoss::RenderText() {
@@ -86,7 +91,7 @@ void BoarBoss::RenderText() {
 void BoarBoss::TakeDamage(const int& damageAmount) {
 	_currentHealth -= damageAmount;
 	if (_currentHealth <= 0) {
-		enemyManager->RemoveObject(_objectID);
+		commandBuffer->AddDespawn(shared_from_this());
 	}
 	_healthTextSprite->ChangeText(std::to_string(_currentHealth).c_str(), { 255, 255, 255, 255 });
 }
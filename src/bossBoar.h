@@ -16,6 +16,7 @@ public:
 	~BoarBoss();
 
 	void Init() override;
+	void PrepareSteering() override;
 	void Update() override;
 	void Render() override;
 	void RenderText() override;
@@ -0,0 +1,404 @@
+#pragma once
+#include "collision.h"
+#include "spatialIndex.h"
+#include "vector2.h"
+
+#include <algorithm>
+#include <array>
+#include <unordered_map>
+#include <vector>
+
+#include "debugDrawer.h"
+#include "gameEngine.h"
+
+/*Packed bounding volume hierarchy for objects that never move, such as obstacles.
+The tree is rebuilt from scratch whenever an object is inserted or removed and is read only in between.
+Nodes are stored depth first in one array, the left child always follows its parent so only the right child index is stored*/
+template<typename T>
+class BoundingVolumeHierarchy : public SpatialIndex<T> {
+public:
+	BoundingVolumeHierarchy(const unsigned int& leafSize);
+	~BoundingVolumeHierarchy();
+
+	bool Insert(T object, std::shared_ptr<Collider> collider, const unsigned int& layer) override;
+	bool Remove(const T& object) override;
+	bool Update(const T& object, const std::shared_ptr<Collider>& collider, const unsigned int& layer) override;
+
+	void Query(const std::shared_ptr<Collider>& range, std::vector<T>& objectsFound, const unsigned int& layerMask) override;
+	void QueryNearest(const Vector2<float>& point, const unsigned int& k, const float& maxDistance, std::vector<T>& objectsFound, const unsigned int& layerMask) override;
+	const RayHit<T> RayQuery(const Ray& ray, const unsigned int& layerMask) override;
+
+	template<typename Visitor>
+	void Visit(const Collider& range, const unsigned int& layerMask, Visitor&& visitor);
+
+	void Build();
+	void Rebuild() override;
+	void Clear() override;
+	void Render() override;
+
+	const SpatialIndexType GetSpatialIndexType() const override;
+	const unsigned int GetNumberOfObjects() const override;
+	const unsigned int GetNumberOfNodes() const;
+
+	const std::shared_ptr<Collider> FindCollider(const T& object) const override;
+
+private:
+	struct Entry {
+		T object;
+		std::shared_ptr<Collider> collider = nullptr;
+		unsigned int layer = 0;
+		Vector2<float> min = { 0.f, 0.f };
+		Vector2<float> max = { 0.f, 0.f };
+	};
+
+	//A node waiting in a best first traversal together with the lower bound of its distance
+	struct NodeDistance {
+		unsigned int nodeIndex = 0;
+		float distance = 0.f;
+	};
+
+	struct Node {
+		Vector2<float> min = { 0.f, 0.f };
+		Vector2<float> max = { 0.f, 0.f };
+		unsigned int firstEntry = 0;
+		unsigned int entryCount = 0;
+		unsigned int rightChild = 0;
+		//Every layer stored below the node, lets a masked query skip whole subtrees
+		unsigned int layerMask = 0;
+	};
+
+	unsigned int BuildNode(const unsigned int firstEntry, const unsigned int entryCount);
+
+	static bool BoundsOverlap(const Vector2<float>& minA, const Vector2<float>& maxA, const Vector2<float>& minB, const Vector2<float>& maxB);
+
+	//Deep enough for any tree the median split can produce from the obstacle amount limit
+	static const unsigned int _maxStackSize = 64;
+
+	unsigned int _leafSize = 4;
+
+	std::vector<Node> _nodes;
+	std::vector<Entry> _entries;
+	std::unordered_map<T, unsigned int> _entryIndices;
+
+	SDL_Color _boundingVolumeColor = { 0, 255, 125, 255 };
+
+};
+template<typename T>
+inline BoundingVolumeHierarchy<T>::BoundingVolumeHierarchy(const unsigned int& leafSize) {
+	_leafSize = std::max(1u, leafSize);
+}
+template<typename T>
+inline BoundingVolumeHierarchy<T>::~BoundingVolumeHierarchy() {
+	Clear();
+}
+template<typename T>
+inline bool BoundingVolumeHierarchy<T>::Insert(T object, std::shared_ptr<Collider> collider, const unsigned int& layer) {
+	if (_entryIndices.contains(object)) {
+		return Update(object, collider, layer);
+	}
+	Entry entry;
+	entry.object = object;
+	entry.collider = collider;
+	entry.layer = layer;
+	_entries.emplace_back(entry);
+	Build();
+	return true;
+}
+template<typename T>
+inline bool BoundingVolumeHierarchy<T>::Remove(const T& object) {
+	auto entry = _entryIndices.find(object);
+	if (entry == _entryIndices.end()) {
+		return false;
+	}
+	_entries[entry->second] = _entries.back();
+	_entries.pop_back();
+	Build();
+	return true;
+}
+//The objects are static, the tree is only rebuilt when the stored collider bounds actually changed
+template<typename T>
+inline bool BoundingVolumeHierarchy<T>::Update(const T& object, const std::shared_ptr<Collider>& collider, const unsigned int& layer) {
+	auto entry = _entryIndices.find(object);
+	if (entry == _entryIndices.end()) {
+		return Insert(object, collider, layer);
+	}
+	Entry& storedEntry = _entries[entry->second];
+	storedEntry.collider = collider;
+	if (storedEntry.layer != layer) {
+		storedEntry.layer = layer;
+		Build();
+		return true;
+	}
+	const Vector2<float> halfExtents = collider->GetHalfExtents();
+	const Vector2<float> min = collider->GetPosition() - halfExtents;
+	const Vector2<float> max = collider->GetPosition() + halfExtents;
+	if (storedEntry.min.x == min.x && storedEntry.min.y == min.y && storedEntry.max.x == max.x && storedEntry.max.y == max.y) {
+		return true;
+	}
+	Build();
+	return true;
+}
+//Appends the objects the collider hit to objectsFound, the caller owns the buffer so it can be reused every frame
+template<typename T>
+inline void BoundingVolumeHierarchy<T>::Query(const std::shared_ptr<Collider>& range, std::vector<T>& objectsFound, const unsigned int& layerMask) {
+	Visit(*range, layerMask, [&objectsFound](const T& object) {
+		objectsFound.emplace_back(object);
+	});
+}
+/*Best first search, the node with the nearest bounds is opened first and the search stops once no unopened node can hold anything nearer than the k found.
+An entry's centre always lies inside the bounds of its nodes, so the distance to the bounds never overestimates*/
+template<typename T>
+inline void BoundingVolumeHierarchy<T>::QueryNearest(const Vector2<float>& point, const unsigned int& k, const float& maxDistance, std::vector<T>& objectsFound, const unsigned int& layerMask) {
+	this->_queriesMade++;
+	if (_nodes.empty() || k == 0) {
+		return;
+	}
+	thread_local std::vector<NodeDistance> nodeQueue;
+	thread_local std::vector<typename SpatialIndex<T>::NearestCandidate> nearest;
+	unsigned int candidatesTested = 0;
+	auto isFarther = [](const NodeDistance& nodeA, const NodeDistance& nodeB) {
+		return nodeA.distance > nodeB.distance;
+	};
+	const float maxDistanceSquared = maxDistance * maxDistance;
+	nearest.clear();
+	nodeQueue.clear();
+	nodeQueue.emplace_back(NodeDistance{ 0, SpatialIndex<T>::DistanceSquaredToBounds(point, _nodes[0].min, _nodes[0].max) });
+	while (!nodeQueue.empty()) {
+		std::pop_heap(nodeQueue.begin(), nodeQueue.end(), isFarther);
+		const NodeDistance nodeDistance = nodeQueue.back();
+		nodeQueue.pop_back();
+		if (nodeDistance.distance > maxDistanceSquared || (nearest.size() == k && nodeDistance.distance >= nearest.front().distanceSquared)) {
+			break;
+		}
+		const Node& node = _nodes[nodeDistance.nodeIndex];
+		if ((node.layerMask & layerMask) == 0) {
+			continue;
+		}
+		if (node.entryCount == 0) {
+			for (const unsigned int childIndex : { nodeDistance.nodeIndex + 1, node.rightChild }) {
+				nodeQueue.emplace_back(NodeDistance{ childIndex, SpatialIndex<T>::DistanceSquaredToBounds(point, _nodes[childIndex].min, _nodes[childIndex].max) });
+				std::push_heap(nodeQueue.begin(), nodeQueue.end(), isFarther);
+			}
+			continue;
+		}
+		for (unsigned int i = node.firstEntry; i < node.firstEntry + node.entryCount; i++) {
+			if ((_entries[i].layer & layerMask) == 0) {
+				continue;
+			}
+			candidatesTested++;
+			const Vector2<float> delta = _entries[i].collider->GetPosition() - point;
+			const float distanceSquared = delta.x * delta.x + delta.y * delta.y;
+			if (distanceSquared <= maxDistanceSquared) {
+				SpatialIndex<T>::OfferNearest(nearest, k, distanceSquared, _entries[i].object);
+			}
+		}
+	}
+	this->_candidatesTested += candidatesTested;
+	SpatialIndex<T>::AppendNearest(nearest, objectsFound);
+}
+/*Walks the tree front to back, the nearer child is opened first and a node is skipped when the ray enters it behind the closest hit so far.
+The ray direction has to be normalized*/
+template<typename T>
+inline const RayHit<T> BoundingVolumeHierarchy<T>::RayQuery(const Ray& ray, const unsigned int& layerMask) {
+	this->_queriesMade++;
+	RayHit<T> rayHit;
+	float distance = 0.f;
+	if (_nodes.empty() || !SpatialIndex<T>::RayIntersectsBounds(ray, _nodes[0].min, _nodes[0].max, distance)) {
+		return rayHit;
+	}
+	std::array<NodeDistance, _maxStackSize> nodeStack;
+	unsigned int stackSize = 0;
+	nodeStack[stackSize++] = NodeDistance{ 0, distance };
+	Vector2<float> normal = { 0.f, 0.f };
+	while (stackSize > 0) {
+		const NodeDistance nodeDistance = nodeStack[--stackSize];
+		const Node& node = _nodes[nodeDistance.nodeIndex];
+		if ((node.layerMask & layerMask) == 0 || (rayHit.hit && nodeDistance.distance > rayHit.distance)) {
+			continue;
+		}
+		if (node.entryCount == 0) {
+			NodeDistance leftChild = { nodeDistance.nodeIndex + 1, 0.f };
+			NodeDistance rightChild = { node.rightChild, 0.f };
+			const bool leftHit = SpatialIndex<T>::RayIntersectsBounds(ray, _nodes[leftChild.nodeIndex].min, _nodes[leftChild.nodeIndex].max, leftChild.distance);
+			const bool rightHit = SpatialIndex<T>::RayIntersectsBounds(ray, _nodes[rightChild.nodeIndex].min, _nodes[rightChild.nodeIndex].max, rightChild.distance);
+			if (leftHit && rightHit && leftChild.distance < rightChild.distance) {
+				//The nearer child goes on the stack last so it is opened first
+				nodeStack[stackSize++] = rightChild;
+				nodeStack[stackSize++] = leftChild;
+			} else if (leftHit && rightHit) {
+				nodeStack[stackSize++] = leftChild;
+				nodeStack[stackSize++] = rightChild;
+			} else if (leftHit) {
+				nodeStack[stackSize++] = leftChild;
+			} else if (rightHit) {
+				nodeStack[stackSize++] = rightChild;
+			}
+			continue;
+		}
+		for (unsigned int i = node.firstEntry; i < node.firstEntry + node.entryCount; i++) {
+			if ((_entries[i].layer & layerMask) == 0) {
+				continue;
+			}
+			this->_candidatesTested++;
+			if (SpatialIndex<T>::RayCastCollider(ray, *_entries[i].collider, distance, normal) && (!rayHit.hit || distance < rayHit.distance)) {
+				rayHit.object = _entries[i].object;
+				rayHit.distance = distance;
+				rayHit.normal = normal;
+				rayHit.hit = true;
+			}
+		}
+	}
+	if (rayHit.hit) {
+		rayHit.position = ray.startPosition + ray.direction * rayHit.distance;
+	}
+	return rayHit;
+}
+template<typename T>
+template<typename Visitor>
+inline void BoundingVolumeHierarchy<T>::Visit(const Collider& range, const unsigned int& layerMask, Visitor&& visitor) {
+	this->_queriesMade++;
+	if (_nodes.empty()) {
+		return;
+	}
+	unsigned int candidatesTested = 0;
+	const Vector2<float> halfExtents = range.GetHalfExtents();
+	const Vector2<float> rangeMin = range.GetPosition() - halfExtents;
+	const Vector2<float> rangeMax = range.GetPosition() + halfExtents;
+
+	std::array<unsigned int, _maxStackSize> nodeStack;
+	unsigned int stackSize = 0;
+	nodeStack[stackSize++] = 0;
+	while (stackSize > 0) {
+		const unsigned int nodeIndex = nodeStack[--stackSize];
+		const Node& node = _nodes[nodeIndex];
+		if ((node.layerMask & layerMask) == 0 || !BoundsOverlap(node.min, node.max, rangeMin, rangeMax)) {
+			continue;
+		}
+		if (node.entryCount == 0) {
+			nodeStack[stackSize++] = node.rightChild;
+			nodeStack[stackSize++] = nodeIndex + 1;
+			continue;
+		}
+		for (unsigned int i = node.firstEntry; i < node.firstEntry + node.entryCount; i++) {
+			if ((_entries[i].layer & layerMask) == 0) {
+				continue;
+			}
+			candidatesTested++;
+			if (ColliderIntersect(range, *_entries[i].collider)) {
+				visitor(_entries[i].object);
+			}
+		}
+	}
+	this->_candidatesTested += candidatesTested;
+}
+//Packs the entries into a fresh tree, splitting every node at the median of its longest axis
+template<typename T>
+inline void BoundingVolumeHierarchy<T>::Build() {
+	_nodes.clear();
+	_entryIndices.clear();
+	if (_entries.empty()) {
+		return;
+	}
+	for (unsigned int i = 0; i < _entries.size(); i++) {
+		const Vector2<float> halfExtents = _entries[i].collider->GetHalfExtents();
+		_entries[i].min = _entries[i].collider->GetPosition() - halfExtents;
+		_entries[i].max = _entries[i].collider->GetPosition() + halfExtents;
+	}
+	_nodes.reserve(2 * (_entries.size() / _leafSize + 1));
+	BuildNode(0, _entries.size());
+
+	//The build reorders the entries, so their lookup is filled in afterwards
+	for (unsigned int i = 0; i < _entries.size(); i++) {
+		_entryIndices.insert(std::make_pair(_entries[i].object, i));
+	}
+}
+//Rebuilds the tree only if one of the stored colliders moved or changed size since the last build
+template<typename T>
+inline void BoundingVolumeHierarchy<T>::Rebuild() {
+	for (unsigned int i = 0; i < _entries.size(); i++) {
+		const Vector2<float> halfExtents = _entries[i].collider->GetHalfExtents();
+		const Vector2<float> min = _entries[i].collider->GetPosition() - halfExtents;
+		const Vector2<float> max = _entries[i].collider->GetPosition() + halfExtents;
+		if (_entries[i].min.x != min.x || _entries[i].min.y != min.y || _entries[i].max.x != max.x || _entries[i].max.y != max.y) {
+			Build();
+			return;
+		}
+	}
+}
+template<typename T>
+inline void BoundingVolumeHierarchy<T>::Clear() {
+	_nodes.clear();
+	_entries.clear();
+	_entryIndices.clear();
+}
+//Draws the bounds of every leaf
+template<typename T>
+inline void BoundingVolumeHierarchy<T>::Render() {
+	for (unsigned int i = 0; i < _nodes.size(); i++) {
+		if (_nodes[i].entryCount == 0) {
+			continue;
+		}
+		debugDrawer->AddDebugRectangle((_nodes[i].min + _nodes[i].max) * 0.5f, _nodes[i].min, _nodes[i].max, _boundingVolumeColor, false);
+	}
+}
+template<typename T>
+inline const SpatialIndexType BoundingVolumeHierarchy<T>::GetSpatialIndexType() const {
+	return SpatialIndexType::BoundingVolumeHierarchy;
+}
+template<typename T>
+inline const unsigned int BoundingVolumeHierarchy<T>::GetNumberOfObjects() const {
+	return _entries.size();
+}
+template<typename T>
+inline const unsigned int BoundingVolumeHierarchy<T>::GetNumberOfNodes() const {
+	return _nodes.size();
+}
+template<typename T>
+inline const std::shared_ptr<Collider> BoundingVolumeHierarchy<T>::FindCollider(const T& object) const {
+	auto entry = _entryIndices.find(object);
+	if (entry == _entryIndices.end()) {
+		return nullptr;
+	}
+	return _entries[entry->second].collider;
+}
+template<typename T>
+inline unsigned int BoundingVolumeHierarchy<T>::BuildNode(const unsigned int firstEntry, const unsigned int entryCount) {
+	const unsigned int nodeIndex = _nodes.size();
+	_nodes.emplace_back();
+
+	Vector2<float> min = _entries[firstEntry].min;
+	Vector2<float> max = _entries[firstEntry].max;
+	unsigned int layerMask = 0;
+	for (unsigned int i = firstEntry; i < firstEntry + entryCount; i++) {
+		min = { std::min(min.x, _entries[i].min.x), std::min(min.y, _entries[i].min.y) };
+		max = { std::max(max.x, _entries[i].max.x), std::max(max.y, _entries[i].max.y) };
+		layerMask |= _entries[i].layer;
+	}
+	_nodes[nodeIndex].min = min;
+	_nodes[nodeIndex].max = max;
+	_nodes[nodeIndex].layerMask = layerMask;
+
+	if (entryCount <= _leafSize) {
+		_nodes[nodeIndex].firstEntry = firstEntry;
+		_nodes[nodeIndex].entryCount = entryCount;
+		return nodeIndex;
+	}
+	//Splits the entries in two equal halves along the longest axis of the node, measured by the centre of each entry
+	const bool splitOnX = (max.x - min.x) >= (max.y - min.y);
+	const unsigned int halfCount = entryCount / 2;
+	std::nth_element(_entries.begin() + firstEntry, _entries.begin() + firstEntry + halfCount, _entries.begin() + firstEntry + entryCount,
+		[splitOnX](const Entry& entryA, const Entry& entryB) {
+			if (splitOnX) {
+				return entryA.min.x + entryA.max.x < entryB.min.x + entryB.max.x;
+			}
+			return entryA.min.y + entryA.max.y < entryB.min.y + entryB.max.y;
+		});
+	BuildNode(firstEntry, halfCount);
+	const unsigned int rightChild = BuildNode(firstEntry + halfCount, entryCount - halfCount);
+	_nodes[nodeIndex].rightChild = rightChild;
+	return nodeIndex;
+}
+template<typename T>
+inline bool BoundingVolumeHierarchy<T>::BoundsOverlap(const Vector2<float>& minA, const Vector2<float>& maxA, const Vector2<float>& minB, const Vector2<float>& maxB) {
+	return minA.x <= maxB.x && maxA.x >= minB.x && minA.y <= maxB.y && maxA.y >= minB.y;
+}
@@ -0,0 +1,130 @@
+#include "broadPhase.h"
+
+#include "collision.h"
+#include "enemyManager.h"
+#include "gameEngine.h"
+#include "obstacleManager.h"
+#include "playerCharacter.h"
+#include "projectileManager.h"
+#include "weaponManager.h"
+
+#include <algorithm>
+
+void BroadPhase::Update() {
+	_bodies.clear();
+	AddBodies(enemyManager->GetActiveObjects());
+	AddBodies(obstacleManager->GetActiveObjects());
+	AddBodies(projectileManager->GetActiveObjects());
+	AddBodies(weaponManager->GetActiveObjects());
+	for (unsigned int i = 0; i < playerCharacters.size(); i++) {
+		AddBody(playerCharacters[i]);
+	}
+	std::sort(_bodies.begin(), _bodies.end(), [](const Body& bodyA, const Body& bodyB) {
+		return bodyA.min.x < bodyB.min.x;
+	});
+
+	FillShapes();
+
+	//Each body is swept against the shapes that come after it, so every pair is found once
+	_nextCircle = 0;
+	_nextBox = 0;
+	for (unsigned int i = 0; i < _bodies.size(); i++) {
+		switch (_bodies[i].colliderType) {
+		case ColliderType::AABB:
+			_nextBox++;
+			SweepBody(i, ToBoxShape(static_cast<const AABB&>(*_bodies[i].collider)));
+			break;
+		case ColliderType::Circle:
+			_nextCircle++;
+			SweepBody(i, ToCircleShape(static_cast<const Circle&>(*_bodies[i].collider)));
+			break;
+		default:
+			break;
+		}
+	}
+}
+
+void BroadPhase::AddBodies(const std::unordered_map<unsigned int, std::shared_ptr<ObjectBase>>& objects) {
+	for (auto& object : objects) {
+		AddBody(object.second);
+	}
+}
+
+//Objects with an inactive collider are left out, the same way they are left out of the spatial indexes
+void BroadPhase::AddBody(const std::shared_ptr<ObjectBase>& object) {
+	object->ClearQueriedObjects();
+	if (!object->GetCollider()->GetIsActive()) {
+		return;
+	}
+	Body body;
+	body.object = object;
+	body.collider = object->GetCollider().get();
+	body.colliderType = body.collider->GetColliderType();
+	body.collisionLayer = object->GetCollisionLayer();
+	body.collisionMask = object->GetCollisionMask();
+	const Vector2<float> halfExtents = body.collider->GetHalfExtents();
+	body.min = body.collider->GetPosition() - halfExtents;
+	body.max = body.collider->GetPosition() + halfExtents;
+	_bodies.emplace_back(body);
+}
+
+//Copies the bodies into the shape arrays in sweep order
+void BroadPhase::FillShapes() {
+	_circles.Clear();
+	_boxes.Clear();
+	_circleLeftEdges.clear();
+	_boxLeftEdges.clear();
+	_circleBodies.clear();
+	_boxBodies.clear();
+	for (unsigned int i = 0; i < _bodies.size(); i++) {
+		switch (_bodies[i].colliderType) {
+		case ColliderType::AABB:
+			_boxes.Add(ToBoxShape(static_cast<const AABB&>(*_bodies[i].collider)));
+			_boxLeftEdges.emplace_back(_bodies[i].min.x);
+			_boxBodies.emplace_back(i);
+			break;
+		case ColliderType::Circle:
+			_circles.Add(ToCircleShape(static_cast<const Circle&>(*_bodies[i].collider)));
+			_circleLeftEdges.emplace_back(_bodies[i].min.x);
+			_circleBodies.emplace_back(i);
+			break;
+		default:
+			break;
+		}
+	}
+}
+
+template<typename Shape>
+void BroadPhase::SweepBody(const unsigned int& bodyIndex, const Shape& shape) {
+	SweepShapes(bodyIndex, shape, _circles, _circleLeftEdges, _circleBodies, _nextCircle);
+	SweepShapes(bodyIndex, shape, _boxes, _boxLeftEdges, _boxBodies, _nextBox);
+}
+
+//A body can only overlap the shapes that start before its right edge, the run ends at the first one that starts after it
+template<typename Shape, typename Colliders>
+void BroadPhase::SweepShapes(const unsigned int& bodyIndex, const Shape& shape, const Colliders& colliders,
+	const std::vector<float>& leftEdges, const std::vector<unsigned int>& shapeBodies, const unsigned int& firstShape) {
+	const unsigned int lastShape = std::upper_bound(leftEdges.begin() + firstShape, leftEdges.end(), _bodies[bodyIndex].max.x) - leftEdges.begin();
+	_hits.clear();
+	IntersectBatch(shape, colliders, firstShape, lastShape, _hits);
+	for (unsigned int i = 0; i < _hits.size(); i++) {
+		const unsigned int otherBody = shapeBodies[_hits[i]];
+		if (CanCollide(_bodies[bodyIndex], _bodies[otherBody])) {
+			AddPair(bodyIndex, otherBody);
+		}
+	}
+}
+
+void BroadPhase::AddPair(const unsigned int& bodyA, const unsigned int& bodyB) {
+	if ((_bodies[bodyA].collisionMask & _bodies[bodyB].collisionLayer) != 0) {
+		_bodies[bodyA].object->AddQueriedObject(_bodies[bodyB].object);
+	}
+	if ((_bodies[bodyB].collisionMask & _bodies[bodyA].collisionLayer) != 0) {
+		_bodies[bodyB].object->AddQueriedObject(_bodies[bodyA].object);
+	}
+}
+
+//A pair is only kept if at least one of the objects has the layer of the other in its collision mask
+bool BroadPhase::CanCollide(const Body& bodyA, const Body& bodyB) const {
+	return (bodyA.collisionMask & bodyB.collisionLayer) != 0 || (bodyB.collisionMask & bodyA.collisionLayer) != 0;
+}
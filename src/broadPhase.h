@@ -0,0 +1,65 @@
+#pragma once
+#include "collisionKernels.h"
+#include "objectBase.h"
+#include "vector2.h"
+
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+class Collider;
+
+/*Finds every pair of overlapping colliders once per tick, after all objects have moved.
+The bodies are sorted on the left edge of their bounds and swept along x, so only bodies that overlap on x are tested further.
+The circles and boxes are copied into their own arrays in that order, and each body is tested against the run of them it overlaps on x
+with the batch kernel for its pair of shapes.
+Each pair is found once and added to the queried objects of the objects whose collision mask has the layer of the other,
+which the steering, attacks and projectiles read from*/
+class BroadPhase {
+public:
+	BroadPhase() {}
+	~BroadPhase() {}
+
+	void Update();
+
+private:
+	struct Body {
+		std::shared_ptr<ObjectBase> object = nullptr;
+		Collider* collider = nullptr;
+		ColliderType colliderType = ColliderType::Count;
+		unsigned int collisionLayer = 0;
+		unsigned int collisionMask = 0;
+		Vector2<float> min = { 0.f, 0.f };
+		Vector2<float> max = { 0.f, 0.f };
+	};
+
+	void AddBodies(const std::unordered_map<unsigned int, std::shared_ptr<ObjectBase>>& objects);
+	void AddBody(const std::shared_ptr<ObjectBase>& object);
+
+	void FillShapes();
+
+	template<typename Shape>
+	void SweepBody(const unsigned int& bodyIndex, const Shape& shape);
+	template<typename Shape, typename Colliders>
+	void SweepShapes(const unsigned int& bodyIndex, const Shape& shape, const Colliders& colliders,
+		const std::vector<float>& leftEdges, const std::vector<unsigned int>& shapeBodies, const unsigned int& firstShape);
+
+	void AddPair(const unsigned int& bodyA, const unsigned int& bodyB);
+	bool CanCollide(const Body& bodyA, const Body& bodyB) const;
+
+	std::vector<Body> _bodies;
+
+	//The bodies of each shape in sweep order, with the left edge of their bounds and the body they belong to
+	CircleColliders _circles;
+	BoxColliders _boxes;
+	std::vector<float> _circleLeftEdges;
+	std::vector<float> _boxLeftEdges;
+	std::vector<unsigned int> _circleBodies;
+	std::vector<unsigned int> _boxBodies;
+	//The shapes of either kind that come after the body being swept
+	unsigned int _nextCircle = 0;
+	unsigned int _nextBox = 0;
+
+	std::vector<unsigned int> _hits;
+
+};
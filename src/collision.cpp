@@ -4,8 +4,9 @@
 #include "gameEngine.h"
 #include "objectBase.h"
 
-#include <minmax.h>
+#include <cmath>
 #include <SDL2/SDL.h>
+#include <utility>
 
 Collider::Collider() {}
 
@@ -21,6 +22,10 @@ const Vector2<float> Collider::GetPosition() const {
 	return _position;
 }
 
+const Vector2<float> Collider::GetHalfExtents() const {
+	return { 0.f, 0.f };
+}
+
 void Collider::SetPosition(const Vector2<float>& position) {
 	_position = position;
 }
@@ -51,6 +56,10 @@ const float AABB::GetWidth() const {
 	return _width;
 }
 
+const Vector2<float> AABB::GetHalfExtents() const {
+	return { _width * 0.5f, _height * 0.5f };
+}
+
 const Vector2<float> AABB::GetMax() const {
 	return _max;
 }
@@ -86,30 +95,232 @@ const float Circle::GetRadius() const {
 	return _radius;
 }
 
-bool CollisionCheck::AABBIntersect(const AABB& boxA, const AABB& boxB) {
-	return (
-		boxA.GetMax().x > boxB.GetMin().x &&
-		boxB.GetMax().x > boxA.GetMin().x &&
-		boxA.GetMax().y > boxB.GetMin().y &&
-		boxB.GetMax().y > boxA.GetMin().y);
+const Vector2<float> Circle::GetHalfExtents() const {
+	return { _radius, _radius };
 }
 
-bool CollisionCheck::AABBCircleIntersect(const AABB& box, const Circle& circle) {
-	_clamped = { universalFunctions->Clamp(circle.GetPosition().x, box.GetMin().x, box.GetMax().x),
-		universalFunctions->Clamp(circle.GetPosition().y, box.GetMin().y, box.GetMax().y) };
+const CircleShape ToCircleShape(const Circle& circle) {
+	return { circle.GetPosition().x, circle.GetPosition().y, circle.GetRadius() };
+}
 
-	_delta = circle.GetPosition() - _clamped;
-	return (_delta.absolute() < circle.GetRadius());
+const BoxShape ToBoxShape(const AABB& box) {
+	return { box.GetMin().x, box.GetMin().y, box.GetMax().x, box.GetMax().y };
 }
 
-bool CollisionCheck::CircleIntersect(const Circle& circleA, const Circle& circleB) {
-	_delta = circleB.GetPosition() - circleA.GetPosition();
-	return _delta.absolute() < (circleA.GetRadius() + circleB.GetRadius());
+/*Slab test, the ray is clipped against the x and y slabs of the box and gives the distance and normal of the side it enters through.
+A ray starting inside the box hits the side it leaves through instead, with the normal turned back toward the start.
+The direction of the ray has to be normalized for the distance to be measured in units*/
+bool RayIntersect(const Ray& ray, const BoxShape& box, float& distance, Vector2<float>& normal) {
+	float tMin = 0.f;
+	float tMax = ray.length;
+	int entryAxis = -1;
+	int exitAxis = -1;
+	const float starts[2] = { ray.startPosition.x, ray.startPosition.y };
+	const float directions[2] = { ray.direction.x, ray.direction.y };
+	const float mins[2] = { box.minX, box.minY };
+	const float maxs[2] = { box.maxX, box.maxY };
+	for (int axis = 0; axis < 2; axis++) {
+		if (std::abs(directions[axis]) < rayParallelThreshold) {
+			//The ray runs parallel to the slab and has to start inside it
+			if (starts[axis] < mins[axis] || starts[axis] > maxs[axis]) {
+				return false;
+			}
+			continue;
+		}
+		const float inverseDirection = 1.f / directions[axis];
+		float tNear = (mins[axis] - starts[axis]) * inverseDirection;
+		float tFar = (maxs[axis] - starts[axis]) * inverseDirection;
+		if (tNear > tFar) {
+			std::swap(tNear, tFar);
+		}
+		if (tNear > tMin) {
+			tMin = tNear;
+			entryAxis = axis;
+		}
+		if (tFar < tMax) {
+			tMax = tFar;
+			exitAxis = axis;
+		}
+		if (tMin > tMax) {
+			return false;
+		}
+	}
+	const int hitAxis = entryAxis >= 0 ? entryAxis : exitAxis;
+	if (hitAxis < 0) {
+		//The whole segment is inside the box
+		return false;
+	}
+	distance = entryAxis >= 0 ? tMin : tMax;
+	//Both the entry and the exit side face back along the ray
+	const float side = directions[hitAxis] > 0.f ? -1.f : 1.f;
+	normal = hitAxis == 0 ? Vector2<float>(side, 0.f) : Vector2<float>(0.f, side);
+	return true;
 }
 
-bool CollisionCheck::RayAABBIntersect(const Ray& line, const AABB& box) {
+//Solves where the distance between the centres becomes the sum of the radii, the circles have to be moving toward each other to hit
+bool SweepIntersect(const CircleShape& circle, const Vector2<float>& displacement, const CircleShape& target, float& timeOfImpact) {
+	const float offsetX = circle.x - target.x;
+	const float offsetY = circle.y - target.y;
+	const float radius = circle.radius + target.radius;
+	const float startDistance = offsetX * offsetX + offsetY * offsetY - radius * radius;
+	if (startDistance < 0.f) {
+		timeOfImpact = 0.f;
+		return true;
+	}
+	const float movement = displacement.x * displacement.x + displacement.y * displacement.y;
+	const float approach = offsetX * displacement.x + offsetY * displacement.y;
+	if (movement <= 0.f || approach >= 0.f) {
+		return false;
+	}
+	const float discriminant = approach * approach - movement * startDistance;
+	if (discriminant < 0.f) {
+		return false;
+	}
+	const float time = (-approach - std::sqrt(discriminant)) / movement;
+	if (time > 1.f) {
+		return false;
+	}
+	timeOfImpact = time;
+	return true;
+}
+
+/*The centre of the circle hits the box grown by the radius with rounded corners, which is two boxes grown along one axis each and a circle on every corner.
+The first of them the centre enters is where the circle touches the box*/
+bool SweepIntersect(const CircleShape& circle, const Vector2<float>& displacement, const BoxShape& target, float& timeOfImpact) {
+	if (Intersect(target, circle)) {
+		timeOfImpact = 0.f;
+		return true;
+	}
+	const BoxShape grownBoxes[2] = {
+		{ target.minX - circle.radius, target.minY, target.maxX + circle.radius, target.maxY },
+		{ target.minX, target.minY - circle.radius, target.maxX, target.maxY + circle.radius }
+	};
+	const float starts[2] = { circle.x, circle.y };
+	const float displacements[2] = { displacement.x, displacement.y };
+	bool hit = false;
+	for (unsigned int i = 0; i < 2; i++) {
+		const float mins[2] = { grownBoxes[i].minX, grownBoxes[i].minY };
+		const float maxs[2] = { grownBoxes[i].maxX, grownBoxes[i].maxY };
+		float tMin = 0.f;
+		float tMax = 1.f;
+		for (unsigned int axis = 0; axis < 2 && tMin <= tMax; axis++) {
+			if (std::abs(displacements[axis]) < rayParallelThreshold) {
+				if (starts[axis] < mins[axis] || starts[axis] > maxs[axis]) {
+					tMin = 1.f;
+					tMax = 0.f;
+				}
+				continue;
+			}
+			float tNear = (mins[axis] - starts[axis]) / displacements[axis];
+			float tFar = (maxs[axis] - starts[axis]) / displacements[axis];
+			if (tNear > tFar) {
+				std::swap(tNear, tFar);
+			}
+			tMin = tNear > tMin ? tNear : tMin;
+			tMax = tFar < tMax ? tFar : tMax;
+		}
+		if (tMin <= tMax && (!hit || tMin < timeOfImpact)) {
+			timeOfImpact = tMin;
+			hit = true;
+		}
+	}
+	const float cornersX[2] = { target.minX, target.maxX };
+	const float cornersY[2] = { target.minY, target.maxY };
+	float cornerTime = 0.f;
+	for (unsigned int i = 0; i < 4; i++) {
+		const CircleShape corner = { cornersX[i & 1], cornersY[i >> 1], circle.radius };
+		if (SweepIntersect(CircleShape{ circle.x, circle.y, 0.f }, displacement, corner, cornerTime) && (!hit || cornerTime < timeOfImpact)) {
+			timeOfImpact = cornerTime;
+			hit = true;
+		}
+	}
+	return hit;
+}
+
+bool AABBIntersect(const AABB& boxA, const AABB& boxB) {
+	return Intersect(ToBoxShape(boxA), ToBoxShape(boxB));
+}
+
+bool AABBCircleIntersect(const AABB& box, const Circle& circle) {
+	return Intersect(ToBoxShape(box), ToCircleShape(circle));
+}
+
+bool CircleIntersect(const Circle& circleA, const Circle& circleB) {
+	return Intersect(ToCircleShape(circleA), ToCircleShape(circleB));
+}
+
+bool RayAABBIntersect(const Ray& line, const AABB& box) {
+	float distance = 0.f;
+	Vector2<float> normal = { 0.f, 0.f };
+	return RayIntersect(line, ToBoxShape(box), distance, normal);
+}
 
+bool RayAABBIntersect(const Ray& line, const AABB& box, float& distance, Vector2<float>& normal) {
+	return RayIntersect(line, ToBoxShape(box), distance, normal);
+}
 
+//Compares the collider types so AABB and circle colliders can be tested against each other without the caller knowing the type
+bool ColliderIntersect(const Collider& colliderA, const Collider& colliderB) {
+	switch (colliderA.GetColliderType()) {
+	case ColliderType::AABB:
+		switch (colliderB.GetColliderType()) {
+		case ColliderType::AABB:
+			return AABBIntersect(static_cast<const AABB&>(colliderA), static_cast<const AABB&>(colliderB));
+		case ColliderType::Circle:
+			return AABBCircleIntersect(static_cast<const AABB&>(colliderA), static_cast<const Circle&>(colliderB));
+		default:
+			break;
+		}
+		break;
+	case ColliderType::Circle:
+		switch (colliderB.GetColliderType()) {
+		case ColliderType::AABB:
+			return AABBCircleIntersect(static_cast<const AABB&>(colliderB), static_cast<const Circle&>(colliderA));
+		case ColliderType::Circle:
+			return CircleIntersect(static_cast<const Circle&>(colliderA), static_cast<const Circle&>(colliderB));
+		default:
+			break;
+		}
+		break;
+	default:
+		break;
+	}
+	return false;
+}
 
+//Same as ColliderIntersect for a circle that moves, the target is treated as standing still
+bool SweptCircleIntersect(const Circle& circle, const Vector2<float>& displacement, const Collider& target, float& timeOfImpact) {
+	switch (target.GetColliderType()) {
+	case ColliderType::AABB:
+		return SweepIntersect(ToCircleShape(circle), displacement, ToBoxShape(static_cast<const AABB&>(target)), timeOfImpact);
+	case ColliderType::Circle:
+		return SweepIntersect(ToCircleShape(circle), displacement, ToCircleShape(static_cast<const Circle&>(target)), timeOfImpact);
+	default:
+		break;
+	}
 	return false;
 }
+
+bool CollisionCheck::AABBIntersect(const AABB& boxA, const AABB& boxB) {
+	return ::AABBIntersect(boxA, boxB);
+}
+
+bool CollisionCheck::AABBCircleIntersect(const AABB& box, const Circle& circle) {
+	return ::AABBCircleIntersect(box, circle);
+}
+
+bool CollisionCheck::CircleIntersect(const Circle& circleA, const Circle& circleB) {
+	return ::CircleIntersect(circleA, circleB);
+}
+
+bool CollisionCheck::RayAABBIntersect(const Ray& line, const AABB& box) {
+	return ::RayAABBIntersect(line, box);
+}
+
+bool CollisionCheck::RayAABBIntersect(const Ray& line, const AABB& box, float& distance, Vector2<float>& normal) {
+	return ::RayAABBIntersect(line, box, distance, normal);
+}
+
+bool CollisionCheck::ColliderIntersect(const Collider& colliderA, const Collider& colliderB) {
+	return ::ColliderIntersect(colliderA, colliderB);
+}
\ No newline at end of file
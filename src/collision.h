@@ -18,6 +18,7 @@ public:
 	const bool GetIsActive() const;
 	const ColliderType GetColliderType() const;
 	const Vector2<float> GetPosition() const;
+	virtual const Vector2<float> GetHalfExtents() const;
 
 	virtual void SetPosition(const Vector2<float>& position);
 	virtual void SetIsActive(const bool& isActive);
@@ -39,6 +40,7 @@ public:
 
 	const float GetHeight() const;
 	const float GetWidth() const;
+	const Vector2<float> GetHalfExtents() const override;
 	const Vector2<float> GetMax() const;
 	const Vector2<float> GetMin() const;
 
@@ -61,6 +63,7 @@ public:
 	void Init(const Vector2<float>& position, const float& radius);
 
 	const float GetRadius() const;
+	const Vector2<float> GetHalfExtents() const override;
 
 private:
 	float _radius = 0.f;
@@ -72,6 +75,9 @@ struct Ray {
 	float length = 0.f;
 };
 
+//A ray whose direction along an axis is smaller than this runs parallel to that axis
+constexpr float rayParallelThreshold = 0.000001f;
+
 struct Collision {
 	Vector2<float> position = { 0.f, 0.f };
 	Vector2<float> normal = { 0.f, 0.f };
@@ -79,6 +85,63 @@ struct Collision {
 	bool collisionDetected = false;
 };
 
+//Plain copies of a collider's shape, the stateless tests below and the batch kernels work on these
+struct CircleShape {
+	float x = 0.f;
+	float y = 0.f;
+	float radius = 0.f;
+};
+
+struct BoxShape {
+	float minX = 0.f;
+	float minY = 0.f;
+	float maxX = 0.f;
+	float maxY = 0.f;
+};
+
+const CircleShape ToCircleShape(const Circle& circle);
+const BoxShape ToBoxShape(const AABB& box);
+
+/*Stateless intersection tests, they only read their arguments so any number of threads can run them at once.
+The distances are compared squared, no square root is needed*/
+constexpr bool Intersect(const BoxShape& boxA, const BoxShape& boxB) {
+	return boxA.maxX > boxB.minX && boxB.maxX > boxA.minX && boxA.maxY > boxB.minY && boxB.maxY > boxA.minY;
+}
+
+//The circle centre is clamped into the box, the circle hits the box if the clamped point lies inside the circle
+constexpr bool Intersect(const BoxShape& box, const CircleShape& circle) {
+	const float deltaX = circle.x - (circle.x < box.minX ? box.minX : (circle.x > box.maxX ? box.maxX : circle.x));
+	const float deltaY = circle.y - (circle.y < box.minY ? box.minY : (circle.y > box.maxY ? box.maxY : circle.y));
+	return deltaX * deltaX + deltaY * deltaY < circle.radius * circle.radius;
+}
+
+constexpr bool Intersect(const CircleShape& circle, const BoxShape& box) {
+	return Intersect(box, circle);
+}
+
+constexpr bool Intersect(const CircleShape& circleA, const CircleShape& circleB) {
+	const float deltaX = circleB.x - circleA.x;
+	const float deltaY = circleB.y - circleA.y;
+	const float radius = circleA.radius + circleB.radius;
+	return deltaX * deltaX + deltaY * deltaY < radius * radius;
+}
+
+bool RayIntersect(const Ray& ray, const BoxShape& box, float& distance, Vector2<float>& normal);
+
+/*Time of impact of a circle moved by displacement against a circle or box that stands still, as the fraction of the movement done when they first touch.
+A circle that already overlaps the target hits it at 0*/
+bool SweepIntersect(const CircleShape& circle, const Vector2<float>& displacement, const CircleShape& target, float& timeOfImpact);
+bool SweepIntersect(const CircleShape& circle, const Vector2<float>& displacement, const BoxShape& target, float& timeOfImpact);
+
+bool AABBIntersect(const AABB& boxA, const AABB& boxB);
+bool AABBCircleIntersect(const AABB& box, const Circle& circle);
+bool CircleIntersect(const Circle& circleA, const Circle& circleB);
+bool RayAABBIntersect(const Ray& line, const AABB& box);
+bool RayAABBIntersect(const Ray& line, const AABB& box, float& distance, Vector2<float>& normal);
+bool ColliderIntersect(const Collider& colliderA, const Collider& colliderB);
+bool SweptCircleIntersect(const Circle& circle, const Vector2<float>& displacement, const Collider& target, float& timeOfImpact);
+
+//Kept for the callers that go through the global collisionCheck, every test forwards to the stateless function of the same name
 class CollisionCheck {
 public:
 	bool AABBIntersect(const AABB& boxA, const AABB& boxB);
@@ -88,10 +151,7 @@ public:
 	bool CircleIntersect(const Circle& circleA, const Circle& circleB);
 
 	bool RayAABBIntersect(const Ray& line, const AABB& box);
+	bool RayAABBIntersect(const Ray& line, const AABB& box, float& distance, Vector2<float>& normal);
 
-private:
-	Vector2<float> _clamped = { 0.f, 0.f };
-	Vector2<float> _delta = { 0.f, 0.f };
-	float distance = 0.f;
-
+	bool ColliderIntersect(const Collider& colliderA, const Collider& colliderB);
 };
\ No newline at end of file
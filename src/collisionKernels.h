@@ -0,0 +1,383 @@
+#pragma once
+#include "collision.h"
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <vector>
+
+//The widest instruction set the build targets is picked at compile time, without one the kernels only run the scalar loop
+#if defined(__AVX__)
+#include <immintrin.h>
+#define COLLISION_KERNELS_AVX
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define COLLISION_KERNELS_SSE
+#endif
+
+//Colliders of one shape with one array per field, so a kernel loads the same field of several colliders with one instruction
+struct CircleColliders {
+	void Add(const CircleShape& circle) {
+		x.emplace_back(circle.x);
+		y.emplace_back(circle.y);
+		radius.emplace_back(circle.radius);
+	}
+	void Clear() {
+		x.clear();
+		y.clear();
+		radius.clear();
+	}
+	const unsigned int Size() const {
+		return x.size();
+	}
+
+	std::vector<float> x;
+	std::vector<float> y;
+	std::vector<float> radius;
+};
+
+struct BoxColliders {
+	void Add(const BoxShape& box) {
+		minX.emplace_back(box.minX);
+		minY.emplace_back(box.minY);
+		maxX.emplace_back(box.maxX);
+		maxY.emplace_back(box.maxY);
+	}
+	void Clear() {
+		minX.clear();
+		minY.clear();
+		maxX.clear();
+		maxY.clear();
+	}
+	const unsigned int Size() const {
+		return minX.size();
+	}
+	void Resize(const unsigned int& size) {
+		minX.resize(size);
+		minY.resize(size);
+		maxX.resize(size);
+		maxY.resize(size);
+	}
+	void Set(const unsigned int& index, const BoxShape& box) {
+		minX[index] = box.minX;
+		minY[index] = box.minY;
+		maxX[index] = box.maxX;
+		maxY[index] = box.maxY;
+	}
+
+	std::vector<float> minX;
+	std::vector<float> minY;
+	std::vector<float> maxX;
+	std::vector<float> maxY;
+};
+
+/*Rays with one array per field, a packet kernel casts one ray per lane.
+The arrays are padded to a whole group of lanes with rays that can not hit anything, so a packet of three rays still fills one group*/
+struct RayPacket {
+	void Add(const Ray& ray) {
+		const unsigned int index = rays.size();
+		rays.emplace_back(ray);
+		if (index == length.size()) {
+			Pad(index + maxLanes);
+		}
+		startX[index] = ray.startPosition.x;
+		startY[index] = ray.startPosition.y;
+		//A parallel axis gets no inverse direction, the kernel only checks that the ray starts inside that slab
+		parallelX[index] = std::abs(ray.direction.x) < rayParallelThreshold ? 1.f : 0.f;
+		parallelY[index] = std::abs(ray.direction.y) < rayParallelThreshold ? 1.f : 0.f;
+		inverseDirectionX[index] = parallelX[index] > 0.f ? 0.f : 1.f / ray.direction.x;
+		inverseDirectionY[index] = parallelY[index] > 0.f ? 0.f : 1.f / ray.direction.y;
+		length[index] = ray.length;
+	}
+	//The arrays keep their size, the rays left in them are turned into padding
+	void Clear() {
+		rays.clear();
+		std::fill(length.begin(), length.end(), -1.f);
+	}
+	const unsigned int Size() const {
+		return rays.size();
+	}
+
+	//Widest group of lanes any instruction set uses
+	static constexpr unsigned int maxLanes = 8;
+
+	std::vector<Ray> rays;
+	std::vector<float> startX;
+	std::vector<float> startY;
+	std::vector<float> parallelX;
+	std::vector<float> parallelY;
+	std::vector<float> inverseDirectionX;
+	std::vector<float> inverseDirectionY;
+	std::vector<float> length;
+
+private:
+	//A padding ray has a negative length, so its segment ends before it starts
+	void Pad(const unsigned int& size) {
+		startX.resize(size, 0.f);
+		startY.resize(size, 0.f);
+		parallelX.resize(size, 0.f);
+		parallelY.resize(size, 0.f);
+		inverseDirectionX.resize(size, 1.f);
+		inverseDirectionY.resize(size, 1.f);
+		length.resize(size, -1.f);
+	}
+};
+
+//The closest box a ray of a packet hit, box is the index in the box colliders
+struct RayPacketHit {
+	bool hit = false;
+	unsigned int box = 0;
+	float distance = 0.f;
+	Vector2<float> normal = { 0.f, 0.f };
+};
+
+/*The few lane operations the kernels need, written once for every instruction set so each kernel is written once as well.
+Scalar is a single lane, which is what the remainder after the last full group of lanes is tested with*/
+struct ScalarLanes {
+	using Type = float;
+	static constexpr unsigned int count = 1;
+
+	static Type Load(const float* values) { return *values; }
+	static Type Broadcast(const float& value) { return value; }
+	static Type Add(const Type& a, const Type& b) { return a + b; }
+	static Type Sub(const Type& a, const Type& b) { return a - b; }
+	static Type Mul(const Type& a, const Type& b) { return a * b; }
+	static Type Div(const Type& a, const Type& b) { return a / b; }
+	static Type Sqrt(const Type& a) { return std::sqrt(a); }
+	static Type Min(const Type& a, const Type& b) { return a < b ? a : b; }
+	static Type Max(const Type& a, const Type& b) { return a > b ? a : b; }
+
+	using Mask = bool;
+	static Mask Less(const Type& a, const Type& b) { return a < b; }
+	static Mask Greater(const Type& a, const Type& b) { return a > b; }
+	static Mask LessEqual(const Type& a, const Type& b) { return a <= b; }
+	static Mask And(const Mask& a, const Mask& b) { return a && b; }
+	static Mask Or(const Mask& a, const Mask& b) { return a || b; }
+	static Type Select(const Mask& mask, const Type& a, const Type& b) { return mask ? a : b; }
+	static void Store(float* values, const Type& a) { *values = a; }
+	static unsigned int Bits(const Mask& mask) { return mask ? 1u : 0u; }
+};
+
+#if defined(COLLISION_KERNELS_AVX)
+struct SimdLanes {
+	using Type = __m256;
+	static constexpr unsigned int count = 8;
+
+	static Type Load(const float* values) { return _mm256_loadu_ps(values); }
+	static Type Broadcast(const float& value) { return _mm256_set1_ps(value); }
+	static Type Add(const Type& a, const Type& b) { return _mm256_add_ps(a, b); }
+	static Type Sub(const Type& a, const Type& b) { return _mm256_sub_ps(a, b); }
+	static Type Mul(const Type& a, const Type& b) { return _mm256_mul_ps(a, b); }
+	static Type Div(const Type& a, const Type& b) { return _mm256_div_ps(a, b); }
+	static Type Sqrt(const Type& a) { return _mm256_sqrt_ps(a); }
+	static Type Min(const Type& a, const Type& b) { return _mm256_min_ps(a, b); }
+	static Type Max(const Type& a, const Type& b) { return _mm256_max_ps(a, b); }
+
+	using Mask = __m256;
+	static Mask Less(const Type& a, const Type& b) { return _mm256_cmp_ps(a, b, _CMP_LT_OQ); }
+	static Mask Greater(const Type& a, const Type& b) { return _mm256_cmp_ps(a, b, _CMP_GT_OQ); }
+	static Mask LessEqual(const Type& a, const Type& b) { return _mm256_cmp_ps(a, b, _CMP_LE_OQ); }
+	static Mask And(const Mask& a, const Mask& b) { return _mm256_and_ps(a, b); }
+	static Mask Or(const Mask& a, const Mask& b) { return _mm256_or_ps(a, b); }
+	static Type Select(const Mask& mask, const Type& a, const Type& b) { return _mm256_blendv_ps(b, a, mask); }
+	static void Store(float* values, const Type& a) { _mm256_storeu_ps(values, a); }
+	static unsigned int Bits(const Mask& mask) { return (unsigned int)_mm256_movemask_ps(mask); }
+};
+#elif defined(COLLISION_KERNELS_SSE)
+struct SimdLanes {
+	using Type = __m128;
+	static constexpr unsigned int count = 4;
+
+	static Type Load(const float* values) { return _mm_loadu_ps(values); }
+	static Type Broadcast(const float& value) { return _mm_set1_ps(value); }
+	static Type Add(const Type& a, const Type& b) { return _mm_add_ps(a, b); }
+	static Type Sub(const Type& a, const Type& b) { return _mm_sub_ps(a, b); }
+	static Type Mul(const Type& a, const Type& b) { return _mm_mul_ps(a, b); }
+	static Type Div(const Type& a, const Type& b) { return _mm_div_ps(a, b); }
+	static Type Sqrt(const Type& a) { return _mm_sqrt_ps(a); }
+	static Type Min(const Type& a, const Type& b) { return _mm_min_ps(a, b); }
+	static Type Max(const Type& a, const Type& b) { return _mm_max_ps(a, b); }
+
+	using Mask = __m128;
+	static Mask Less(const Type& a, const Type& b) { return _mm_cmplt_ps(a, b); }
+	static Mask Greater(const Type& a, const Type& b) { return _mm_cmpgt_ps(a, b); }
+	static Mask LessEqual(const Type& a, const Type& b) { return _mm_cmple_ps(a, b); }
+	static Mask And(const Mask& a, const Mask& b) { return _mm_and_ps(a, b); }
+	static Mask Or(const Mask& a, const Mask& b) { return _mm_or_ps(a, b); }
+	static Type Select(const Mask& mask, const Type& a, const Type& b) { return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b)); }
+	static void Store(float* values, const Type& a) { _mm_storeu_ps(values, a); }
+	static unsigned int Bits(const Mask& mask) { return (unsigned int)_mm_movemask_ps(mask); }
+};
+#endif
+
+/*One kernel for every pair of query shape and stored shape, picked by overload resolution so no collider type is read per element.
+Each one tests the lanes starting at index and gives the same answers as the stateless Intersect tests*/
+template<typename Lanes>
+inline typename Lanes::Mask IntersectLanes(const CircleShape& circle, const CircleColliders& colliders, const unsigned int& index) {
+	const typename Lanes::Type deltaX = Lanes::Sub(Lanes::Load(&colliders.x[index]), Lanes::Broadcast(circle.x));
+	const typename Lanes::Type deltaY = Lanes::Sub(Lanes::Load(&colliders.y[index]), Lanes::Broadcast(circle.y));
+	const typename Lanes::Type radius = Lanes::Add(Lanes::Load(&colliders.radius[index]), Lanes::Broadcast(circle.radius));
+	return Lanes::Less(Lanes::Add(Lanes::Mul(deltaX, deltaX), Lanes::Mul(deltaY, deltaY)), Lanes::Mul(radius, radius));
+}
+
+//The circle centre is clamped into every box, the circle hits the box if the clamped point lies inside the circle
+template<typename Lanes>
+inline typename Lanes::Mask IntersectLanes(const CircleShape& circle, const BoxColliders& colliders, const unsigned int& index) {
+	const typename Lanes::Type x = Lanes::Broadcast(circle.x);
+	const typename Lanes::Type y = Lanes::Broadcast(circle.y);
+	const typename Lanes::Type deltaX = Lanes::Sub(x, Lanes::Min(Lanes::Max(x, Lanes::Load(&colliders.minX[index])), Lanes::Load(&colliders.maxX[index])));
+	const typename Lanes::Type deltaY = Lanes::Sub(y, Lanes::Min(Lanes::Max(y, Lanes::Load(&colliders.minY[index])), Lanes::Load(&colliders.maxY[index])));
+	const typename Lanes::Type radius = Lanes::Broadcast(circle.radius);
+	return Lanes::Less(Lanes::Add(Lanes::Mul(deltaX, deltaX), Lanes::Mul(deltaY, deltaY)), Lanes::Mul(radius, radius));
+}
+
+//Every circle centre is clamped into the box
+template<typename Lanes>
+inline typename Lanes::Mask IntersectLanes(const BoxShape& box, const CircleColliders& colliders, const unsigned int& index) {
+	const typename Lanes::Type x = Lanes::Load(&colliders.x[index]);
+	const typename Lanes::Type y = Lanes::Load(&colliders.y[index]);
+	const typename Lanes::Type deltaX = Lanes::Sub(x, Lanes::Min(Lanes::Max(x, Lanes::Broadcast(box.minX)), Lanes::Broadcast(box.maxX)));
+	const typename Lanes::Type deltaY = Lanes::Sub(y, Lanes::Min(Lanes::Max(y, Lanes::Broadcast(box.minY)), Lanes::Broadcast(box.maxY)));
+	const typename Lanes::Type radius = Lanes::Load(&colliders.radius[index]);
+	return Lanes::Less(Lanes::Add(Lanes::Mul(deltaX, deltaX), Lanes::Mul(deltaY, deltaY)), Lanes::Mul(radius, radius));
+}
+
+template<typename Lanes>
+inline typename Lanes::Mask IntersectLanes(const BoxShape& box, const BoxColliders& colliders, const unsigned int& index) {
+	const typename Lanes::Mask overlapX = Lanes::And(
+		Lanes::Greater(Lanes::Broadcast(box.maxX), Lanes::Load(&colliders.minX[index])),
+		Lanes::Greater(Lanes::Load(&colliders.maxX[index]), Lanes::Broadcast(box.minX)));
+	const typename Lanes::Mask overlapY = Lanes::And(
+		Lanes::Greater(Lanes::Broadcast(box.maxY), Lanes::Load(&colliders.minY[index])),
+		Lanes::Greater(Lanes::Load(&colliders.maxY[index]), Lanes::Broadcast(box.minY)));
+	return Lanes::And(overlapX, overlapY);
+}
+
+/*Appends the index of every collider in [first, last) the shape hits to hits, in order.
+Full groups of lanes go through the widest instruction set the build has, the remainder through the scalar lane*/
+template<typename Shape, typename Colliders>
+inline void IntersectBatch(const Shape& shape, const Colliders& colliders, const unsigned int& first, const unsigned int& last, std::vector<unsigned int>& hits) {
+	unsigned int index = first;
+#if defined(COLLISION_KERNELS_AVX) || defined(COLLISION_KERNELS_SSE)
+	for (; index + SimdLanes::count <= last; index += SimdLanes::count) {
+		const unsigned int laneBits = SimdLanes::Bits(IntersectLanes<SimdLanes>(shape, colliders, index));
+		if (laneBits == 0) {
+			continue;
+		}
+		for (unsigned int lane = 0; lane < SimdLanes::count; lane++) {
+			if ((laneBits & (1u << lane)) != 0) {
+				hits.emplace_back(index + lane);
+			}
+		}
+	}
+#endif
+	for (; index < last; index++) {
+		if (ScalarLanes::Bits(IntersectLanes<ScalarLanes>(shape, colliders, index)) != 0) {
+			hits.emplace_back(index);
+		}
+	}
+}
+
+/*Slab test of the lanes of rays starting at rayIndex against one box, with the same rules as RayIntersect.
+Returns the lanes that hit the box closer than their best distance so far, with the distance of those hits and 1 for the lanes that hit a side facing y*/
+template<typename Lanes>
+inline typename Lanes::Mask RayCastLanes(const RayPacket& rays, const unsigned int& rayIndex, const typename Lanes::Type& bestDistance,
+	const BoxColliders& boxes, const unsigned int& boxIndex, typename Lanes::Type& distance, typename Lanes::Type& sideY) {
+	const typename Lanes::Type farthest = Lanes::Broadcast(FLT_MAX);
+	const typename Lanes::Type nearest = Lanes::Broadcast(-FLT_MAX);
+	const typename Lanes::Type zero = Lanes::Broadcast(0.f);
+	const typename Lanes::Type one = Lanes::Broadcast(1.f);
+	const typename Lanes::Type half = Lanes::Broadcast(0.5f);
+	typename Lanes::Type tNear[2];
+	typename Lanes::Type tFar[2];
+	const float* starts[2] = { &rays.startX[rayIndex], &rays.startY[rayIndex] };
+	const float* parallels[2] = { &rays.parallelX[rayIndex], &rays.parallelY[rayIndex] };
+	const float* inverseDirections[2] = { &rays.inverseDirectionX[rayIndex], &rays.inverseDirectionY[rayIndex] };
+	const float mins[2] = { boxes.minX[boxIndex], boxes.minY[boxIndex] };
+	const float maxs[2] = { boxes.maxX[boxIndex], boxes.maxY[boxIndex] };
+	for (unsigned int axis = 0; axis < 2; axis++) {
+		const typename Lanes::Type start = Lanes::Load(starts[axis]);
+		const typename Lanes::Type min = Lanes::Broadcast(mins[axis]);
+		const typename Lanes::Type max = Lanes::Broadcast(maxs[axis]);
+		const typename Lanes::Type inverseDirection = Lanes::Load(inverseDirections[axis]);
+		const typename Lanes::Type tMinSide = Lanes::Mul(Lanes::Sub(min, start), inverseDirection);
+		const typename Lanes::Type tMaxSide = Lanes::Mul(Lanes::Sub(max, start), inverseDirection);
+		//A parallel lane never clips the ray if it starts inside the slab and always misses if it does not
+		const typename Lanes::Mask parallel = Lanes::Greater(Lanes::Load(parallels[axis]), half);
+		const typename Lanes::Mask inside = Lanes::And(Lanes::LessEqual(min, start), Lanes::LessEqual(start, max));
+		tNear[axis] = Lanes::Select(parallel, Lanes::Select(inside, nearest, farthest), Lanes::Min(tMinSide, tMaxSide));
+		tFar[axis] = Lanes::Select(parallel, Lanes::Select(inside, farthest, nearest), Lanes::Max(tMinSide, tMaxSide));
+	}
+	//The rays are cut off at the best hit so far, a box behind it can not be closer
+	const typename Lanes::Type length = Lanes::Min(Lanes::Load(&rays.length[rayIndex]), bestDistance);
+	const typename Lanes::Type tMinX = Lanes::Max(zero, tNear[0]);
+	const typename Lanes::Type tMaxX = Lanes::Min(length, tFar[0]);
+	const typename Lanes::Mask entered = Lanes::Or(Lanes::Greater(tNear[0], zero), Lanes::Greater(tNear[1], zero));
+	const typename Lanes::Mask exited = Lanes::Or(Lanes::Less(tFar[0], length), Lanes::Less(tFar[1], length));
+	const typename Lanes::Type tMin = Lanes::Max(tMinX, tNear[1]);
+	const typename Lanes::Type tMax = Lanes::Min(tMaxX, tFar[1]);
+	distance = Lanes::Select(entered, tMin, tMax);
+	//The y side is the one hit when y clips the ray after x did, the same order RayIntersect clips in
+	sideY = Lanes::Select(entered, Lanes::Select(Lanes::Greater(tNear[1], tMinX), one, zero), Lanes::Select(Lanes::Less(tFar[1], tMaxX), one, zero));
+	return Lanes::And(Lanes::And(Lanes::LessEqual(tMin, tMax), Lanes::Or(entered, exited)), Lanes::Less(distance, bestDistance));
+}
+
+template<typename Lanes>
+inline void RayCastLaneGroup(const RayPacket& rays, const unsigned int& rayIndex, const BoxColliders& boxes, const unsigned int& first, const unsigned int& last,
+	float* bestDistances, float* bestBoxes, float* bestSidesY) {
+	typename Lanes::Type bestDistance = Lanes::Broadcast(FLT_MAX);
+	//The box index is kept as a float so it can be selected like the distance, exact for any number of boxes below 2^24
+	typename Lanes::Type bestBox = Lanes::Broadcast(-1.f);
+	typename Lanes::Type bestSideY = Lanes::Broadcast(0.f);
+	for (unsigned int i = first; i < last; i++) {
+		typename Lanes::Type distance;
+		typename Lanes::Type sideY;
+		const typename Lanes::Mask closer = RayCastLanes<Lanes>(rays, rayIndex, bestDistance, boxes, i, distance, sideY);
+		bestDistance = Lanes::Select(closer, distance, bestDistance);
+		bestBox = Lanes::Select(closer, Lanes::Broadcast((float)i), bestBox);
+		bestSideY = Lanes::Select(closer, sideY, bestSideY);
+	}
+	Lanes::Store(bestDistances, bestDistance);
+	Lanes::Store(bestBoxes, bestBox);
+	Lanes::Store(bestSidesY, bestSideY);
+}
+
+/*Casts every ray of the packet against the boxes in [first, last) and gives each ray the closest box it hit, in the same order as the rays.
+A packet holds the rays of one agent or of many, every group of rays goes through the widest instruction set the build has.
+Every ray keeps its best distance so far as its length, the boxes behind a hit are rejected by the slab test itself*/
+inline void RayCastPacket(const RayPacket& rays, const BoxColliders& boxes, const unsigned int& first, const unsigned int& last, std::vector<RayPacketHit>& hits) {
+	const unsigned int rayCount = rays.Size();
+	hits.resize(rayCount);
+	float bestDistances[RayPacket::maxLanes];
+	float bestBoxes[RayPacket::maxLanes];
+	float bestSidesY[RayPacket::maxLanes];
+	unsigned int rayIndex = 0;
+	while (rayIndex < rayCount) {
+#if defined(COLLISION_KERNELS_AVX) || defined(COLLISION_KERNELS_SSE)
+		const unsigned int laneCount = SimdLanes::count;
+		RayCastLaneGroup<SimdLanes>(rays, rayIndex, boxes, first, last, bestDistances, bestBoxes, bestSidesY);
+#else
+		const unsigned int laneCount = ScalarLanes::count;
+		RayCastLaneGroup<ScalarLanes>(rays, rayIndex, boxes, first, last, bestDistances, bestBoxes, bestSidesY);
+#endif
+		//The padding lanes are left out, the side that was hit faces back along the ray
+		for (unsigned int lane = 0; lane < laneCount && rayIndex + lane < rayCount; lane++) {
+			RayPacketHit& rayHit = hits[rayIndex + lane];
+			rayHit.hit = bestBoxes[lane] >= 0.f;
+			if (!rayHit.hit) {
+				continue;
+			}
+			const Ray& ray = rays.rays[rayIndex + lane];
+			rayHit.box = (unsigned int)bestBoxes[lane];
+			rayHit.distance = bestDistances[lane];
+			if (bestSidesY[lane] > 0.f) {
+				rayHit.normal.x = 0.f;
+				rayHit.normal.y = ray.direction.y > 0.f ? -1.f : 1.f;
+			} else {
+				rayHit.normal.x = ray.direction.x > 0.f ? -1.f : 1.f;
+				rayHit.normal.y = 0.f;
+			}
+		}
+		rayIndex += laneCount;
+	}
+}
@@ -0,0 +1,136 @@
+#include "commandBuffer.h"
+
+#include "enemyManager.h"
+#include "gameEngine.h"
+#include "jobSystem.h"
+#include "objectBase.h"
+#include "projectileManager.h"
+
+#include <algorithm>
+
+//One set of queues per worker of the job system, the main thread is worker 0
+void CommandBuffer::Init(const unsigned int& threadCount) {
+	_threadQueues.clear();
+	for (unsigned int i = 0; i < std::max(1u, threadCount); i++) {
+		_threadQueues.emplace_back(std::make_shared<ThreadQueues>());
+	}
+}
+
+void CommandBuffer::AddDamage(const std::shared_ptr<ObjectBase>& target, const int& damageAmount) {
+	DamageCommand damageCommand;
+	damageCommand.target = target;
+	damageCommand.damageAmount = damageAmount;
+	GetThreadQueues().damageCommands.emplace_back(damageCommand);
+}
+
+void CommandBuffer::AddDespawn(const std::shared_ptr<ObjectBase>& object) {
+	GetThreadQueues().despawnCommands.emplace_back(object);
+}
+
+void CommandBuffer::AddProjectileSpawn(const std::shared_ptr<ObjectBase>& owner, const ProjectileType& projectileType,
+	const float& orientation, const Vector2<float>& direction, const Vector2<float>& position, const unsigned int& damage, const float& speed) {
+	ProjectileSpawnCommand projectileSpawnCommand;
+	projectileSpawnCommand.owner = owner;
+	projectileSpawnCommand.projectileType = projectileType;
+	projectileSpawnCommand.orientation = orientation;
+	projectileSpawnCommand.direction = direction;
+	projectileSpawnCommand.position = position;
+	projectileSpawnCommand.damage = damage;
+	projectileSpawnCommand.speed = speed;
+	GetThreadQueues().projectileSpawnCommands.emplace_back(projectileSpawnCommand);
+}
+
+/*Applies the damage first, then the despawns and the spawns last so a despawned projectile can be spawned again at once.
+A target that dies adds its own despawn, so the passes repeat until no thread has a command left*/
+void CommandBuffer::Flush() {
+	_flushedCommandCount = 0;
+	bool hasCommands = true;
+	while (hasCommands) {
+		_damageCommands.clear();
+		_despawnCommands.clear();
+		_projectileSpawnCommands.clear();
+		for (unsigned int i = 0; i < _threadQueues.size(); i++) {
+			ThreadQueues& threadQueues = *_threadQueues[i];
+			_damageCommands.insert(_damageCommands.end(), threadQueues.damageCommands.begin(), threadQueues.damageCommands.end());
+			_despawnCommands.insert(_despawnCommands.end(), threadQueues.despawnCommands.begin(), threadQueues.despawnCommands.end());
+			_projectileSpawnCommands.insert(_projectileSpawnCommands.end(), threadQueues.projectileSpawnCommands.begin(), threadQueues.projectileSpawnCommands.end());
+			threadQueues.damageCommands.clear();
+			threadQueues.despawnCommands.clear();
+			threadQueues.projectileSpawnCommands.clear();
+		}
+		hasCommands = !_damageCommands.empty() || !_despawnCommands.empty() || !_projectileSpawnCommands.empty();
+		_flushedCommandCount += _damageCommands.size() + _despawnCommands.size() + _projectileSpawnCommands.size();
+		ApplyDamage();
+		ApplyDespawns();
+		ApplyProjectileSpawns();
+	}
+}
+
+//Drops every command that was not applied yet, used when the managers are reset
+void CommandBuffer::Clear() {
+	for (unsigned int i = 0; i < _threadQueues.size(); i++) {
+		_threadQueues[i]->damageCommands.clear();
+		_threadQueues[i]->despawnCommands.clear();
+		_threadQueues[i]->projectileSpawnCommands.clear();
+	}
+}
+
+//The commands applied by the last flush
+const unsigned int CommandBuffer::GetFlushedCommandCount() const {
+	return _flushedCommandCount;
+}
+
+CommandBuffer::ThreadQueues& CommandBuffer::GetThreadQueues() {
+	return *_threadQueues[std::min(jobSystem->GetCurrentWorker(), (unsigned int)_threadQueues.size() - 1)];
+}
+
+//The damage is sorted by target so every target takes the sum of its damage in one call, in the same order whichever threads added it
+void CommandBuffer::ApplyDamage() {
+	std::sort(_damageCommands.begin(), _damageCommands.end(), [](const DamageCommand& a, const DamageCommand& b) {
+		return a.target->GetObjectID() < b.target->GetObjectID();
+	});
+	unsigned int first = 0;
+	while (first < _damageCommands.size()) {
+		int damageAmount = 0;
+		unsigned int last = first;
+		while (last < _damageCommands.size() && _damageCommands[last].target == _damageCommands[first].target) {
+			damageAmount += _damageCommands[last].damageAmount;
+			last++;
+		}
+		_damageCommands[first].target->TakeDamage(damageAmount);
+		first = last;
+	}
+}
+
+//An object can be despawned by several commands in one tick, only the first one that finds it active removes it
+void CommandBuffer::ApplyDespawns() {
+	std::sort(_despawnCommands.begin(), _despawnCommands.end(), [](const std::shared_ptr<ObjectBase>& a, const std::shared_ptr<ObjectBase>& b) {
+		return a->GetObjectID() < b->GetObjectID();
+	});
+	_despawnCommands.erase(std::unique(_despawnCommands.begin(), _despawnCommands.end()), _despawnCommands.end());
+	for (unsigned int i = 0; i < _despawnCommands.size(); i++) {
+		const unsigned int objectID = _despawnCommands[i]->GetObjectID();
+		switch (_despawnCommands[i]->GetObjectType()) {
+		case ObjectType::Enemy:
+			if (enemyManager->GetActiveObjects().contains(objectID)) {
+				enemyManager->RemoveObject(objectID);
+			}
+			break;
+		case ObjectType::Projectile:
+			if (projectileManager->GetActiveObjects().contains(objectID)) {
+				projectileManager->RemoveObject(objectID);
+			}
+			break;
+		default:
+			break;
+		}
+	}
+}
+
+void CommandBuffer::ApplyProjectileSpawns() {
+	for (unsigned int i = 0; i < _projectileSpawnCommands.size(); i++) {
+		const ProjectileSpawnCommand& command = _projectileSpawnCommands[i];
+		projectileManager->SpawnProjectile(command.owner, command.projectileType, command.orientation, command.direction,
+			command.position, command.damage, command.speed);
+	}
+}
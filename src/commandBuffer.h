@@ -0,0 +1,66 @@
+#pragma once
+#include "projectile.h"
+#include "vector2.h"
+
+#include <memory>
+#include <vector>
+
+class ObjectBase;
+
+struct DamageCommand {
+	std::shared_ptr<ObjectBase> target = nullptr;
+	int damageAmount = 0;
+};
+
+//The arguments of ProjectileManager::SpawnProjectile
+struct ProjectileSpawnCommand {
+	std::shared_ptr<ObjectBase> owner = nullptr;
+	ProjectileType projectileType = ProjectileType::Count;
+	float orientation = 0.f;
+	Vector2<float> direction = { 0.f, 0.f };
+	Vector2<float> position = { 0.f, 0.f };
+	unsigned int damage = 0;
+	float speed = 0.f;
+};
+
+/*Collects the damage, despawns and spawns of a tick and applies them together once every object has been updated, so no manager's map changes while it is iterated.
+Every worker thread writes to its own queues, so adding a command takes no lock. Damage to the same target is summed and applied with one call*/
+class CommandBuffer {
+public:
+	CommandBuffer() {}
+	~CommandBuffer() {}
+
+	void Init(const unsigned int& threadCount);
+
+	void AddDamage(const std::shared_ptr<ObjectBase>& target, const int& damageAmount);
+	void AddDespawn(const std::shared_ptr<ObjectBase>& object);
+	void AddProjectileSpawn(const std::shared_ptr<ObjectBase>& owner, const ProjectileType& projectileType,
+		const float& orientation, const Vector2<float>& direction, const Vector2<float>& position, const unsigned int& damage, const float& speed);
+
+	void Flush();
+	void Clear();
+
+	const unsigned int GetFlushedCommandCount() const;
+
+private:
+	struct ThreadQueues {
+		std::vector<DamageCommand> damageCommands;
+		std::vector<std::shared_ptr<ObjectBase>> despawnCommands;
+		std::vector<ProjectileSpawnCommand> projectileSpawnCommands;
+	};
+
+	ThreadQueues& GetThreadQueues();
+
+	void ApplyDamage();
+	void ApplyDespawns();
+	void ApplyProjectileSpawns();
+
+	std::vector<std::shared_ptr<ThreadQueues>> _threadQueues;
+
+	//The commands of every thread gathered for one pass of the flush
+	std::vector<DamageCommand> _damageCommands;
+	std::vector<std::shared_ptr<ObjectBase>> _despawnCommands;
+	std::vector<ProjectileSpawnCommand> _projectileSpawnCommands;
+
+	unsigned int _flushedCommandCount = 0;
+};
@@ -1,5 +1,6 @@
 #include "debugDrawer.h"
 #include "gameEngine.h"
+#include "renderBackend.h"
 
 void DebugDrawer::AddDebugRectangle(const Vector2<float>& position, const Vector2<float>& min, const Vector2<float>& max, const SDL_Color& color, const bool& fill) {
 	_debugRectangle.color = color;
@@ -39,17 +40,17 @@ void DebugDrawer::AddDebugLine(const Vector2<float>& startPosition, const Vector
 
 void DebugDrawer::DrawRectangles() {
 	for (int i = 0; i < _debugRectangles.size(); i++) {
-		SDL_SetRenderDrawColor(renderer, _debugRectangles[i].color.r, _debugRectangles[i].color.g, _debugRectangles[i].color.b, _debugRectangles[i].color.a);
+		renderBackend->SetDrawColor(_debugRectangles[i].color);
 		_rect.x = _debugRectangles[i].position.x - ((_debugRectangles[i].max.x - _debugRectangles[i].min.x) * 0.5f);
 		_rect.y = _debugRectangles[i].position.y - ((_debugRectangles[i].max.y - _debugRectangles[i].min.y) * 0.5f);
 
 		_rect.w = _debugRectangles[i].max.x - _debugRectangles[i].min.x;
 		_rect.h = _debugRectangles[i].max.y - _debugRectangles[i].min.y;
 		if (_debugRectangles[i].fill) {
-			SDL_RenderFillRect(renderer, &_rect);
+			renderBackend->FillRectangle(_rect);
 
 		} else {
-			SDL_RenderDrawRect(renderer, &_rect);
+			renderBackend->DrawRectangle(_rect);
 		}
 	}
 	_debugRectangles.clear();
@@ -57,7 +58,7 @@ void DebugDrawer::DrawRectangles() {
 
 void DebugDrawer::DrawCircles() {
 	for (int i = 0; i < _debugCircles.size(); i++) {
-		SDL_SetRenderDrawColor(renderer, _debugCircles[i].color.r, _debugCircles[i].color.g, _debugCircles[i].color.b, _debugCircles[i].color.a);
+		renderBackend->SetDrawColor(_debugCircles[i].color);
 
 		_resolution = 24;
 		_step = (2 * PI) / _resolution;
@@ -70,12 +71,9 @@ void DebugDrawer::DrawCircles() {
 			_nextAngle = _step * (k + 1);
 			_positionB.x = cos(_nextAngle);
 			_positionB.y = sin(_nextAngle);
-			SDL_RenderDrawLine(
-				renderer,
-				_positionA.x * _debugCircles[i].radius + _debugCircles[i].position.x,
-				_positionA.y * _debugCircles[i].radius + _debugCircles[i].position.y,
-				_positionB.x * _debugCircles[i].radius + _debugCircles[i].position.x,
-				_positionB.y * _debugCircles[i].radius + _debugCircles[i].position.y);
+			renderBackend->DrawLine(
+				_positionA * _debugCircles[i].radius + _debugCircles[i].position,
+				_positionB * _debugCircles[i].radius + _debugCircles[i].position);
 		}
 	}
 	_debugCircles.clear();
@@ -83,9 +81,8 @@ void DebugDrawer::DrawCircles() {
 
 void DebugDrawer::DrawLines() {
 	for (int i = 0; i < _debugLines.size(); i++) {
-	SDL_SetRenderDrawColor(renderer, _debugLines[i].color.r, _debugLines[i].color.g, _debugLines[i].color.b, _debugLines[i].color.a);
-		SDL_RenderDrawLineF(renderer, _debugLines[i].startPosition.x, _debugLines[i].startPosition.y, 
-			_debugLines[i].endPosition.x, _debugLines[i].endPosition.y);
+		renderBackend->SetDrawColor(_debugLines[i].color);
+		renderBackend->DrawLine(_debugLines[i].startPosition, _debugLines[i].endPosition);
 	}
 	_debugLines.clear();
 }
@@ -1,6 +1,6 @@
 #pragma once
-#include <SDL2/SDL.h>
-#include "SDL2/SDL_pixels.h"
+#include <SDL2/SDL_pixels.h>
+#include <SDL2/SDL_rect.h>
 #include "vector2.h"
 
 #include <array>
@@ -48,7 +48,7 @@ private:
 	DebugCircle _debugCircle;
 	DebugLine _debugLine;
 
-	SDL_Rect _rect{ -10000, -10000, 0, 0 };
+	SDL_FRect _rect{ -10000.f, -10000.f, 0.f, 0.f };
 
 	int _resolution = 24;
 
@@ -1,4 +1,5 @@
 #include "enemyBase.h"
+#include "commandBuffer.h"
 #include "playerCharacter.h"
 #include "weaponManager.h"
 #include "stateStack.h"
@@ -16,30 +17,11 @@ EnemyBase::EnemyBase(const EnemyType& enemyType) : ObjectBase(ObjectType::Enemy)
     _prioritySteering = std::make_shared<PrioritySteering>();
     _blendSteering = std::make_shared<BlendSteering>();
 
-    _steeringBehviors.insert(std::make_pair(SteeringBehaviorType::Align, BehaviorAndWeight(std::make_shared<AlignBehavior>(), 1.f)));
-    _steeringBehviors.insert(std::make_pair(SteeringBehaviorType::Face, BehaviorAndWeight(std::make_shared<FaceBehavior>(), 1.f)));
-    _steeringBehviors.insert(std::make_pair(SteeringBehaviorType::LookAtDirection, BehaviorAndWeight(std::make_shared<LookAtDirectionBehavior>(), 1.f)));
-    
-    _steeringBehviors.insert(std::make_pair(SteeringBehaviorType::Separation, BehaviorAndWeight(std::make_shared<SeparationBehavior>(SteeringBehaviorType::Separation), 1.5f))); 
-    _steeringBehviors.insert(std::make_pair(SteeringBehaviorType::Attraction, BehaviorAndWeight(std::make_shared<SeparationBehavior>(SteeringBehaviorType::Attraction), 1.5f)));
-
-    _steeringBehviors.insert(std::make_pair(SteeringBehaviorType::CollisionAbvoidance, BehaviorAndWeight(std::make_shared<CollisionAvoidanceBehavior>(), 2.f)));
-    _steeringBehviors.insert(std::make_pair(SteeringBehaviorType::ObstacleAvoidance, BehaviorAndWeight(std::make_shared<ObstacleAvoidanceBehavior>(), 5.f)));
-
-    
-    _steeringBehviors.insert(std::make_pair(SteeringBehaviorType::Arrive, BehaviorAndWeight(std::make_shared<ArriveBehavior>(), 1.f)));
-    _steeringBehviors.insert(std::make_pair(SteeringBehaviorType::Seek, BehaviorAndWeight(std::make_shared<SeekBehavior>(SteeringBehaviorType::Seek), 1.f)));
-    _steeringBehviors.insert(std::make_pair(SteeringBehaviorType::Flee, BehaviorAndWeight(std::make_shared<SeekBehavior>(SteeringBehaviorType::Flee), 1.f)));
-    _steeringBehviors.insert(std::make_pair(SteeringBehaviorType::Pursue, BehaviorAndWeight(std::make_shared<PursueBehavior>(SteeringBehaviorType::Pursue), 1.f)));
-    _steeringBehviors.insert(std::make_pair(SteeringBehaviorType::Evade, BehaviorAndWeight(std::make_shared<PursueBehavior>(SteeringBehaviorType::Evade), 1.f)));
-    _steeringBehviors.insert(std::make_pair(SteeringBehaviorType::VelocityMatch, BehaviorAndWeight(std::make_shared<VelocityMatchBehavior>(), 1.f)));
-    _steeringBehviors.insert(std::make_pair(SteeringBehaviorType::Wander, BehaviorAndWeight(std::static_pointer_cast<FaceBehavior>(std::make_shared<WanderBehavior>()), 1.f)));
-
     SetDefaultBehaviors();
 }
 
 void EnemyBase::Render() {
-    _sprite->RenderWithOrientation(0, _position, _orientation);
+    _sprite->RenderWithOrientation(0, GetRenderPosition(), GetRenderOrientation());
     _weaponComponent->Render();
 }
 
@@ -58,7 +40,7 @@ const EnemyType EnemyBase::GetEnemyType() const {
 void EnemyBase::TakeDamage(const int& damageAmount) {
     _currentHealth -= damageAmount;
     if (_currentHealth <= 0) {
-        enemyManager->RemoveObject(_objectID);
+        commandBuffer->AddDespawn(shared_from_this());
     }
 }
 
@@ -94,8 +76,108 @@ const std::shared_ptr<PrioritySteering> EnemyBase::GetPrioritySteering() const {
     return _prioritySteering;
 }
 
-std::unordered_map<SteeringBehaviorType, BehaviorAndWeight> EnemyBase::GetSteeringBehviors() const {
-    return _steeringBehviors;
+//One instance of every behaviour with its default weight, shared by all enemies since the behaviours keep no state
+const BehaviorAndWeight& EnemyBase::GetSteeringBehavior(const SteeringBehaviorType& behaviorType) {
+    static const std::array<BehaviorAndWeight, (unsigned int)SteeringBehaviorType::Count> steeringBehaviors = CreateSteeringBehaviors();
+    return steeringBehaviors[(unsigned int)behaviorType];
+}
+
+std::array<BehaviorAndWeight, (unsigned int)SteeringBehaviorType::Count> EnemyBase::CreateSteeringBehaviors() {
+    std::array<BehaviorAndWeight, (unsigned int)SteeringBehaviorType::Count> steeringBehaviors;
+    steeringBehaviors[(unsigned int)SteeringBehaviorType::Align] = BehaviorAndWeight(std::make_shared<AlignBehavior>(), 1.f);
+    steeringBehaviors[(unsigned int)SteeringBehaviorType::Face] = BehaviorAndWeight(std::make_shared<FaceBehavior>(), 1.f);
+    steeringBehaviors[(unsigned int)SteeringBehaviorType::LookAtDirection] = BehaviorAndWeight(std::make_shared<LookAtDirectionBehavior>(), 1.f);
+
+    steeringBehaviors[(unsigned int)SteeringBehaviorType::Separation] = BehaviorAndWeight(std::make_shared<SeparationBehavior>(SteeringBehaviorType::Separation), 1.5f);
+    steeringBehaviors[(unsigned int)SteeringBehaviorType::Attraction] = BehaviorAndWeight(std::make_shared<SeparationBehavior>(SteeringBehaviorType::Attraction), 1.5f);
+
+    steeringBehaviors[(unsigned int)SteeringBehaviorType::CollisionAbvoidance] = BehaviorAndWeight(std::make_shared<CollisionAvoidanceBehavior>(), 2.f);
+    steeringBehaviors[(unsigned int)SteeringBehaviorType::ObstacleAvoidance] = BehaviorAndWeight(std::make_shared<ObstacleAvoidanceBehavior>(), 5.f);
+
+    steeringBehaviors[(unsigned int)SteeringBehaviorType::Arrive] = BehaviorAndWeight(std::make_shared<ArriveBehavior>(), 1.f);
+    steeringBehaviors[(unsigned int)SteeringBehaviorType::Seek] = BehaviorAndWeight(std::make_shared<SeekBehavior>(SteeringBehaviorType::Seek), 1.f);
+    steeringBehaviors[(unsigned int)SteeringBehaviorType::Flee] = BehaviorAndWeight(std::make_shared<SeekBehavior>(SteeringBehaviorType::Flee), 1.f);
+    steeringBehaviors[(unsigned int)SteeringBehaviorType::Pursue] = BehaviorAndWeight(std::make_shared<PursueBehavior>(SteeringBehaviorType::Pursue), 1.f);
+    steeringBehaviors[(unsigned int)SteeringBehaviorType::Evade] = BehaviorAndWeight(std::make_shared<PursueBehavior>(SteeringBehaviorType::Evade), 1.f);
+    steeringBehaviors[(unsigned int)SteeringBehaviorType::VelocityMatch] = BehaviorAndWeight(std::make_shared<VelocityMatchBehavior>(), 1.f);
+    steeringBehaviors[(unsigned int)SteeringBehaviorType::Wander] = BehaviorAndWeight(std::static_pointer_cast<FaceBehavior>(std::make_shared<WanderBehavior>()), 1.f);
+    return steeringBehaviors;
+}
+
+//Runs the part of the update the steering reads, the manager calls it on every enemy before any steering is found
+void EnemyBase::PrepareSteering() {}
+
+//Steering of the enemies whose behaviours the manager's steering batch cannot run
+void EnemyBase::UpdateSteering() {
+    _steeringOutput = _prioritySteering->Steering(_behaviorData, *this);
+}
+
+void EnemyBase::SetSteeringOutput(const SteeringOutput& steeringOutput) {
+    _steeringOutput = steeringOutput;
+}
+
+const SteeringPipelineType EnemyBase::GetSteeringPipeline() const {
+    return _steeringPipeline;
+}
+
+const SteeringWeights& EnemyBase::GetSteeringWeights() const {
+    return _steeringWeights;
+}
+
+/*The weights are read once here instead of every tick, call it again after the priority steering is changed.
+The enemy keeps its own priority steering if the pipeline has no behaviour for one it weights*/
+void EnemyBase::SetSteeringPipeline(const SteeringPipelineType& pipelineType) {
+    _steeringPipeline = SteeringPipelineType::Count;
+    if (pipelineType == SteeringPipelineType::Count || !_prioritySteering->GetBatchWeights(_steeringWeights)) {
+        return;
+    }
+    for (unsigned int i = 0; i < _steeringWeights.size(); i++) {
+        if (_steeringWeights[i] != 0.f && !SteeringBatch::Steers(pipelineType, SteeringBehaviorType(i))) {
+            return;
+        }
+    }
+    _steeringPipeline = pipelineType;
+}
+
+const AILevelOfDetail EnemyBase::GetLevelOfDetail() const {
+    return _levelOfDetail;
+}
+
+void EnemyBase::SetLevelOfDetail(const AILevelOfDetail& levelOfDetail) {
+    _levelOfDetail = levelOfDetail;
+}
+
+//Standing at its target, the linear movement stops the enemy once its steering has nothing left to do
+const bool EnemyBase::IsSettled() const {
+    return _velocity.absolute() < FLT_EPSILON && (_targetPosition - _position).absolute() <= _behaviorData.linearTargetRadius;
+}
+
+/*The part of the tick that may run on any worker thread, it only reads the current state of the enemies and writes this enemy's next state.
+Enemies that move somewhere else in their update keep the state they have*/
+void EnemyBase::Simulate() {
+    _nextState = GetKinematicState();
+}
+
+//Makes the state Simulate wrote the current one, the manager calls it on the main thread once every enemy is simulated
+void EnemyBase::PublishState() {
+    SetKinematicState(_nextState);
+}
+
+const KinematicState EnemyBase::GetKinematicState() const {
+    KinematicState kinematicState;
+    kinematicState.position = _position;
+    kinematicState.velocity = _velocity;
+    kinematicState.orientation = _orientation;
+    kinematicState.rotation = _rotation;
+    return kinematicState;
+}
+
+void EnemyBase::SetKinematicState(const KinematicState& kinematicState) {
+    _position = kinematicState.position;
+    _velocity = kinematicState.velocity;
+    _orientation = kinematicState.orientation;
+    _rotation = kinematicState.rotation;
+    _collider->SetPosition(_position);
 }
 
 void EnemyBase::UpdateMovement() {
@@ -104,19 +186,30 @@ void EnemyBase::UpdateMovement() {
 }
 
 void EnemyBase::UpdateAngularMovement() {
-    _orientation += _rotation * deltaTime;
-    _rotation += _steeringOutput.angularVelocity * deltaTime;
+    KinematicState kinematicState = GetKinematicState();
+    IntegrateAngularMovement(kinematicState);
+    SetKinematicState(kinematicState);
 }
 
 void EnemyBase::UpdateLinearMovement() {
-    _position += _velocity * deltaTime;
-    _collider->SetPosition(_position);
-    _velocity += _steeringOutput.linearVelocity * deltaTime;
+    KinematicState kinematicState = GetKinematicState();
+    IntegrateLinearMovement(kinematicState);
+    SetKinematicState(kinematicState);
+}
+
+void EnemyBase::IntegrateAngularMovement(KinematicState& kinematicState) const {
+    kinematicState.orientation += kinematicState.rotation * deltaTime;
+    kinematicState.rotation += _steeringOutput.angularVelocity * deltaTime;
+}
+
+void EnemyBase::IntegrateLinearMovement(KinematicState& kinematicState) const {
+    kinematicState.position += kinematicState.velocity * deltaTime;
+    kinematicState.velocity += _steeringOutput.linearVelocity * deltaTime;
 
     if (_steeringOutput.linearVelocity.absolute() < FLT_EPSILON) {
-        _velocity = { 0.f, 0.f };
+        kinematicState.velocity = { 0.f, 0.f };
     }
-    universalFunctions->LimitVelocity(_velocity, _behaviorData.maxSpeed);
+    universalFunctions->LimitVelocity(kinematicState.velocity, _behaviorData.maxSpeed);
 }
 
 void EnemyBase::ActivateEnemy(const float& orienation, const Vector2<float>& direction,
@@ -132,12 +225,17 @@ void EnemyBase::ActivateEnemy(const float& orienation, const Vector2<float>& dir
         _weaponComponent->Init();
     }
     Init();
+    ResetPreviousState();
 }
 
 void EnemyBase::DeactivateObject() {
     _position = deactivatedPosition;
     _collider->SetPosition(_position);
     _formationIndex = -1;
+    _levelOfDetail = AILevelOfDetail::Full;
+    _steeringOutput = SteeringOutput();
+    _steeringState = SteeringState();
+    ClearNeighbourList();
     SetDefaultBehaviors();
     weaponManager->RemoveObject(_weaponComponent->GetObjectID());
     _weaponComponent = nullptr;
@@ -145,9 +243,9 @@ void EnemyBase::DeactivateObject() {
 
 void EnemyBase::SetDefaultBehaviors() {
     _prioritySteering->ClearGroups();
-    _blendSteering->AddSteeringBehavior(_steeringBehviors[SteeringBehaviorType::Arrive]);
-    _blendSteering->AddSteeringBehavior(_steeringBehviors[SteeringBehaviorType::Face]);
-    _blendSteering->AddSteeringBehavior(_steeringBehviors[SteeringBehaviorType::Separation]);
+    _blendSteering->AddSteeringBehavior(GetSteeringBehavior(SteeringBehaviorType::Arrive));
+    _blendSteering->AddSteeringBehavior(GetSteeringBehavior(SteeringBehaviorType::Face));
+    _blendSteering->AddSteeringBehavior(GetSteeringBehavior(SteeringBehaviorType::Separation));
     _prioritySteering->AddGroup(*_blendSteering);
     _blendSteering->ClearBehaviors();
 }
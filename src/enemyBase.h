@@ -16,6 +16,14 @@ enum class EnemyType {
 	Count
 };
 
+//The part of an enemy that moves every tick, the manager integrates the next one while every enemy still reads the current one
+struct KinematicState {
+	Vector2<float> position = { 0.f, 0.f };
+	Vector2<float> velocity = { 0.f, 0.f };
+	float orientation = 0.f;
+	float rotation = 0.f;
+};
+
 class EnemyBase : public ObjectBase {
 public:
 	EnemyBase(const EnemyType& enemyType);
@@ -43,11 +51,31 @@ public:
 	
 	const std::shared_ptr<BlendSteering> GetBlendSteering() const;
 	const std::shared_ptr<PrioritySteering> GetPrioritySteering() const;
-	std::unordered_map<SteeringBehaviorType, BehaviorAndWeight> GetSteeringBehviors() const;
+	static const BehaviorAndWeight& GetSteeringBehavior(const SteeringBehaviorType& behaviorType);
+
+	virtual void PrepareSteering();
+	void UpdateSteering();
+	void SetSteeringOutput(const SteeringOutput& steeringOutput);
+
+	const SteeringPipelineType GetSteeringPipeline() const;
+	const SteeringWeights& GetSteeringWeights() const;
+	void SetSteeringPipeline(const SteeringPipelineType& pipelineType);
+
+	const AILevelOfDetail GetLevelOfDetail() const;
+	void SetLevelOfDetail(const AILevelOfDetail& levelOfDetail);
+	const bool IsSettled() const;
+
+	virtual void Simulate();
+	void PublishState();
+
+	const KinematicState GetKinematicState() const;
+	void SetKinematicState(const KinematicState& kinematicState);
 
 	void UpdateMovement();
 	void UpdateAngularMovement();
 	void UpdateLinearMovement();
+	void IntegrateAngularMovement(KinematicState& kinematicState) const;
+	void IntegrateLinearMovement(KinematicState& kinematicState) const;
 
 	virtual void ActivateEnemy(const float& orienation, const Vector2<float>& direction, 
 		const Vector2<float>& position, const WeaponType& weaponType);
@@ -61,10 +89,14 @@ public:
 	void SetPosition(const Vector2<float>& position) override;
 	
 protected:
-	std::unordered_map<SteeringBehaviorType, BehaviorAndWeight> _steeringBehviors;
 	std::shared_ptr<SlotAssignment> _currentSlotAssignment = nullptr;
 
 	SteeringOutput _steeringOutput;
+	//Written by Simulate and made the current state by PublishState
+	KinematicState _nextState;
+	SteeringPipelineType _steeringPipeline = SteeringPipelineType::Count;
+	SteeringWeights _steeringWeights = {};
+	AILevelOfDetail _levelOfDetail = AILevelOfDetail::Full;
 
 	std::shared_ptr<BlendSteering> _blendSteering = nullptr;
 	std::shared_ptr<PrioritySteering> _prioritySteering = nullptr;
@@ -75,4 +107,7 @@ protected:
 	const EnemyType _enemyType = EnemyType::Count;
 
 	int _formationIndex = -1;
+
+private:
+	static std::array<BehaviorAndWeight, (unsigned int)SteeringBehaviorType::Count> CreateSteeringBehaviors();
 };
\ No newline at end of file
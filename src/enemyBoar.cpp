@@ -1,10 +1,11 @@
 #include "enemyBoar.h"
 
 #include "debugDrawer.h"
+#include "flowField.h"
 #include "gameEngine.h"
 #include "imGuiManager.h"
 #include "playerCharacter.h"
-#include "quadTree.h"
+#include "spatialIndex.h"
 #include "steeringBehavior.h"
 #include "timerHandler.h"
 
@@ -29,6 +30,7 @@ EnemyBoar::EnemyBoar() : EnemyBase(EnemyType::Boar) {
 	
 	_behaviorData.separationThreshold = _behaviorData.characterRadius * 1.5f;
 	_behaviorData.decayCoefficient = 10000.f;
+	_behaviorData.maxSeparationNeighbours = 6;
 
 }
 
@@ -45,14 +47,20 @@ void EnemyBoar::Init() {
 	_behaviorData.linearSlowDownRadius = _weaponComponent->GetAttackRange() + 50.f;
 
 	_currentHealth = _maxHealth + _weaponComponent->GetHealthModifier();
+	SetSteeringPipeline(SteeringPipelineType::Boar);
 }
 
-void EnemyBoar::Update() {
-	_steeringOutput = _prioritySteering->Steering(_behaviorData, *this);
+//The waypoint is only read by the boar's own steering, so it can be written here with the next state
+void EnemyBoar::Simulate() {
+	_nextState = GetKinematicState();
 	if(!_weaponComponent->GetIsAttacking()) {
-		_targetPosition = _currentTarget->GetPosition();
-		UpdateMovement();
+		_targetPosition = flowField->GetWaypoint(_position, _currentTarget->GetPosition());
+		IntegrateAngularMovement(_nextState);
+		IntegrateLinearMovement(_nextState);
 	}
+}
+
+void EnemyBoar::Update() {
 	_weaponComponent->Update();
 	_weaponComponent->UpdateAttack();
 	_collider->SetPosition(_position);
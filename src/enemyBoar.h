@@ -12,6 +12,7 @@ public:
 	~EnemyBoar();
 
 	void Init() override;
+	void Simulate() override;
 	void Update() override;
 
 private:
@@ -1,10 +1,11 @@
 #include "enemyHuman.h"
 
 #include "debugDrawer.h"
+#include "flowField.h"
 #include "gameEngine.h"
 #include "playerCharacter.h"
 #include "projectileManager.h"
-#include "quadTree.h"
+#include "spatialIndex.h"
 #include "stateStack.h"
 #include "steeringBehavior.h"
 #include "weaponComponent.h"
@@ -34,6 +35,7 @@ EnemyHuman::EnemyHuman() : EnemyBase(EnemyType::Human) {
 
 	_behaviorData.separationThreshold = _behaviorData.characterRadius * 1.5f;
 	_behaviorData.decayCoefficient = 10000.f;
+	_behaviorData.maxSeparationNeighbours = 6;
 
 	_behaviorData.linearTargetRadius = 5.f;
 	_behaviorData.linearSlowDownRadius = 20.f;
@@ -71,29 +73,35 @@ void EnemyHuman::Init() {
 	}
 	switch (gameStateHandler->GetGameMode()) {
 	case GameMode::Formation:				
-		if (!_prioritySteering->ReplaceSteeringBehavior(SteeringBehaviorType::Face, _steeringBehviors[SteeringBehaviorType::Align])) {
-			_prioritySteering->AddBehaviorInGroup(_steeringBehviors[SteeringBehaviorType::Align], 0);
+		if (!_prioritySteering->ReplaceSteeringBehavior(SteeringBehaviorType::Face, GetSteeringBehavior(SteeringBehaviorType::Align))) {
+			_prioritySteering->AddBehaviorInGroup(GetSteeringBehavior(SteeringBehaviorType::Align), 0);
 		}
 		break;
 	case GameMode::Survival:
-		if (!_prioritySteering->ReplaceSteeringBehavior(SteeringBehaviorType::Align, _steeringBehviors[SteeringBehaviorType::Face])) {
-			_prioritySteering->AddBehaviorInGroup(_steeringBehviors[SteeringBehaviorType::Face], 0);
+		if (!_prioritySteering->ReplaceSteeringBehavior(SteeringBehaviorType::Align, GetSteeringBehavior(SteeringBehaviorType::Face))) {
+			_prioritySteering->AddBehaviorInGroup(GetSteeringBehavior(SteeringBehaviorType::Face), 0);
 		}
 		break;
 	default:
 		break;
 	}
+	SetSteeringPipeline(gameStateHandler->GetGameMode() == GameMode::Formation ? SteeringPipelineType::HumanFormation : SteeringPipelineType::HumanSurvival);
 }
 
-void EnemyHuman::Update() {
+void EnemyHuman::PrepareSteering() {
 	UpdateTarget();
 	//Depending on the weapon, the attack works differently
 	_weaponComponent->UpdateAttack();
-	_steeringOutput = _prioritySteering->Steering(_behaviorData, *this);
-	UpdateMovement();
 }
 
+void EnemyHuman::Simulate() {
+	_nextState = GetKinematicState();
+	IntegrateAngularMovement(_nextState);
+	IntegrateLinearMovement(_nextState);
+}
+
+//The player if it can be seen, otherwise the way around the obstacles the flow field leads
 void EnemyHuman::UpdateTarget() {
 	_currentTarget = playerCharacters.back();
-	_targetPosition = _currentTarget->GetPosition();
+	_targetPosition = flowField->GetWaypoint(_position, _currentTarget->GetPosition());
 }
\ No newline at end of file
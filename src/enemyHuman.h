@@ -20,7 +20,8 @@ public:
 	~EnemyHuman();
 
 	void Init() override;
-	void Update() override;
+	void PrepareSteering() override;
+	void Simulate() override;
 	
 private:
 	void UpdateTarget();
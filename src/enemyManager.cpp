@@ -4,18 +4,24 @@
 #include "enemyBase.h"
 #include "enemyBoar.h"
 #include "enemyHuman.h"
+#include "flowField.h"
 #include "gameEngine.h"
+#include "jobSystem.h"
 #include "objectPool.h"
 #include "obstacleManager.h"
 #include "playerCharacter.h"
-#include "quadTree.h"
 #include "searchSortAlgorithms.h"
+#include "spatialIndex.h"
 #include "stateStack.h"
 #include "steeringBehavior.h"
 #include "timerHandler.h"
 #include "weaponComponent.h"
 #include "weaponManager.h"
 
+#include <algorithm>
+#include <chrono>
+#include <climits>
+
 EnemyManager::EnemyManager() {
 	//Creates an unordered map with objectpool of the different enemy types
 	_numberOfEnemyTypes = (unsigned int)EnemyType::Count;
@@ -46,11 +52,176 @@ void EnemyManager::Update() {
 	if (_spawnTimer->GetIsFinished()) {
 		_spawnEnemy = true;
 	}
+	flowField->Update(playerCharacters.back()->GetPosition());
+	const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	UpdateLevelsOfDetail();
+	FindSeparationNeighbours();
+	UpdateSteering();
+	_levelOfDetailStatistics.steeringMilliseconds = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - start).count();
+	SimulateEnemies();
 	for (auto& objectBase : _activeObjects) {
 		objectBase.second->Update();
-		objectBase.second->QueryObjects();
 	}
 }
+/*Moves the enemies in two steps so the result does not depend on how they are split over the worker threads.
+Every enemy writes its next state from the current state of all of them, then the states are swapped on the main thread before the rest of the update runs in order*/
+void EnemyManager::SimulateEnemies() {
+	_simulatedEnemies.clear();
+	for (auto& objectBase : _activeObjects) {
+		_simulatedEnemies.emplace_back(CastAsEnemy(objectBase.second));
+	}
+	jobSystem->ParallelFor(_simulatedEnemies.size(), _simulationGrainSize, [this](const unsigned int first, const unsigned int last) {
+		for (unsigned int i = first; i < last; i++) {
+			_simulatedEnemies[i]->Simulate();
+		}
+	});
+	for (unsigned int i = 0; i < _simulatedEnemies.size(); i++) {
+		_simulatedEnemies[i]->PublishState();
+	}
+}
+/*Picks how often every enemy thinks and which of them steer this frame.
+Enemies near the player think every frame, the rest steer at a lower rate spread over the frames by their ids, an enemy that settled at its target drops to dormant*/
+void EnemyManager::UpdateLevelsOfDetail() {
+	_levelOfDetailFrame++;
+	_levelOfDetailStatistics.population = {};
+	_levelOfDetailStatistics.steered = {};
+	_thinkingEnemies.clear();
+	const Vector2<float> playerPosition = playerCharacters.back()->GetPosition();
+	const float margin = _levelOfDetailSettings.screenMargin;
+	for (auto& objectBase : _activeObjects) {
+		_currentEnemy = CastAsEnemy(objectBase.second);
+		const Vector2<float> position = _currentEnemy->GetPosition();
+		AILevelOfDetail levelOfDetail = AILevelOfDetail::Dormant;
+		if (_currentEnemy->GetEnemyType() == EnemyType::Boss ||
+			universalFunctions->IsInDistance(playerPosition, position, _levelOfDetailSettings.fullDistance)) {
+			levelOfDetail = AILevelOfDetail::Full;
+		} else if (position.x >= -margin && position.x <= windowWidth + margin && position.y >= -margin && position.y <= windowHeight + margin &&
+			!_currentEnemy->IsSettled()) {
+			levelOfDetail = AILevelOfDetail::Reduced;
+		}
+		_currentEnemy->SetLevelOfDetail(levelOfDetail);
+		_levelOfDetailStatistics.population[(unsigned int)levelOfDetail]++;
+
+		unsigned int interval = 1;
+		if (levelOfDetail == AILevelOfDetail::Reduced) {
+			interval = _levelOfDetailSettings.reducedInterval;
+		} else if (levelOfDetail == AILevelOfDetail::Dormant) {
+			interval = _levelOfDetailSettings.dormantInterval;
+		}
+		if (interval <= 1 || (_levelOfDetailFrame + _currentEnemy->GetObjectID()) % interval == 0) {
+			_thinkingEnemies.emplace_back(_currentEnemy);
+			_levelOfDetailStatistics.steered[(unsigned int)levelOfDetail]++;
+		}
+	}
+	_currentEnemy = nullptr;
+}
+/*Finds the steering of every enemy that thinks this frame before any of them moves, the others keep their last steering.
+The enemies with a steering pipeline are added to the batch grouped by pipeline so each pipeline runs over one range, split into jobs.
+The others run their own priority steering on the main thread, their behaviours can query the spatial index and draw random numbers*/
+void EnemyManager::UpdateSteering() {
+	_steeringBatch.Clear();
+	_batchedEnemies.clear();
+	for (unsigned int i = 0; i < _pipelineEnemies.size(); i++) {
+		_pipelineEnemies[i].clear();
+	}
+	for (unsigned int i = 0; i < _thinkingEnemies.size(); i++) {
+		_currentEnemy = _thinkingEnemies[i];
+		_currentEnemy->PrepareSteering();
+		if (_currentEnemy->GetSteeringPipeline() == SteeringPipelineType::Count) {
+			_currentEnemy->UpdateSteering();
+		} else {
+			_pipelineEnemies[(unsigned int)_currentEnemy->GetSteeringPipeline()].emplace_back(_currentEnemy);
+		}
+	}
+	_currentEnemy = nullptr;
+	for (unsigned int i = 0; i < _pipelineEnemies.size(); i++) {
+		for (unsigned int j = 0; j < _pipelineEnemies[i].size(); j++) {
+			const std::shared_ptr<EnemyBase>& enemy = _pipelineEnemies[i][j];
+			_steeringBatch.AddAgent(SteeringPipelineType(i), *enemy, enemy->GetBehaviorData(), enemy->GetSteeringWeights());
+			_batchedEnemies.emplace_back(enemy);
+		}
+	}
+	_steeringBatch.SplitIntoChunks(_steeringChunkSize);
+	jobSystem->ParallelFor(_steeringBatch.GetChunkCount(), 1, [this](const unsigned int first, const unsigned int last) {
+		for (unsigned int i = first; i < last; i++) {
+			_steeringBatch.RunChunk(i);
+		}
+	});
+	for (unsigned int i = 0; i < _batchedEnemies.size(); i++) {
+		_batchedEnemies[i]->SetSteeringOutput(_steeringBatch.GetSteering(i));
+	}
+}
+/*Every enemy keeps the objects within its separation threshold plus a skin as its neighbour list and picks its nearest neighbours from it every frame it steers.
+Only the lists of enemies that moved, or whose neighbours moved, more than half the skin since they were built are queried again, as one batch spread over the worker threads*/
+void EnemyManager::FindSeparationNeighbours() {
+	_neighbourQueries.clear();
+	_queryingEnemies.clear();
+	_separatingEnemies.clear();
+	for (unsigned int i = 0; i < _thinkingEnemies.size(); i++) {
+		_currentEnemy = _thinkingEnemies[i];
+		const BehaviorData behaviorData = _currentEnemy->GetBehaviorData();
+		if (behaviorData.maxSeparationNeighbours == 0) {
+			continue;
+		}
+		_separatingEnemies.emplace_back(_currentEnemy);
+		if (!_currentEnemy->IsNeighbourListStale(_neighbourListSkin * 0.5f)) {
+			continue;
+		}
+		NearestQuery nearestQuery;
+		nearestQuery.point = _currentEnemy->GetPosition();
+		nearestQuery.maxDistance = behaviorData.separationThreshold + _neighbourListSkin;
+		//Everything in reach is kept, the nearest are picked from the list every frame
+		nearestQuery.k = UINT_MAX;
+		nearestQuery.layerMask = _currentEnemy->GetCollisionMask();
+		_neighbourQueries.emplace_back(nearestQuery);
+		_queryingEnemies.emplace_back(_currentEnemy);
+	}
+	_currentEnemy = nullptr;
+	_neighbourObjects.clear();
+	if (!_neighbourQueries.empty()) {
+		spatialIndex->QueryNearestBatch(_neighbourQueries, _neighbourObjects, _neighbourRanges);
+	}
+	for (unsigned int i = 0; i < _queryingEnemies.size(); i++) {
+		_queryingEnemies[i]->SetNeighbourList(_neighbourObjects, _neighbourRanges[i].first, _neighbourRanges[i].count);
+	}
+	/*An enemy can walk into a list it was not in without anything in that list moving far, so every enemy that built its list joins the lists of the enemies it found.
+	Two enemies that close in on each other are then both caught as soon as one of them moved half the skin*/
+	for (unsigned int i = 0; i < _queryingEnemies.size(); i++) {
+		const NeighbourList& neighbourList = _queryingEnemies[i]->GetNeighbourList();
+		for (unsigned int j = 0; j < neighbourList.objects.size(); j++) {
+			if (neighbourList.objects[j]->GetObjectType() == ObjectType::Enemy && neighbourList.objects[j] != _queryingEnemies[i]) {
+				neighbourList.objects[j]->AddToNeighbourList(_queryingEnemies[i]);
+			}
+		}
+	}
+	_neighbourListsChecked = _separatingEnemies.size();
+	_neighbourListsRebuilt = _queryingEnemies.size();
+	for (unsigned int i = 0; i < _separatingEnemies.size(); i++) {
+		FindNearestNeighbours(*_separatingEnemies[i]);
+	}
+}
+//The same neighbours a nearest query inside the separation threshold finds, the enemy itself is one of them
+void EnemyManager::FindNearestNeighbours(EnemyBase& enemy) {
+	const BehaviorData behaviorData = enemy.GetBehaviorData();
+	const NeighbourList& neighbourList = enemy.GetNeighbourList();
+	const Vector2<float> position = enemy.GetPosition();
+	const float maxDistanceSquared = behaviorData.separationThreshold * behaviorData.separationThreshold;
+	_neighbourDistances.clear();
+	for (unsigned int i = 0; i < neighbourList.objects.size(); i++) {
+		const Vector2<float> delta = neighbourList.colliders[i]->GetPosition() - position;
+		const float distanceSquared = delta.x * delta.x + delta.y * delta.y;
+		if (distanceSquared <= maxDistanceSquared) {
+			_neighbourDistances.emplace_back(distanceSquared, i);
+		}
+	}
+	const unsigned int count = std::min((unsigned int)_neighbourDistances.size(), behaviorData.maxSeparationNeighbours + 1);
+	std::partial_sort(_neighbourDistances.begin(), _neighbourDistances.begin() + count, _neighbourDistances.end());
+	_nearestNeighbours.clear();
+	for (unsigned int i = 0; i < count; i++) {
+		_nearestNeighbours.emplace_back(neighbourList.objects[_neighbourDistances[i].second]);
+	}
+	enemy.SetNearestObjects(_nearestNeighbours, 0, count);
+}
 void EnemyManager::UpdateBossRush() {
 	if (_spawnEnemy && _activeObjects.size() <= 0) {
 		BossSpawner();
@@ -216,9 +387,10 @@ void EnemyManager::TestEnemySpawner() {
 	_currentEnemy = SpawnEnemy(EnemyType::Human, 0, { 0.f, 0.f }, { 300.f, 200.f }, WeaponType::Sword);
 	_currentEnemy->GetBlendSteering()->ClearBehaviors();
 	_currentEnemy->GetPrioritySteering()->ClearGroups();	
-	_currentEnemy->GetBlendSteering()->AddSteeringBehavior(_currentEnemy->GetSteeringBehviors()[SteeringBehaviorType::ObstacleAvoidance]);
-	_currentEnemy->GetBlendSteering()->AddSteeringBehavior(_currentEnemy->GetSteeringBehviors()[SteeringBehaviorType::Wander]);
+	_currentEnemy->GetBlendSteering()->AddSteeringBehavior(EnemyBase::GetSteeringBehavior(SteeringBehaviorType::ObstacleAvoidance));
+	_currentEnemy->GetBlendSteering()->AddSteeringBehavior(EnemyBase::GetSteeringBehavior(SteeringBehaviorType::Wander));
 	_currentEnemy->GetPrioritySteering()->AddGroup(*_currentEnemy->GetBlendSteering());
+	_currentEnemy->SetSteeringPipeline(SteeringPipelineType::Count);
 }
 
 //Spawn a specific enemy from the object pool. If the pool is empty, create a new enemy of that type
@@ -237,6 +409,7 @@ std::shared_ptr<EnemyBase> EnemyManager::SpawnEnemy(const EnemyType& enemyType,
 void EnemyManager::RemoveAllObjects() {
 	for (auto& enemy : _activeObjects) {
 		_currentEnemy = CastAsEnemy(enemy.second);
+		spatialIndex->Remove(enemy.second);
 		_currentEnemy->DeactivateObject();
 		_enemyPools[_currentEnemy->GetEnemyType()]->PoolObject(_currentEnemy);
 	}
@@ -253,7 +426,8 @@ void EnemyManager::RemoveObject(const unsigned int& objectID) {
 	if (_formationManagers.size() > 0) {
 		_formationManagers[_currentEnemy->GetFormationIndex()]->RemoveCharacter(_currentEnemy);
 	}
-	//Deactivate the enemy by setting its position to a far away place
+	//Deactivate the enemy by setting its position to a far away place and take it out of the quadtree
+	spatialIndex->Remove(_activeObjects[objectID]);
 	_currentEnemy->DeactivateObject();
 	
 	//Adds the enemy to the object pool and place it at the back of the vector
@@ -287,6 +461,22 @@ const unsigned int EnemyManager::GetWaveNumber() const {
 	return _waveNumber;
 }
 
+const AILevelOfDetailStatistics& EnemyManager::GetLevelOfDetailStatistics() const {
+	return _levelOfDetailStatistics;
+}
+
+AILevelOfDetailSettings& EnemyManager::GetLevelOfDetailSettings() {
+	return _levelOfDetailSettings;
+}
+
+//The share of the neighbour lists that had to be queried again last frame
+const float EnemyManager::GetNeighbourListRebuildRate() const {
+	if (_neighbourListsChecked == 0) {
+		return 0.f;
+	}
+	return (float)_neighbourListsRebuilt / (float)_neighbourListsChecked;
+}
+
 std::shared_ptr<EnemyBase> EnemyManager::CastAsEnemy(std::shared_ptr<ObjectBase> currentObject) {
 	return std::static_pointer_cast<EnemyBase>(currentObject);
 }
@@ -1,7 +1,7 @@
 #pragma once
 #include "formationHandler.h"
 #include "managerBase.h"
-#include "quadTree.h"
+#include "steeringBatch.h"
 #include "universalFunctions.h"
 #include "vector2.h"
 
@@ -10,11 +10,35 @@ class SteeringBehavior;
 class Timer;
 
 template<typename T> class ObjectPool;
-template<typename T> class QuadTree;
 
 enum class EnemyType;
 enum class WeaponType;
 
+//How often an enemy thinks, picked every frame from its distance to the player and whether it is on screen
+enum class AILevelOfDetail {
+	Full,
+	Reduced,
+	Dormant,
+	Count
+};
+
+//Enemies closer than fullDistance think every frame, the others steer every reducedInterval or dormantInterval frames and keep moving on their last steering in between
+struct AILevelOfDetailSettings {
+	//Should cover the longest attack range, the weapons attack from the steering update
+	float fullDistance = 400.f;
+	//How far outside the window an enemy still counts as on screen
+	float screenMargin = 50.f;
+	unsigned int reducedInterval = 2;
+	unsigned int dormantInterval = 4;
+};
+
+//How many enemies are in each level of detail and how many of them steered last frame, with the time the whole steering step took
+struct AILevelOfDetailStatistics {
+	std::array<unsigned int, (unsigned int)AILevelOfDetail::Count> population = {};
+	std::array<unsigned int, (unsigned int)AILevelOfDetail::Count> steered = {};
+	float steeringMilliseconds = 0.f;
+};
+
 class EnemyManager : public ManagerBase {
 public:
 	EnemyManager();
@@ -22,6 +46,11 @@ public:
 
 	void Init() override;
 	void Update() override;
+	void UpdateLevelsOfDetail();
+	void FindSeparationNeighbours();
+	void FindNearestNeighbours(EnemyBase& enemy);
+	void UpdateSteering();
+	void SimulateEnemies();
 
 	void UpdateBossRush();
 	void UpdateSurvival();
@@ -34,6 +63,9 @@ public:
 
 	const std::vector<std::shared_ptr<FormationHandler>> GetFormationManagers() const;
 	const unsigned int GetWaveNumber() const;
+	const float GetNeighbourListRebuildRate() const;
+	const AILevelOfDetailStatistics& GetLevelOfDetailStatistics() const;
+	AILevelOfDetailSettings& GetLevelOfDetailSettings();
 
 	void CreateNewEnemy(const EnemyType& enemyType);
 
@@ -65,6 +97,35 @@ private:
 
 	std::unordered_map<EnemyType, std::shared_ptr<ObjectPool<std::shared_ptr<EnemyBase>>>> _enemyPools;
 
+	AILevelOfDetailSettings _levelOfDetailSettings;
+	AILevelOfDetailStatistics _levelOfDetailStatistics;
+	unsigned int _levelOfDetailFrame = 0;
+	//The enemies that steer this frame
+	std::vector<std::shared_ptr<EnemyBase>> _thinkingEnemies;
+
+	std::vector<NearestQuery> _neighbourQueries;
+	std::vector<QueryResultRange> _neighbourRanges;
+	std::vector<std::shared_ptr<ObjectBase>> _neighbourObjects;
+	std::vector<std::shared_ptr<ObjectBase>> _queryingEnemies;
+	std::vector<std::shared_ptr<EnemyBase>> _separatingEnemies;
+	std::vector<std::pair<float, unsigned int>> _neighbourDistances;
+	std::vector<std::shared_ptr<ObjectBase>> _nearestNeighbours;
+
+	//How far past its separation threshold every neighbour list reaches, a list is built again once something in it could have moved through half of it
+	float _neighbourListSkin = 8.f;
+	unsigned int _neighbourListsChecked = 0;
+	unsigned int _neighbourListsRebuilt = 0;
+
+	SteeringBatch _steeringBatch;
+	//Agents per steering job, a multiple of the widest steering lanes
+	unsigned int _steeringChunkSize = 64;
+	std::array<std::vector<std::shared_ptr<EnemyBase>>, (unsigned int)SteeringPipelineType::Count> _pipelineEnemies;
+	std::vector<std::shared_ptr<EnemyBase>> _batchedEnemies;
+
+	//Every active enemy in the order they are simulated and published
+	std::vector<std::shared_ptr<EnemyBase>> _simulatedEnemies;
+	unsigned int _simulationGrainSize = 128;
+
 	bool _spawnEnemy = false;
 
 	unsigned int _currentSpawnAmount = 0;
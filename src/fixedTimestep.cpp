@@ -0,0 +1,67 @@
+#include "fixedTimestep.h"
+
+#include <algorithm>
+
+FixedTimestep::FixedTimestep(const float& stepSeconds, const unsigned int& maxStepsPerFrame) :
+	_stepSeconds(stepSeconds), _maxStepsPerFrame(std::max(1u, maxStepsPerFrame)) {}
+
+//Called once per rendered frame before its steps run
+void FixedTimestep::AddFrameTime(const float& frameSeconds) {
+	_stepsThisFrame = 0;
+	_accumulator += std::max(0.f, frameSeconds);
+	const float maxAccumulator = _stepSeconds * _maxStepsPerFrame;
+	if (_accumulator > maxAccumulator) {
+		_droppedSeconds += _accumulator - maxAccumulator;
+		_accumulator = maxAccumulator;
+	}
+}
+
+//Whether another whole step fits in the time added, takes it from the accumulator if it does
+const bool FixedTimestep::ConsumeStep() {
+	if (_isFastForward) {
+		_stepsThisFrame++;
+		return true;
+	}
+	if (_accumulator < _stepSeconds) {
+		return false;
+	}
+	_accumulator -= _stepSeconds;
+	_stepsThisFrame++;
+	return true;
+}
+
+//Drops the time that was not simulated yet, so leaving fast-forward does not try to catch up
+void FixedTimestep::Reset() {
+	_accumulator = 0.f;
+	_stepsThisFrame = 0;
+}
+
+const bool FixedTimestep::GetIsFastForward() const {
+	return _isFastForward;
+}
+
+void FixedTimestep::SetFastForward(const bool& isFastForward) {
+	_isFastForward = isFastForward;
+	Reset();
+}
+
+const float FixedTimestep::GetStepSeconds() const {
+	return _stepSeconds;
+}
+
+//How far the rendered frame is between the state before the last step and the state after it, from 0 to 1
+const float FixedTimestep::GetInterpolation() const {
+	if (_isFastForward) {
+		return 1.f;
+	}
+	return std::min(1.f, _accumulator / _stepSeconds);
+}
+
+//The steps run since the frame's time was added
+const unsigned int FixedTimestep::GetStepsThisFrame() const {
+	return _stepsThisFrame;
+}
+
+const float FixedTimestep::GetDroppedSeconds() const {
+	return _droppedSeconds;
+}
@@ -0,0 +1,34 @@
+#pragma once
+
+/*Turns the time between rendered frames into simulation steps of one fixed length, so the simulation gives the same result whatever the frame rate.
+The time left over after the last whole step is the share of a step the rendering blends every object forward by.
+A frame never runs more than maxStepsPerFrame steps, the time past that is dropped so a slow frame cannot make the next one slower.
+In fast-forward the main loop runs steps back to back without rendering*/
+class FixedTimestep {
+public:
+	FixedTimestep(const float& stepSeconds, const unsigned int& maxStepsPerFrame);
+	~FixedTimestep() {}
+
+	void AddFrameTime(const float& frameSeconds);
+	const bool ConsumeStep();
+	void Reset();
+
+	const bool GetIsFastForward() const;
+	void SetFastForward(const bool& isFastForward);
+
+	const float GetStepSeconds() const;
+	const float GetInterpolation() const;
+	const unsigned int GetStepsThisFrame() const;
+	const float GetDroppedSeconds() const;
+
+private:
+	float _stepSeconds = 0.f;
+	float _accumulator = 0.f;
+	//Time that was dropped by the clamp since the game started
+	float _droppedSeconds = 0.f;
+
+	unsigned int _maxStepsPerFrame = 0;
+	unsigned int _stepsThisFrame = 0;
+
+	bool _isFastForward = false;
+};
@@ -0,0 +1,286 @@
+#include "flowField.h"
+
+#include "collision.h"
+#include "debugDrawer.h"
+#include "gameEngine.h"
+#include "objectBase.h"
+#include "spatialIndex.h"
+
+#include <algorithm>
+#include <cfloat>
+#include <chrono>
+#include <cmath>
+#include <functional>
+#include <queue>
+
+FlowField::FlowField(const AABB& boundary, const float& cellSize) {
+	_origin = boundary.GetMin();
+	_cellSize = cellSize;
+	_inverseCellSize = 1.f / cellSize;
+	_columns = std::max(1, (int)std::ceil(boundary.GetWidth() * _inverseCellSize));
+	_rows = std::max(1, (int)std::ceil(boundary.GetHeight() * _inverseCellSize));
+
+	const unsigned int cellCount = _columns * _rows;
+	_blocked.assign(cellCount, 0);
+	_goalVisible.assign(cellCount, 1);
+	_pathDistances.assign(cellCount, FLT_MAX);
+	_directions.assign(cellCount, { 0.f, 0.f });
+}
+
+//Rebuilds the field if the goal entered another cell or the obstacles changed since the last build
+void FlowField::Update(const Vector2<float>& goalPosition) {
+	const int goalCell = GetCell(goalPosition);
+	if (!_obstaclesChanged && goalCell == _goalCell) {
+		return;
+	}
+	const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	if (_obstaclesChanged) {
+		FindBlockedCells();
+		_obstaclesChanged = false;
+	}
+	_goalCell = goalCell;
+	_goalPosition = goalPosition;
+	if (_blockedCount == 0 || _goalCell < 0) {
+		return;
+	}
+	FindPathDistances();
+	FindDirections();
+	FindGoalVisibility();
+	_rebuildCount++;
+	_rebuildMilliseconds = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+void FlowField::SetObstaclesChanged() {
+	_obstaclesChanged = true;
+}
+
+/*The position an agent should steer toward to reach the goal, the goal itself if it can be seen from the agent's cell.
+Otherwise a point along the flow as far away as the path is long, so behaviours that slow down near their target still do so at the end of the path*/
+const Vector2<float> FlowField::GetWaypoint(const Vector2<float>& position, const Vector2<float>& goalPosition) const {
+	const int cell = GetCell(position);
+	if (cell < 0 || _goalCell < 0 || _blockedCount == 0 || _goalVisible[cell]) {
+		return goalPosition;
+	}
+	if (_blocked[cell]) {
+		return GetExitWaypoint(position, cell % _columns, cell / _columns, goalPosition);
+	}
+	if (_pathDistances[cell] == FLT_MAX) {
+		return goalPosition;
+	}
+	return position + _directions[cell] * _pathDistances[cell];
+}
+
+/*An agent pressed against an obstacle can stand in a blocked cell, and only its position tells which side of the obstacle it is on.
+It leaves toward the closest free neighbour the goal can be reached from, which lies on its own side*/
+const Vector2<float> FlowField::GetExitWaypoint(const Vector2<float>& position, const int& column, const int& row, const Vector2<float>& goalPosition) const {
+	float closestDistance = FLT_MAX;
+	Vector2<float> waypoint = goalPosition;
+	for (int rowOffset = -1; rowOffset <= 1; rowOffset++) {
+		for (int columnOffset = -1; columnOffset <= 1; columnOffset++) {
+			if (IsBlocked(column + columnOffset, row + rowOffset)) {
+				continue;
+			}
+			const int neighbour = (row + rowOffset) * _columns + column + columnOffset;
+			if (_pathDistances[neighbour] == FLT_MAX) {
+				continue;
+			}
+			const Vector2<float> toNeighbour = GetCellCenter(column + columnOffset, row + rowOffset) - position;
+			const float distance = toNeighbour.absolute();
+			if (distance < closestDistance && distance > 0.f) {
+				closestDistance = distance;
+				waypoint = position + toNeighbour * ((distance + _pathDistances[neighbour]) / distance);
+			}
+		}
+	}
+	return waypoint;
+}
+
+const unsigned int FlowField::GetRebuildCount() const {
+	return _rebuildCount;
+}
+
+const float FlowField::GetRebuildMilliseconds() const {
+	return _rebuildMilliseconds;
+}
+
+void FlowField::Render() {
+	for (int row = 0; row < _rows; row++) {
+		for (int column = 0; column < _columns; column++) {
+			const int cell = row * _columns + column;
+			const Vector2<float> center = GetCellCenter(column, row);
+			if (_blocked[cell]) {
+				debugDrawer->AddDebugCross(center, _cellSize * 0.5f, { 255, 0, 0, 255 });
+			} else if (_blockedCount > 0) {
+				debugDrawer->AddDebugLine(center, center + _directions[cell] * _cellSize * 0.4f, { 0, 255, 0, 255 });
+			}
+		}
+	}
+}
+
+//Every cell an obstacle overlaps is blocked, the agents are kept out of them by the path around
+void FlowField::FindBlockedCells() {
+	std::fill(_blocked.begin(), _blocked.end(), 0);
+	_blockedCount = 0;
+
+	std::shared_ptr<AABB> arena = std::make_shared<AABB>();
+	arena->Init(_origin + Vector2<float>(_columns * _cellSize, _rows * _cellSize) * 0.5f, _rows * _cellSize, _columns * _cellSize);
+	std::vector<std::shared_ptr<ObjectBase>> obstacles;
+	spatialIndex->Query(arena, obstacles, ToCollisionLayer(ObjectType::Obstacle));
+
+	for (unsigned int i = 0; i < obstacles.size(); i++) {
+		const std::shared_ptr<Collider> collider = obstacles[i]->GetCollider();
+		const Vector2<float> obstacleMin = collider->GetPosition() - collider->GetHalfExtents();
+		const Vector2<float> obstacleMax = collider->GetPosition() + collider->GetHalfExtents();
+		const int firstColumn = std::clamp((int)std::floor((obstacleMin.x - _origin.x) * _inverseCellSize), 0, _columns - 1);
+		const int lastColumn = std::clamp((int)std::floor((obstacleMax.x - _origin.x) * _inverseCellSize), 0, _columns - 1);
+		const int firstRow = std::clamp((int)std::floor((obstacleMin.y - _origin.y) * _inverseCellSize), 0, _rows - 1);
+		const int lastRow = std::clamp((int)std::floor((obstacleMax.y - _origin.y) * _inverseCellSize), 0, _rows - 1);
+		for (int row = firstRow; row <= lastRow; row++) {
+			for (int column = firstColumn; column <= lastColumn; column++) {
+				if (!_blocked[row * _columns + column]) {
+					_blocked[row * _columns + column] = 1;
+					_blockedCount++;
+				}
+			}
+		}
+	}
+}
+
+/*Dijkstra from the goal cell over the free cells, with diagonal steps only where neither side is blocked so no path cuts a corner.
+The goal cell is always the source, the player can stand close enough to a wall that its cell is blocked*/
+void FlowField::FindPathDistances() {
+	std::fill(_pathDistances.begin(), _pathDistances.end(), FLT_MAX);
+	using CellDistance = std::pair<float, int>;
+	std::priority_queue<CellDistance, std::vector<CellDistance>, std::greater<CellDistance>> openCells;
+	_pathDistances[_goalCell] = 0.f;
+	openCells.emplace(0.f, _goalCell);
+
+	const float diagonalCost = _cellSize * std::sqrt(2.f);
+	while (!openCells.empty()) {
+		const CellDistance current = openCells.top();
+		openCells.pop();
+		if (current.first > _pathDistances[current.second]) {
+			continue;
+		}
+		const int column = current.second % _columns;
+		const int row = current.second / _columns;
+		for (int rowOffset = -1; rowOffset <= 1; rowOffset++) {
+			for (int columnOffset = -1; columnOffset <= 1; columnOffset++) {
+				if ((rowOffset == 0 && columnOffset == 0) || IsBlocked(column + columnOffset, row + rowOffset)) {
+					continue;
+				}
+				const bool diagonal = rowOffset != 0 && columnOffset != 0;
+				if (diagonal && (IsBlocked(column + columnOffset, row) || IsBlocked(column, row + rowOffset))) {
+					continue;
+				}
+				const int neighbour = (row + rowOffset) * _columns + column + columnOffset;
+				const float distance = current.first + (diagonal ? diagonalCost : _cellSize);
+				if (distance < _pathDistances[neighbour]) {
+					_pathDistances[neighbour] = distance;
+					openCells.emplace(distance, neighbour);
+				}
+			}
+		}
+	}
+}
+
+//Every free cell points at the neighbour it can step to that is closest to the goal, only the goal cell among the blocked ones has a distance, the goal cell points at the goal itself
+void FlowField::FindDirections() {
+	for (int row = 0; row < _rows; row++) {
+		for (int column = 0; column < _columns; column++) {
+			const int cell = row * _columns + column;
+			_directions[cell] = { 0.f, 0.f };
+			if (_pathDistances[cell] == FLT_MAX) {
+				continue;
+			}
+			if (cell == _goalCell) {
+				const Vector2<float> toGoal = _goalPosition - GetCellCenter(column, row);
+				if (toGoal.absolute() > 0.f) {
+					_directions[cell] = toGoal.normalized();
+				}
+				continue;
+			}
+			float closestDistance = _pathDistances[cell];
+			for (int rowOffset = -1; rowOffset <= 1; rowOffset++) {
+				for (int columnOffset = -1; columnOffset <= 1; columnOffset++) {
+					const int neighbourColumn = column + columnOffset;
+					const int neighbourRow = row + rowOffset;
+					if (neighbourColumn < 0 || neighbourColumn >= _columns || neighbourRow < 0 || neighbourRow >= _rows) {
+						continue;
+					}
+					if (rowOffset != 0 && columnOffset != 0 && (IsBlocked(neighbourColumn, row) || IsBlocked(column, neighbourRow))) {
+						continue;
+					}
+					const int neighbour = neighbourRow * _columns + neighbourColumn;
+					if (_pathDistances[neighbour] < closestDistance) {
+						closestDistance = _pathDistances[neighbour];
+						_directions[cell] = Vector2<float>((float)columnOffset, (float)rowOffset).normalized();
+					}
+				}
+			}
+		}
+	}
+}
+
+void FlowField::FindGoalVisibility() {
+	for (int row = 0; row < _rows; row++) {
+		for (int column = 0; column < _columns; column++) {
+			_goalVisible[row * _columns + column] = IsGoalVisible(column, row);
+		}
+	}
+}
+
+//Walks the cells the line from the cell center to the goal passes through, the goal is hidden if any of them is blocked
+const bool FlowField::IsGoalVisible(const int& column, const int& row) const {
+	const int goalColumn = _goalCell % _columns;
+	const int goalRow = _goalCell / _columns;
+	const Vector2<float> delta = _goalPosition - GetCellCenter(column, row);
+	const int stepX = delta.x > 0.f ? 1 : -1;
+	const int stepY = delta.y > 0.f ? 1 : -1;
+	//Measured in fractions of the line, the center is half a cell away from the first border
+	const float crossX = delta.x != 0.f ? _cellSize / std::abs(delta.x) : FLT_MAX;
+	const float crossY = delta.y != 0.f ? _cellSize / std::abs(delta.y) : FLT_MAX;
+	float nextX = crossX * 0.5f;
+	float nextY = crossY * 0.5f;
+
+	int currentColumn = column;
+	int currentRow = row;
+	while (currentColumn != goalColumn || currentRow != goalRow) {
+		if (IsBlocked(currentColumn, currentRow)) {
+			return false;
+		}
+		//The line ends in this cell, only rounding kept the walk out of the goal cell
+		if (nextX > 1.f && nextY > 1.f) {
+			break;
+		}
+		if (nextX < nextY) {
+			currentColumn += stepX;
+			nextX += crossX;
+		} else {
+			currentRow += stepY;
+			nextY += crossY;
+		}
+	}
+	return true;
+}
+
+//Cells outside the grid count as blocked
+const bool FlowField::IsBlocked(const int& column, const int& row) const {
+	if (column < 0 || column >= _columns || row < 0 || row >= _rows) {
+		return true;
+	}
+	return _blocked[row * _columns + column];
+}
+
+const int FlowField::GetCell(const Vector2<float>& position) const {
+	const int column = (int)std::floor((position.x - _origin.x) * _inverseCellSize);
+	const int row = (int)std::floor((position.y - _origin.y) * _inverseCellSize);
+	if (column < 0 || column >= _columns || row < 0 || row >= _rows) {
+		return -1;
+	}
+	return row * _columns + column;
+}
+
+const Vector2<float> FlowField::GetCellCenter(const int& column, const int& row) const {
+	return _origin + Vector2<float>((column + 0.5f) * _cellSize, (row + 0.5f) * _cellSize);
+}
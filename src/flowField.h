@@ -0,0 +1,59 @@
+#pragma once
+#include "vector2.h"
+
+#include <vector>
+
+class AABB;
+
+/*A coarse grid over the arena that stores, for every cell, which way the shortest path around the obstacles leads to one goal.
+It is rebuilt with a single Dijkstra pass when the goal enters another cell or the obstacles change, every agent then reads its way in constant time.
+Without obstacles nothing is built and every agent keeps heading straight for the goal*/
+class FlowField {
+public:
+	FlowField(const AABB& boundary, const float& cellSize);
+	~FlowField() {}
+
+	void Update(const Vector2<float>& goalPosition);
+	void SetObstaclesChanged();
+
+	const Vector2<float> GetWaypoint(const Vector2<float>& position, const Vector2<float>& goalPosition) const;
+
+	const unsigned int GetRebuildCount() const;
+	const float GetRebuildMilliseconds() const;
+
+	void Render();
+
+private:
+	void FindBlockedCells();
+	void FindPathDistances();
+	void FindDirections();
+	void FindGoalVisibility();
+
+	const Vector2<float> GetExitWaypoint(const Vector2<float>& position, const int& column, const int& row, const Vector2<float>& goalPosition) const;
+	const bool IsGoalVisible(const int& column, const int& row) const;
+	const bool IsBlocked(const int& column, const int& row) const;
+	const int GetCell(const Vector2<float>& position) const;
+	const Vector2<float> GetCellCenter(const int& column, const int& row) const;
+
+	Vector2<float> _origin = { 0.f, 0.f };
+	Vector2<float> _goalPosition = { 0.f, 0.f };
+
+	float _cellSize = 0.f;
+	float _inverseCellSize = 0.f;
+	float _rebuildMilliseconds = 0.f;
+
+	int _columns = 0;
+	int _rows = 0;
+	int _goalCell = -1;
+
+	unsigned int _blockedCount = 0;
+	unsigned int _rebuildCount = 0;
+
+	bool _obstaclesChanged = true;
+
+	//One entry per cell, row by row
+	std::vector<unsigned char> _blocked;
+	std::vector<unsigned char> _goalVisible;
+	std::vector<float> _pathDistances;
+	std::vector<Vector2<float>> _directions;
+};
@@ -1,16 +1,26 @@
 #include "gameEngine.h"
 
+#include "boundingVolumeHierarchy.h"
+#include "broadPhase.h"
+#include "commandBuffer.h"
 #include "universalFunctions.h"
 #include "debugDrawer.h"
 #include "enemyBase.h"
 #include "enemyManager.h"
+#include "fixedTimestep.h"
+#include "flowField.h"
 #include "imGuiManager.h"
+#include "jobSystem.h"
+#include "layeredSpatialIndex.h"
+#include "linearQuadTree.h"
 #include "obstacleManager.h"
 #include "playerCharacter.h"
 #include "projectileManager.h"
 #include "quadTree.h"
 #include "searchSortAlgorithms.h"
 #include "rayCast.h"
+#include "renderBackend.h"
+#include "spatialHashGrid.h"
 #include "stateStack.h"
 #include "steeringBehavior.h"
 #include "timerHandler.h"
@@ -20,15 +30,18 @@
 SDL_Window* window;
 SDL_Renderer* renderer;
 
+std::shared_ptr<BroadPhase> broadPhase;
 std::shared_ptr<CollisionCheck> collisionCheck;
+std::shared_ptr<CommandBuffer> commandBuffer;
 std::shared_ptr<RayCast> rayCast;
 
 std::shared_ptr<DebugDrawer> debugDrawer;
+std::shared_ptr<FlowField> flowField;
+std::shared_ptr<FixedTimestep> fixedTimestep;
 std::shared_ptr<GameStateHandler> gameStateHandler;
 std::shared_ptr<ImGuiHandler> imGuiHandler;
-std::shared_ptr<QuadTree<std::shared_ptr<ObjectBase>>> objectBaseQuadTree;
-std::shared_ptr<QuadTree<std::shared_ptr<ObjectBase>>> obstacleQuadTree;
-std::shared_ptr<QuadTree<std::shared_ptr<ObjectBase>>> projectileQuadTree;
+std::shared_ptr<JobSystem> jobSystem;
+std::shared_ptr<SpatialIndex<std::shared_ptr<ObjectBase>>> spatialIndex;
 std::shared_ptr<SearchSortAlgorithms> searchSort;
 std::shared_ptr<UniversalFunctions> universalFunctions;
 
@@ -36,6 +49,7 @@ std::vector<std::shared_ptr<PlayerCharacter>> playerCharacters;
 std::shared_ptr<EnemyManager> enemyManager;
 std::shared_ptr<ObstacleManager> obstacleManager;
 std::shared_ptr<ProjectileManager> projectileManager;
+std::shared_ptr<RenderBackend> renderBackend;
 std::shared_ptr<TimerHandler> timerHandler;
 std::shared_ptr<WeaponManager> weaponManager;
 
@@ -73,13 +87,88 @@ bool GetKeyReleased(const SDL_Scancode& key) {
 	return !keys[key].state && keys[key].changeFrame == frameNumber;
 }
 
-void DrawText(SDL_Texture* textTexture, SDL_Rect* textSrcrect, SDL_Rect textDst) {
-	SDL_RenderCopy(renderer, textTexture, textSrcrect, &textDst);
+/*The quadtrees split once a node holds capacity objects and the bounding volume hierarchy uses capacity as its leaf size.
+The grid ignores capacity and uses cells of cellSize*/
+std::shared_ptr<SpatialIndex<std::shared_ptr<ObjectBase>>> CreateSpatialIndex(const SpatialIndexType& spatialIndexType, const std::shared_ptr<AABB>& boundary,
+	const unsigned int& capacity, const float& cellSize) {
+	QuadTreeNode quadTreeNode;
+	quadTreeNode.rectangle = boundary;
+	switch (spatialIndexType) {
+		case SpatialIndexType::QuadTree:
+			return std::make_shared<QuadTree<std::shared_ptr<ObjectBase>>>(quadTreeNode, capacity, QuadTreeType::Regular);
+		case SpatialIndexType::LooseQuadTree:
+			return std::make_shared<QuadTree<std::shared_ptr<ObjectBase>>>(quadTreeNode, capacity, QuadTreeType::Loose);
+		case SpatialIndexType::SpatialHashGrid:
+			return std::make_shared<SpatialHashGrid<std::shared_ptr<ObjectBase>>>(*boundary, cellSize);
+		case SpatialIndexType::BoundingVolumeHierarchy:
+			return std::make_shared<BoundingVolumeHierarchy<std::shared_ptr<ObjectBase>>>(capacity);
+		case SpatialIndexType::LinearQuadTree:
+			return std::make_shared<LinearQuadTree<std::shared_ptr<ObjectBase>>>(capacity);
+		default:
+			return nullptr;
+	}
 }
 
-void ClearText(SDL_Surface* textSurface, SDL_Texture* textTexture) {
-	SDL_FreeSurface(textSurface);
-	SDL_DestroyTexture(textTexture);
+/*Creates and initialises every system the simulation runs on, the windowed game and the headless runner share it.
+The renderBackend has to be set first, the sprites and texts made here get their sizes from it*/
+void InitSimulation(const unsigned int& workerCount) {
+	broadPhase = std::make_shared<BroadPhase>();
+	collisionCheck = std::make_shared<CollisionCheck>();
+	commandBuffer = std::make_shared<CommandBuffer>();
+	enemyManager = std::make_shared<EnemyManager>();
+	gameStateHandler = std::make_shared<GameStateHandler>();
+	debugDrawer = std::make_shared<DebugDrawer>();
+	fixedTimestep = std::make_shared<FixedTimestep>(1.f / 60.f, 5);
+	jobSystem = std::make_shared<JobSystem>();
+	obstacleManager = std::make_shared<ObstacleManager>();
+	projectileManager = std::make_shared<ProjectileManager>();
+	playerCharacters.emplace_back(std::make_shared<PlayerCharacter>(0.f, Vector2<float>(windowWidth * 0.5f, windowHeight * 0.5f)));
+	searchSort = std::make_shared<SearchSortAlgorithms>();
+	rayCast = std::make_shared<RayCast>();
+
+	timerHandler = std::make_shared<TimerHandler>();
+	universalFunctions = std::make_shared<UniversalFunctions>();
+	weaponManager = std::make_shared<WeaponManager>();
+
+	//Characters and weapons share one grid, projectiles get their own and the static obstacles sit in a bounding volume hierarchy
+	std::shared_ptr<AABB> spatialIndexBoundary = std::make_shared<AABB>();
+	spatialIndexBoundary->Init(Vector2(windowWidth * 0.5f, windowHeight * 0.5f), windowHeight, windowWidth);
+	std::shared_ptr<LayeredSpatialIndex<std::shared_ptr<ObjectBase>>> layeredSpatialIndex = std::make_shared<LayeredSpatialIndex<std::shared_ptr<ObjectBase>>>();
+	layeredSpatialIndex->AddPartition(ToCollisionLayer(ObjectType::Enemy) | ToCollisionLayer(ObjectType::Player) | ToCollisionLayer(ObjectType::Weapon),
+		CreateSpatialIndex(SpatialIndexType::SpatialHashGrid, spatialIndexBoundary, 100, 32.f));
+	layeredSpatialIndex->AddPartition(ToCollisionLayer(ObjectType::Projectile),
+		CreateSpatialIndex(SpatialIndexType::SpatialHashGrid, spatialIndexBoundary, 200, 32.f));
+	layeredSpatialIndex->AddPartition(ToCollisionLayer(ObjectType::Obstacle),
+		CreateSpatialIndex(SpatialIndexType::BoundingVolumeHierarchy, spatialIndexBoundary, 4, 64.f));
+	spatialIndex = layeredSpatialIndex;
+	flowField = std::make_shared<FlowField>(*spatialIndexBoundary, 32.f);
+
+	cursorPosition = universalFunctions->GetCursorPosition();
+	enemyManager->Init();
+	for (unsigned int i = 0; i < playerCharacters.size(); i++) {
+		playerCharacters[i]->Init();
+	}
+	jobSystem->Init(workerCount);
+	commandBuffer->Init(jobSystem->GetWorkerCount());
+	projectileManager->Init();
+	obstacleManager->Init();
+	weaponManager->Init();
+}
+
+//Every object that moves keeps where it was before the coming step, the obstacles never move
+void StorePreviousStates() {
+	for (auto& enemy : enemyManager->GetActiveObjects()) {
+		enemy.second->StorePreviousState();
+	}
+	for (auto& projectile : projectileManager->GetActiveObjects()) {
+		projectile.second->StorePreviousState();
+	}
+	for (auto& weapon : weaponManager->GetActiveObjects()) {
+		weapon.second->StorePreviousState();
+	}
+	for (unsigned int i = 0; i < playerCharacters.size(); i++) {
+		playerCharacters[i]->StorePreviousState();
+	}
 }
 
 const char* fontType = "res/roboto.ttf";
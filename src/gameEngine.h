@@ -12,28 +12,36 @@
 #define PI 3.14159265358979
 #define eulersNumber 2.71828
 
+class AABB;
+class BroadPhase;
 class Button;
 class CollisionCheck;
+class CommandBuffer;
 class DebugDrawer;
 class EnemyBase;
 class EnemyManager;
+class FixedTimestep;
+class FlowField;
 class GameStateHandler;
 class ImGuiHandler;
+class JobSystem;
 class ObjectBase;
 class ObstacleManager;
 class PlayerCharacter;
 class ProjectileManager;
 class SearchSortAlgorithms;
 class RayCast;
+class RenderBackend;
 class SteeringBehavior;
 class TimerHandler;
 class UniversalFunctions;
 class WeaponManager;
 
 enum class ButtonType;
+enum class SpatialIndexType;
 
 template<class T>
-class QuadTree;
+class SpatialIndex;
 
 template<class T>
 class Vector2;
@@ -41,19 +49,29 @@ class Vector2;
 extern SDL_Window* window;
 extern SDL_Renderer* renderer;
 
+extern std::shared_ptr<BroadPhase> broadPhase;
 extern std::shared_ptr<CollisionCheck> collisionCheck;
+//The damage, despawns and spawns of a tick, applied together at the end of it
+extern std::shared_ptr<CommandBuffer> commandBuffer;
 extern std::shared_ptr<EnemyManager> enemyManager;
 extern std::shared_ptr<DebugDrawer> debugDrawer;
+//The way around the obstacles toward the player, shared by every enemy
+extern std::shared_ptr<FlowField> flowField;
+//Splits the frame time into simulation steps of deltaTime and tells the rendering how far to blend past the last one
+extern std::shared_ptr<FixedTimestep> fixedTimestep;
 extern std::shared_ptr<GameStateHandler> gameStateHandler;
 extern std::shared_ptr<ImGuiHandler> imGuiHandler;
+//Runs work on every hardware thread, systems add the jobs of a frame to its frame graph
+extern std::shared_ptr<JobSystem> jobSystem;
 
 extern std::shared_ptr<ObstacleManager> obstacleManager;
 extern std::vector<std::shared_ptr<PlayerCharacter>> playerCharacters;
 extern std::shared_ptr<ProjectileManager> projectileManager;
+//Draws the game and loads its textures, SDL in the windowed game and nothing in the headless one
+extern std::shared_ptr<RenderBackend> renderBackend;
 
-extern std::shared_ptr<QuadTree<std::shared_ptr<ObjectBase>>> objectBaseQuadTree;
-extern std::shared_ptr<QuadTree<std::shared_ptr<ObjectBase>>> obstacleQuadTree;
-extern std::shared_ptr<QuadTree<std::shared_ptr<ObjectBase>>> projectileQuadTree;
+//Holds every object by its collision layer, each layer can use its own backend, see CreateSpatialIndex
+extern std::shared_ptr<SpatialIndex<std::shared_ptr<ObjectBase>>> spatialIndex;
 
 extern std::shared_ptr<SearchSortAlgorithms> searchSort;
 extern std::shared_ptr<RayCast> rayCast;
@@ -88,8 +106,11 @@ extern bool GetKey(const SDL_Scancode& key);
 extern bool GetKeyPressed(const SDL_Scancode& key);
 extern bool GetKeyReleased(const SDL_Scancode& key);
 
-void DrawText(SDL_Texture* textTexture, SDL_Rect* textSrcrect, SDL_Rect textDst);
-void ClearText(SDL_Surface* textSurface, SDL_Texture* textTexture);
+std::shared_ptr<SpatialIndex<std::shared_ptr<ObjectBase>>> CreateSpatialIndex(const SpatialIndexType& spatialIndexType, const std::shared_ptr<AABB>& boundary,
+	const unsigned int& capacity, const float& cellSize);
+
+void InitSimulation(const unsigned int& workerCount);
+void StorePreviousStates();
 
 extern const char* fontType;
 extern const char* gameTitle;
@@ -0,0 +1,243 @@
+#include "jobSystem.h"
+
+#include "gameEngine.h"
+
+#include <algorithm>
+
+//The worker a thread runs as, the main thread and any thread that is not a worker use queue 0
+thread_local unsigned int currentWorker = 0;
+//Jobs this thread is inside of, a job that waits runs other jobs and only the outermost one is timed
+thread_local unsigned int jobDepth = 0;
+
+std::shared_ptr<Job> JobGraph::AddJob(const std::function<void()>& work, const std::vector<std::shared_ptr<Job>>& dependencies) {
+	_jobs.emplace_back(jobSystem->Schedule(work, dependencies));
+	return _jobs.back();
+}
+
+void JobGraph::Wait() {
+	for (unsigned int i = 0; i < _jobs.size(); i++) {
+		jobSystem->Wait(_jobs[i]);
+	}
+}
+
+//Waits for the jobs first, a job may still be queued behind one of its dependencies
+void JobGraph::Clear() {
+	Wait();
+	_jobs.clear();
+}
+
+const unsigned int JobGraph::Size() const {
+	return _jobs.size();
+}
+
+JobSystem::~JobSystem() {
+	ShutDown();
+}
+
+//Starts one worker thread less than the hardware threads, the main thread is the last one
+void JobSystem::Init(const unsigned int& workerCount) {
+	const unsigned int queueCount = std::max(1u, workerCount);
+	for (unsigned int i = 0; i < queueCount; i++) {
+		_queues.emplace_back(std::make_shared<WorkerQueue>());
+	}
+	_workerUtilisation.assign(queueCount, 0.f);
+	_isRunning = true;
+	for (unsigned int i = 1; i < queueCount; i++) {
+		_threads.emplace_back(&JobSystem::WorkerLoop, this, i);
+	}
+	_frameStart = std::chrono::steady_clock::now();
+}
+
+void JobSystem::ShutDown() {
+	if (!_isRunning) {
+		return;
+	}
+	_frameGraph.Clear();
+	{
+		std::lock_guard<std::mutex> lock(_wakeMutex);
+		_isRunning = false;
+	}
+	_wakeCondition.notify_all();
+	for (unsigned int i = 0; i < _threads.size(); i++) {
+		_threads[i].join();
+	}
+	_threads.clear();
+}
+
+/*Queues the work once every dependency has finished, at once if there are none.
+The job holds one extra count while its dependencies are registered so it cannot start before all of them are*/
+std::shared_ptr<Job> JobSystem::Schedule(const std::function<void()>& work, const std::vector<std::shared_ptr<Job>>& dependencies) {
+	std::shared_ptr<Job> job = std::make_shared<Job>();
+	job->work = work;
+	job->unfinishedDependencies = 1;
+	for (unsigned int i = 0; i < dependencies.size(); i++) {
+		std::lock_guard<std::mutex> lock(dependencies[i]->dependentsMutex);
+		if (!dependencies[i]->isFinished) {
+			job->unfinishedDependencies++;
+			dependencies[i]->dependents.emplace_back(job);
+		}
+	}
+	if (--job->unfinishedDependencies == 0) {
+		Enqueue(job);
+	}
+	return job;
+}
+
+//Runs other jobs until the job has finished, so waiting on a worker cannot stall the jobs it waits for
+void JobSystem::Wait(const std::shared_ptr<Job>& job) {
+	while (!job->isFinished) {
+		if (!RunOneJob()) {
+			std::this_thread::yield();
+		}
+	}
+}
+
+/*Splits [0, count) into ranges of grainSize and runs them on every worker, returns when all of them are done.
+The calling thread runs ranges too, so it can be called from inside a job*/
+void JobSystem::ParallelFor(const unsigned int& count, const unsigned int& grainSize, const std::function<void(const unsigned int first, const unsigned int last)>& work) {
+	if (count == 0) {
+		return;
+	}
+	const unsigned int rangeSize = std::max(1u, grainSize);
+	const unsigned int rangeCount = (count + rangeSize - 1) / rangeSize;
+	if (rangeCount == 1) {
+		work(0, count);
+		return;
+	}
+	std::atomic<unsigned int> unfinishedRanges = rangeCount;
+	for (unsigned int i = 0; i < rangeCount; i++) {
+		const unsigned int first = i * rangeSize;
+		const unsigned int last = std::min(count, first + rangeSize);
+		Schedule([&work, &unfinishedRanges, first, last]() {
+			work(first, last);
+			unfinishedRanges--;
+		});
+	}
+	while (unfinishedRanges > 0) {
+		if (!RunOneJob()) {
+			std::this_thread::yield();
+		}
+	}
+}
+
+//Finishes the jobs of the last frame and turns the time every worker spent on jobs into its share of that frame
+void JobSystem::BeginFrame() {
+	_frameGraph.Clear();
+	const std::chrono::steady_clock::time_point frameEnd = std::chrono::steady_clock::now();
+	const long long frameNanoseconds = std::chrono::duration_cast<std::chrono::nanoseconds>(frameEnd - _frameStart).count();
+	for (unsigned int i = 0; i < _queues.size(); i++) {
+		const long long busyNanoseconds = _queues[i]->busyNanoseconds.exchange(0);
+		_workerUtilisation[i] = frameNanoseconds > 0 ? std::min(1.f, (float)busyNanoseconds / (float)frameNanoseconds) : 0.f;
+	}
+	_frameStart = frameEnd;
+}
+
+JobGraph& JobSystem::GetFrameGraph() {
+	return _frameGraph;
+}
+
+const unsigned int JobSystem::GetWorkerCount() const {
+	return _queues.size();
+}
+
+//Between 0 and 1 for every worker, worker 0 is the main thread and only counts the jobs it ran while waiting
+const std::vector<float>& JobSystem::GetWorkerUtilisation() const {
+	return _workerUtilisation;
+}
+
+//Sleeps while no job is queued anywhere
+void JobSystem::WorkerLoop(const unsigned int workerIndex) {
+	currentWorker = workerIndex;
+	while (_isRunning) {
+		if (RunOneJob()) {
+			continue;
+		}
+		std::unique_lock<std::mutex> lock(_wakeMutex);
+		_wakeCondition.wait(lock, [this]() {
+			return _queuedJobs > 0 || !_isRunning;
+		});
+	}
+}
+
+//A job goes to the queue of the thread that made it ready, the work it was made by is often still in that core's cache
+void JobSystem::Enqueue(const std::shared_ptr<Job>& job) {
+	WorkerQueue& queue = *_queues[GetCurrentWorker()];
+	{
+		std::lock_guard<std::mutex> lock(queue.mutex);
+		queue.jobs.emplace_back(job);
+	}
+	{
+		std::lock_guard<std::mutex> lock(_wakeMutex);
+		_queuedJobs++;
+	}
+	_wakeCondition.notify_one();
+}
+
+//The newest job of the worker's own queue, otherwise the oldest job of the first other worker that has one
+std::shared_ptr<Job> JobSystem::TakeJob(const unsigned int& workerIndex) {
+	std::shared_ptr<Job> job = nullptr;
+	{
+		WorkerQueue& queue = *_queues[workerIndex];
+		std::lock_guard<std::mutex> lock(queue.mutex);
+		if (!queue.jobs.empty()) {
+			job = queue.jobs.back();
+			queue.jobs.pop_back();
+		}
+	}
+	for (unsigned int i = 1; i < _queues.size() && !job; i++) {
+		WorkerQueue& queue = *_queues[(workerIndex + i) % _queues.size()];
+		std::lock_guard<std::mutex> lock(queue.mutex);
+		if (!queue.jobs.empty()) {
+			job = queue.jobs.front();
+			queue.jobs.pop_front();
+		}
+	}
+	if (job) {
+		_queuedJobs--;
+	}
+	return job;
+}
+
+bool JobSystem::RunOneJob() {
+	if (_queuedJobs == 0) {
+		return false;
+	}
+	const unsigned int workerIndex = GetCurrentWorker();
+	const std::shared_ptr<Job> job = TakeJob(workerIndex);
+	if (!job) {
+		return false;
+	}
+	Execute(job, workerIndex);
+	return true;
+}
+
+void JobSystem::Execute(const std::shared_ptr<Job>& job, const unsigned int& workerIndex) {
+	const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	jobDepth++;
+	job->work();
+	jobDepth--;
+	if (jobDepth == 0) {
+		_queues[workerIndex]->busyNanoseconds += std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+	}
+	Finish(job);
+}
+
+//Marks the job as finished and queues every dependent that no longer waits for anything
+void JobSystem::Finish(const std::shared_ptr<Job>& job) {
+	std::vector<std::shared_ptr<Job>> dependents;
+	{
+		std::lock_guard<std::mutex> lock(job->dependentsMutex);
+		job->isFinished = true;
+		dependents.swap(job->dependents);
+	}
+	for (unsigned int i = 0; i < dependents.size(); i++) {
+		if (--dependents[i]->unfinishedDependencies == 0) {
+			Enqueue(dependents[i]);
+		}
+	}
+}
+
+//The worker the calling thread runs as, every thread that is not a worker counts as the main thread
+const unsigned int JobSystem::GetCurrentWorker() const {
+	return currentWorker < _queues.size() ? currentWorker : 0;
+}
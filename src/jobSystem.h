@@ -0,0 +1,88 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/*One piece of work for the job system, it is queued once every job it depends on has finished.
+The dependents are only written under the mutex so a job can be added as a dependent while the one it waits for finishes*/
+struct Job {
+	std::function<void()> work;
+	std::atomic<unsigned int> unfinishedDependencies = 0;
+	std::atomic<bool> isFinished = false;
+
+	std::mutex dependentsMutex;
+	std::vector<std::shared_ptr<Job>> dependents;
+};
+
+//The jobs of one frame, they start as soon as they are added and their dependencies are done and are dropped when the next frame begins
+class JobGraph {
+public:
+	JobGraph() {}
+	~JobGraph() {}
+
+	std::shared_ptr<Job> AddJob(const std::function<void()>& work, const std::vector<std::shared_ptr<Job>>& dependencies = {});
+	void Wait();
+	void Clear();
+
+	const unsigned int Size() const;
+
+private:
+	std::vector<std::shared_ptr<Job>> _jobs;
+};
+
+/*Runs jobs on one worker thread per hardware thread, the main thread is worker 0 and runs jobs while it waits for them.
+Every worker takes the newest job from its own queue and steals the oldest job of another worker when its queue is empty*/
+class JobSystem {
+public:
+	JobSystem() {}
+	~JobSystem();
+
+	void Init(const unsigned int& workerCount = std::thread::hardware_concurrency());
+	void ShutDown();
+
+	std::shared_ptr<Job> Schedule(const std::function<void()>& work, const std::vector<std::shared_ptr<Job>>& dependencies = {});
+	void Wait(const std::shared_ptr<Job>& job);
+
+	void ParallelFor(const unsigned int& count, const unsigned int& grainSize, const std::function<void(const unsigned int first, const unsigned int last)>& work);
+
+	void BeginFrame();
+	JobGraph& GetFrameGraph();
+
+	const unsigned int GetWorkerCount() const;
+	const unsigned int GetCurrentWorker() const;
+	const std::vector<float>& GetWorkerUtilisation() const;
+
+private:
+	struct WorkerQueue {
+		std::mutex mutex;
+		std::deque<std::shared_ptr<Job>> jobs;
+		//Time spent running jobs since the frame began
+		std::atomic<long long> busyNanoseconds = 0;
+	};
+
+	void WorkerLoop(const unsigned int workerIndex);
+	void Enqueue(const std::shared_ptr<Job>& job);
+	std::shared_ptr<Job> TakeJob(const unsigned int& workerIndex);
+	bool RunOneJob();
+	void Execute(const std::shared_ptr<Job>& job, const unsigned int& workerIndex);
+	void Finish(const std::shared_ptr<Job>& job);
+
+	std::vector<std::shared_ptr<WorkerQueue>> _queues;
+	std::vector<std::thread> _threads;
+	std::vector<float> _workerUtilisation;
+
+	JobGraph _frameGraph;
+
+	std::mutex _wakeMutex;
+	std::condition_variable _wakeCondition;
+	std::atomic<unsigned int> _queuedJobs = 0;
+	std::atomic<bool> _isRunning = false;
+
+	std::chrono::steady_clock::time_point _frameStart;
+};
@@ -0,0 +1,215 @@
+#pragma once
+#include "collision.h"
+#include "spatialIndex.h"
+
+#include <algorithm>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+#include "gameEngine.h"
+#include "jobSystem.h"
+
+/*One index for every collision layer, made out of partitions that each own a set of layers and use the backend that suits them.
+An object is stored in the first partition that owns its layer, a query only visits the partitions that own a layer in its mask*/
+template<typename T>
+class LayeredSpatialIndex : public SpatialIndex<T> {
+public:
+	LayeredSpatialIndex() {}
+	~LayeredSpatialIndex();
+
+	void AddPartition(const unsigned int& layerMask, std::shared_ptr<SpatialIndex<T>> spatialIndex);
+
+	bool Insert(T object, std::shared_ptr<Collider> collider, const unsigned int& layer) override;
+	bool Remove(const T& object) override;
+	bool Update(const T& object, const std::shared_ptr<Collider>& collider, const unsigned int& layer) override;
+
+	void Query(const std::shared_ptr<Collider>& range, std::vector<T>& objectsFound, const unsigned int& layerMask) override;
+	void QueryNearest(const Vector2<float>& point, const unsigned int& k, const float& maxDistance, std::vector<T>& objectsFound, const unsigned int& layerMask) override;
+	const RayHit<T> RayQuery(const Ray& ray, const unsigned int& layerMask) override;
+
+	void Rebuild() override;
+	void Clear() override;
+	void Render() override;
+
+	const SpatialIndexType GetSpatialIndexType() const override;
+	const unsigned int GetNumberOfObjects() const override;
+
+	const unsigned int GetCandidatesTested() const override;
+	void ResetStatistics() override;
+
+	const std::shared_ptr<Collider> FindCollider(const T& object) const override;
+
+private:
+	struct Partition {
+		unsigned int layerMask = 0;
+		std::shared_ptr<SpatialIndex<T>> spatialIndex = nullptr;
+	};
+
+	int FindPartition(const unsigned int& layer) const;
+
+	std::vector<Partition> _partitions;
+	std::unordered_map<T, unsigned int> _objectPartitions;
+
+};
+template<typename T>
+inline LayeredSpatialIndex<T>::~LayeredSpatialIndex() {
+	Clear();
+}
+template<typename T>
+inline void LayeredSpatialIndex<T>::AddPartition(const unsigned int& layerMask, std::shared_ptr<SpatialIndex<T>> spatialIndex) {
+	Partition partition;
+	partition.layerMask = layerMask;
+	partition.spatialIndex = spatialIndex;
+	_partitions.emplace_back(partition);
+}
+template<typename T>
+inline bool LayeredSpatialIndex<T>::Insert(T object, std::shared_ptr<Collider> collider, const unsigned int& layer) {
+	if (_objectPartitions.contains(object)) {
+		return Update(object, collider, layer);
+	}
+	const int partitionIndex = FindPartition(layer);
+	if (partitionIndex < 0 || !_partitions[partitionIndex].spatialIndex->Insert(object, collider, layer)) {
+		return false;
+	}
+	_objectPartitions.insert(std::make_pair(object, partitionIndex));
+	return true;
+}
+template<typename T>
+inline bool LayeredSpatialIndex<T>::Remove(const T& object) {
+	auto objectPartition = _objectPartitions.find(object);
+	if (objectPartition == _objectPartitions.end()) {
+		return false;
+	}
+	_partitions[objectPartition->second].spatialIndex->Remove(object);
+	_objectPartitions.erase(objectPartition);
+	return true;
+}
+//Moves the object to another partition if its layer changed, otherwise the partition updates it in place
+template<typename T>
+inline bool LayeredSpatialIndex<T>::Update(const T& object, const std::shared_ptr<Collider>& collider, const unsigned int& layer) {
+	auto objectPartition = _objectPartitions.find(object);
+	if (objectPartition == _objectPartitions.end()) {
+		return Insert(object, collider, layer);
+	}
+	if ((_partitions[objectPartition->second].layerMask & layer) == 0) {
+		Remove(object);
+		return Insert(object, collider, layer);
+	}
+	if (!_partitions[objectPartition->second].spatialIndex->Update(object, collider, layer)) {
+		//The partition dropped the object because it left its bounds
+		_objectPartitions.erase(objectPartition);
+		return false;
+	}
+	return true;
+}
+template<typename T>
+inline void LayeredSpatialIndex<T>::Query(const std::shared_ptr<Collider>& range, std::vector<T>& objectsFound, const unsigned int& layerMask) {
+	this->_queriesMade++;
+	for (unsigned int i = 0; i < _partitions.size(); i++) {
+		if ((_partitions[i].layerMask & layerMask) != 0) {
+			_partitions[i].spatialIndex->Query(range, objectsFound, layerMask);
+		}
+	}
+}
+//Every partition returns its own k nearest, the k nearest of those are kept
+template<typename T>
+inline void LayeredSpatialIndex<T>::QueryNearest(const Vector2<float>& point, const unsigned int& k, const float& maxDistance, std::vector<T>& objectsFound, const unsigned int& layerMask) {
+	this->_queriesMade++;
+	thread_local std::vector<T> partitionNearest;
+	thread_local std::vector<typename SpatialIndex<T>::NearestCandidate> nearest;
+	nearest.clear();
+	for (unsigned int i = 0; i < _partitions.size(); i++) {
+		if ((_partitions[i].layerMask & layerMask) == 0) {
+			continue;
+		}
+		partitionNearest.clear();
+		_partitions[i].spatialIndex->QueryNearest(point, k, maxDistance, partitionNearest, layerMask);
+		for (unsigned int j = 0; j < partitionNearest.size(); j++) {
+			const Vector2<float> delta = _partitions[i].spatialIndex->FindCollider(partitionNearest[j])->GetPosition() - point;
+			SpatialIndex<T>::OfferNearest(nearest, k, delta.x * delta.x + delta.y * delta.y, partitionNearest[j]);
+		}
+	}
+	SpatialIndex<T>::AppendNearest(nearest, objectsFound);
+}
+//The ray is shortened to the closest hit so far, so the later partitions can stop early
+template<typename T>
+inline const RayHit<T> LayeredSpatialIndex<T>::RayQuery(const Ray& ray, const unsigned int& layerMask) {
+	this->_queriesMade++;
+	RayHit<T> rayHit;
+	Ray remainingRay = ray;
+	for (unsigned int i = 0; i < _partitions.size(); i++) {
+		if ((_partitions[i].layerMask & layerMask) == 0) {
+			continue;
+		}
+		const RayHit<T> partitionHit = _partitions[i].spatialIndex->RayQuery(remainingRay, layerMask);
+		if (partitionHit.hit) {
+			rayHit = partitionHit;
+			remainingRay.length = partitionHit.distance;
+		}
+	}
+	return rayHit;
+}
+//The partitions share nothing, so each one is rebuilt on its own worker
+template<typename T>
+inline void LayeredSpatialIndex<T>::Rebuild() {
+	jobSystem->ParallelFor(_partitions.size(), 1, [this](const unsigned int firstPartition, const unsigned int lastPartition) {
+		for (unsigned int i = firstPartition; i < lastPartition; i++) {
+			_partitions[i].spatialIndex->Rebuild();
+		}
+	});
+}
+template<typename T>
+inline void LayeredSpatialIndex<T>::Clear() {
+	for (unsigned int i = 0; i < _partitions.size(); i++) {
+		_partitions[i].spatialIndex->Clear();
+	}
+	_objectPartitions.clear();
+}
+template<typename T>
+inline void LayeredSpatialIndex<T>::Render() {
+	for (unsigned int i = 0; i < _partitions.size(); i++) {
+		_partitions[i].spatialIndex->Render();
+	}
+}
+template<typename T>
+inline const SpatialIndexType LayeredSpatialIndex<T>::GetSpatialIndexType() const {
+	return SpatialIndexType::Layered;
+}
+template<typename T>
+inline const unsigned int LayeredSpatialIndex<T>::GetNumberOfObjects() const {
+	return _objectPartitions.size();
+}
+//The candidates are counted by the partitions, the queries are counted once for the whole index
+template<typename T>
+inline const unsigned int LayeredSpatialIndex<T>::GetCandidatesTested() const {
+	unsigned int candidatesTested = 0;
+	for (unsigned int i = 0; i < _partitions.size(); i++) {
+		candidatesTested += _partitions[i].spatialIndex->GetCandidatesTested();
+	}
+	return candidatesTested;
+}
+template<typename T>
+inline void LayeredSpatialIndex<T>::ResetStatistics() {
+	for (unsigned int i = 0; i < _partitions.size(); i++) {
+		_partitions[i].spatialIndex->ResetStatistics();
+	}
+	SpatialIndex<T>::ResetStatistics();
+}
+template<typename T>
+inline const std::shared_ptr<Collider> LayeredSpatialIndex<T>::FindCollider(const T& object) const {
+	auto objectPartition = _objectPartitions.find(object);
+	if (objectPartition == _objectPartitions.end()) {
+		return nullptr;
+	}
+	return _partitions[objectPartition->second].spatialIndex->FindCollider(object);
+}
+template<typename T>
+inline int LayeredSpatialIndex<T>::FindPartition(const unsigned int& layer) const {
+	for (unsigned int i = 0; i < _partitions.size(); i++) {
+		if ((_partitions[i].layerMask & layer) != 0) {
+			return i;
+		}
+	}
+	return -1;
+}
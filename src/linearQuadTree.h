@@ -0,0 +1,367 @@
+#pragma once
+#include "collision.h"
+#include "collisionKernels.h"
+#include "spatialIndex.h"
+#include "vector2.h"
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+#include "debugDrawer.h"
+#include "gameEngine.h"
+#include "jobSystem.h"
+
+/*Quadtree without node objects, the entries are sorted by the Morton code of their centre so every node is a contiguous range of them.
+The sorted entries are kept as separate arrays of bounds, layers and payload indices, so a leaf is tested with one batch kernel.
+Inserted or moved objects are sorted in by the next Rebuild, removed objects are masked out right away*/
+template<typename T>
+class LinearQuadTree : public SpatialIndex<T> {
+public:
+	LinearQuadTree(const unsigned int& leafSize);
+	~LinearQuadTree();
+
+	bool Insert(T object, std::shared_ptr<Collider> collider, const unsigned int& layer) override;
+	bool Remove(const T& object) override;
+	bool Update(const T& object, const std::shared_ptr<Collider>& collider, const unsigned int& layer) override;
+
+	void Query(const std::shared_ptr<Collider>& range, std::vector<T>& objectsFound, const unsigned int& layerMask) override;
+
+	template<typename Visitor>
+	void Visit(const Collider& range, const unsigned int& layerMask, Visitor&& visitor);
+
+	void Rebuild() override;
+	void Clear() override;
+	void Render() override;
+
+	const SpatialIndexType GetSpatialIndexType() const override;
+	const unsigned int GetNumberOfObjects() const override;
+
+	const std::shared_ptr<Collider> FindCollider(const T& object) const override;
+
+private:
+	//A node is the range of sorted entries whose Morton code starts with its prefix, its bounds are carried down from the parent
+	struct NodeRange {
+		unsigned int level = 0;
+		uint32_t prefix = 0;
+		unsigned int firstEntry = 0;
+		unsigned int lastEntry = 0;
+		Vector2<float> min = { 0.f, 0.f };
+		Vector2<float> size = { 0.f, 0.f };
+	};
+
+	struct SortKey {
+		uint32_t mortonCode = 0;
+		unsigned int payloadIndex = 0;
+	};
+
+	static uint32_t SpreadBits(uint32_t value);
+	const uint32_t GetMortonCode(const Vector2<float>& position) const;
+	const unsigned int FindFirstEntry(const unsigned int firstEntry, const unsigned int lastEntry, const uint32_t mortonCode) const;
+
+	template<typename NodeVisitor>
+	void VisitNodes(const Vector2<float>& rangeMin, const Vector2<float>& rangeMax, NodeVisitor&& nodeVisitor) const;
+
+	//16 bits per axis fill a 32 bit Morton code
+	static constexpr unsigned int _maxLevel = 16;
+	static constexpr unsigned int _maxStackSize = 3 * _maxLevel + 1;
+
+	unsigned int _leafSize = 8;
+
+	//Bounds of every centre at the last rebuild, the Morton codes are measured inside them
+	Vector2<float> _min = { 0.f, 0.f };
+	Vector2<float> _max = { 0.f, 0.f };
+	Vector2<float> _cellsPerUnit = { 0.f, 0.f };
+	//Largest half extents of any entry, every node is grown by them so colliders that reach out of their node are still found
+	Vector2<float> _maxHalfExtents = { 0.f, 0.f };
+
+	//Sorted entries, one array per field
+	std::vector<uint32_t> _mortonCodes;
+	BoxColliders _bounds;
+	std::vector<unsigned int> _layers;
+	std::vector<unsigned int> _payloadIndices;
+
+	//Payload in insertion order, with where each entry ended up in the sorted arrays
+	std::vector<T> _objects;
+	std::vector<std::shared_ptr<Collider>> _colliders;
+	std::vector<unsigned int> _objectLayers;
+	std::vector<int> _sortedIndices;
+	std::vector<unsigned int> _freeEntries;
+	std::unordered_map<T, unsigned int> _entryIndices;
+
+	//The keys are sorted in runs of this size on the workers, then the runs are merged in pairs through _mergedSortKeys
+	static constexpr unsigned int _sortRunSize = 1024;
+	std::vector<SortKey> _sortKeys;
+	std::vector<SortKey> _mergedSortKeys;
+
+	SDL_Color _quadTreeColor = { 255, 0, 125, 255 };
+
+};
+template<typename T>
+inline LinearQuadTree<T>::LinearQuadTree(const unsigned int& leafSize) {
+	_leafSize = std::max(1u, leafSize);
+}
+template<typename T>
+inline LinearQuadTree<T>::~LinearQuadTree() {
+	Clear();
+}
+template<typename T>
+inline bool LinearQuadTree<T>::Insert(T object, std::shared_ptr<Collider> collider, const unsigned int& layer) {
+	if (_entryIndices.contains(object)) {
+		return Update(object, collider, layer);
+	}
+	unsigned int payloadIndex = 0;
+	if (_freeEntries.empty()) {
+		payloadIndex = _objects.size();
+		_objects.emplace_back();
+		_colliders.emplace_back();
+		_objectLayers.emplace_back();
+		_sortedIndices.emplace_back();
+	} else {
+		payloadIndex = _freeEntries.back();
+		_freeEntries.pop_back();
+	}
+	_objects[payloadIndex] = object;
+	_colliders[payloadIndex] = collider;
+	_objectLayers[payloadIndex] = layer;
+	_sortedIndices[payloadIndex] = -1;
+	_entryIndices.insert(std::make_pair(object, payloadIndex));
+	return true;
+}
+//The sorted entry keeps its place until the next rebuild, its layer is cleared so no mask matches it
+template<typename T>
+inline bool LinearQuadTree<T>::Remove(const T& object) {
+	auto entry = _entryIndices.find(object);
+	if (entry == _entryIndices.end()) {
+		return false;
+	}
+	const unsigned int payloadIndex = entry->second;
+	_entryIndices.erase(entry);
+	if (_sortedIndices[payloadIndex] >= 0) {
+		_layers[_sortedIndices[payloadIndex]] = 0;
+	}
+	_objects[payloadIndex] = T();
+	_colliders[payloadIndex] = nullptr;
+	_objectLayers[payloadIndex] = 0;
+	_sortedIndices[payloadIndex] = -1;
+	_freeEntries.emplace_back(payloadIndex);
+	return true;
+}
+//A new layer is used right away, a new position once the tree is rebuilt
+template<typename T>
+inline bool LinearQuadTree<T>::Update(const T& object, const std::shared_ptr<Collider>& collider, const unsigned int& layer) {
+	auto entry = _entryIndices.find(object);
+	if (entry == _entryIndices.end()) {
+		return Insert(object, collider, layer);
+	}
+	const unsigned int payloadIndex = entry->second;
+	_colliders[payloadIndex] = collider;
+	_objectLayers[payloadIndex] = layer;
+	if (_sortedIndices[payloadIndex] >= 0) {
+		_layers[_sortedIndices[payloadIndex]] = layer;
+	}
+	return true;
+}
+//Appends the objects the collider hit to objectsFound, the caller owns the buffer so it can be reused every frame
+template<typename T>
+inline void LinearQuadTree<T>::Query(const std::shared_ptr<Collider>& range, std::vector<T>& objectsFound, const unsigned int& layerMask) {
+	Visit(*range, layerMask, [&objectsFound](const T& object) {
+		objectsFound.emplace_back(object);
+	});
+}
+/*Calls the visitor once for every object the collider hit.
+The bounds of a leaf's entries are tested against the range's bounds with the batch kernel, only the entries it hits have their collider read*/
+template<typename T>
+template<typename Visitor>
+inline void LinearQuadTree<T>::Visit(const Collider& range, const unsigned int& layerMask, Visitor&& visitor) {
+	thread_local std::vector<unsigned int> hits;
+	unsigned int candidatesTested = 0;
+	const Vector2<float> halfExtents = range.GetHalfExtents();
+	const Vector2<float> rangeMin = range.GetPosition() - halfExtents;
+	const Vector2<float> rangeMax = range.GetPosition() + halfExtents;
+	const BoxShape rangeBounds = { rangeMin.x, rangeMin.y, rangeMax.x, rangeMax.y };
+	VisitNodes(rangeMin, rangeMax, [&](const NodeRange& nodeRange) {
+		hits.clear();
+		IntersectBatch(rangeBounds, _bounds, nodeRange.firstEntry, nodeRange.lastEntry, hits);
+		for (unsigned int j = 0; j < hits.size(); j++) {
+			const unsigned int i = hits[j];
+			if ((_layers[i] & layerMask) == 0) {
+				continue;
+			}
+			candidatesTested++;
+			const unsigned int payloadIndex = _payloadIndices[i];
+			if (ColliderIntersect(range, *_colliders[payloadIndex])) {
+				visitor(_objects[payloadIndex]);
+			}
+		}
+	});
+	this->_candidatesTested += candidatesTested;
+	this->_queriesMade++;
+}
+/*Reads every stored collider, computes the Morton codes in parallel, sorts them and writes the sorted arrays.
+The codes are measured inside the bounds of the centres, so every centre lies inside the node its code belongs to*/
+template<typename T>
+inline void LinearQuadTree<T>::Rebuild() {
+	_sortKeys.clear();
+	_min = { 0.f, 0.f };
+	_max = { 0.f, 0.f };
+	_maxHalfExtents = { 0.f, 0.f };
+	bool firstEntry = true;
+	for (unsigned int i = 0; i < _colliders.size(); i++) {
+		if (!_colliders[i]) {
+			continue;
+		}
+		const Vector2<float> position = _colliders[i]->GetPosition();
+		const Vector2<float> halfExtents = _colliders[i]->GetHalfExtents();
+		if (firstEntry) {
+			_min = position;
+			_max = position;
+			firstEntry = false;
+		}
+		_min = { std::min(_min.x, position.x), std::min(_min.y, position.y) };
+		_max = { std::max(_max.x, position.x), std::max(_max.y, position.y) };
+		_maxHalfExtents = { std::max(_maxHalfExtents.x, halfExtents.x), std::max(_maxHalfExtents.y, halfExtents.y) };
+		SortKey sortKey;
+		sortKey.payloadIndex = i;
+		_sortKeys.emplace_back(sortKey);
+	}
+	//Every code has to stay below the top cell, so the bounds are made a little larger than the centres
+	const float cellCount = (float)(1u << _maxLevel);
+	_cellsPerUnit = { (cellCount - 1.f) / std::max(_max.x - _min.x, 1.f), (cellCount - 1.f) / std::max(_max.y - _min.y, 1.f) };
+
+	//No two keys are equal, so the merged runs come out in the same order one sort of every key would give
+	auto isBefore = [](const SortKey& sortKeyA, const SortKey& sortKeyB) {
+		return sortKeyA.mortonCode < sortKeyB.mortonCode || (sortKeyA.mortonCode == sortKeyB.mortonCode && sortKeyA.payloadIndex < sortKeyB.payloadIndex);
+	};
+	const unsigned int sortKeyCount = _sortKeys.size();
+	jobSystem->ParallelFor(sortKeyCount, _sortRunSize, [this, &isBefore](const unsigned int firstKey, const unsigned int lastKey) {
+		for (unsigned int i = firstKey; i < lastKey; i++) {
+			_sortKeys[i].mortonCode = GetMortonCode(_colliders[_sortKeys[i].payloadIndex]->GetPosition());
+		}
+		std::sort(_sortKeys.begin() + firstKey, _sortKeys.begin() + lastKey, isBefore);
+	});
+	_mergedSortKeys.resize(sortKeyCount);
+	for (unsigned int runSize = _sortRunSize; runSize < sortKeyCount; runSize *= 2) {
+		jobSystem->ParallelFor(sortKeyCount, runSize * 2, [this, &isBefore, runSize](const unsigned int firstKey, const unsigned int lastKey) {
+			const unsigned int middleKey = std::min(firstKey + runSize, lastKey);
+			std::merge(_sortKeys.begin() + firstKey, _sortKeys.begin() + middleKey, _sortKeys.begin() + middleKey, _sortKeys.begin() + lastKey,
+				_mergedSortKeys.begin() + firstKey, isBefore);
+		});
+		_sortKeys.swap(_mergedSortKeys);
+	}
+
+	const unsigned int entryCount = _sortKeys.size();
+	_mortonCodes.resize(entryCount);
+	_bounds.Resize(entryCount);
+	_layers.resize(entryCount);
+	_payloadIndices.resize(entryCount);
+	for (unsigned int i = 0; i < entryCount; i++) {
+		const unsigned int payloadIndex = _sortKeys[i].payloadIndex;
+		const Vector2<float> position = _colliders[payloadIndex]->GetPosition();
+		const Vector2<float> halfExtents = _colliders[payloadIndex]->GetHalfExtents();
+		_mortonCodes[i] = _sortKeys[i].mortonCode;
+		_bounds.Set(i, { position.x - halfExtents.x, position.y - halfExtents.y, position.x + halfExtents.x, position.y + halfExtents.y });
+		_layers[i] = _objectLayers[payloadIndex];
+		_payloadIndices[i] = payloadIndex;
+		_sortedIndices[payloadIndex] = i;
+	}
+}
+template<typename T>
+inline void LinearQuadTree<T>::Clear() {
+	_mortonCodes.clear();
+	_bounds.Clear();
+	_layers.clear();
+	_payloadIndices.clear();
+	_objects.clear();
+	_colliders.clear();
+	_objectLayers.clear();
+	_sortedIndices.clear();
+	_freeEntries.clear();
+	_entryIndices.clear();
+	_sortKeys.clear();
+	_mergedSortKeys.clear();
+}
+//Draws every leaf that holds entries
+template<typename T>
+inline void LinearQuadTree<T>::Render() {
+	VisitNodes(_min - _maxHalfExtents, _max + _maxHalfExtents, [&](const NodeRange& nodeRange) {
+		debugDrawer->AddDebugRectangle(nodeRange.min + nodeRange.size * 0.5f, nodeRange.min, nodeRange.min + nodeRange.size, _quadTreeColor, false);
+	});
+}
+template<typename T>
+inline const SpatialIndexType LinearQuadTree<T>::GetSpatialIndexType() const {
+	return SpatialIndexType::LinearQuadTree;
+}
+template<typename T>
+inline const unsigned int LinearQuadTree<T>::GetNumberOfObjects() const {
+	return _entryIndices.size();
+}
+template<typename T>
+inline const std::shared_ptr<Collider> LinearQuadTree<T>::FindCollider(const T& object) const {
+	auto entry = _entryIndices.find(object);
+	if (entry == _entryIndices.end()) {
+		return nullptr;
+	}
+	return _colliders[entry->second];
+}
+//Moves the low 16 bits of the value to the even bits, so two spread values interleave into one Morton code
+template<typename T>
+inline uint32_t LinearQuadTree<T>::SpreadBits(uint32_t value) {
+	value &= 0x0000ffff;
+	value = (value | (value << 8)) & 0x00ff00ff;
+	value = (value | (value << 4)) & 0x0f0f0f0f;
+	value = (value | (value << 2)) & 0x33333333;
+	value = (value | (value << 1)) & 0x55555555;
+	return value;
+}
+template<typename T>
+inline const uint32_t LinearQuadTree<T>::GetMortonCode(const Vector2<float>& position) const {
+	const uint32_t column = (uint32_t)std::clamp((position.x - _min.x) * _cellsPerUnit.x, 0.f, (float)((1u << _maxLevel) - 1));
+	const uint32_t row = (uint32_t)std::clamp((position.y - _min.y) * _cellsPerUnit.y, 0.f, (float)((1u << _maxLevel) - 1));
+	return SpreadBits(column) | (SpreadBits(row) << 1);
+}
+template<typename T>
+inline const unsigned int LinearQuadTree<T>::FindFirstEntry(const unsigned int firstEntry, const unsigned int lastEntry, const uint32_t mortonCode) const {
+	return std::lower_bound(_mortonCodes.begin() + firstEntry, _mortonCodes.begin() + lastEntry, mortonCode) - _mortonCodes.begin();
+}
+/*Walks the implicit nodes that overlap the range and calls the node visitor on every leaf.
+A node is a leaf once it holds no more than the leaf size or reaches the deepest level, its children are found by binary search in its range*/
+template<typename T>
+template<typename NodeVisitor>
+inline void LinearQuadTree<T>::VisitNodes(const Vector2<float>& rangeMin, const Vector2<float>& rangeMax, NodeVisitor&& nodeVisitor) const {
+	if (_mortonCodes.empty()) {
+		return;
+	}
+	//The root spans every code, one cell on the deepest level is one code step wide
+	const float rootCells = (float)(1u << _maxLevel);
+	std::array<NodeRange, _maxStackSize> nodeStack;
+	unsigned int stackSize = 0;
+	nodeStack[stackSize++] = NodeRange{ 0, 0, 0, (unsigned int)_mortonCodes.size(), _min, { rootCells / _cellsPerUnit.x, rootCells / _cellsPerUnit.y } };
+	while (stackSize > 0) {
+		const NodeRange nodeRange = nodeStack[--stackSize];
+		if (nodeRange.min.x - _maxHalfExtents.x > rangeMax.x || nodeRange.min.x + nodeRange.size.x + _maxHalfExtents.x < rangeMin.x ||
+			nodeRange.min.y - _maxHalfExtents.y > rangeMax.y || nodeRange.min.y + nodeRange.size.y + _maxHalfExtents.y < rangeMin.y) {
+			continue;
+		}
+		if (nodeRange.lastEntry - nodeRange.firstEntry <= _leafSize || nodeRange.level == _maxLevel) {
+			nodeVisitor(nodeRange);
+			continue;
+		}
+		//The low bit of a child picks the right half, the high bit the lower half
+		const unsigned int childShift = 2 * (_maxLevel - nodeRange.level - 1);
+		const Vector2<float> childSize = nodeRange.size * 0.5f;
+		unsigned int childFirstEntry = nodeRange.firstEntry;
+		for (uint32_t child = 0; child < 4; child++) {
+			const uint32_t childPrefix = (nodeRange.prefix << 2) | child;
+			const unsigned int childLastEntry = child == 3 ? nodeRange.lastEntry :
+				FindFirstEntry(childFirstEntry, nodeRange.lastEntry, (childPrefix + 1) << childShift);
+			if (childLastEntry > childFirstEntry) {
+				const Vector2<float> childMin = { nodeRange.min.x + (child & 1u) * childSize.x, nodeRange.min.y + (child >> 1) * childSize.y };
+				nodeStack[stackSize++] = NodeRange{ nodeRange.level + 1, childPrefix, childFirstEntry, childLastEntry, childMin, childSize };
+			}
+			childFirstEntry = childLastEntry;
+		}
+	}
+}
@@ -1,13 +1,13 @@
 #include "managerBase.h"
+#include "gameEngine.h"
 #include "objectBase.h"
-#include "quadTree.h"
+#include "spatialIndex.h"
 
 ManagerBase::ManagerBase() {}
 
 void ManagerBase::Update() {
 	for (auto& obstacle : _activeObjects) {
 		obstacle.second->Update();
-		obstacle.second->QueryObjects();
 	}
 }
 
@@ -23,15 +23,24 @@ void ManagerBase::RenderText() {
 	}
 }
 
-void ManagerBase::InsertObjectsQuadtree() {
+/*Adds the new objects to the spatial index and takes out the ones with an inactive collider.
+Objects already in the index are moved by its rebuild once every manager is done*/
+void ManagerBase::SyncSpatialIndex() {
 	for (auto& object : _activeObjects) {
 		if (!object.second->GetCollider()->GetIsActive()) {
+			spatialIndex->Remove(object.second);
 			continue;
 		}
-		objectBaseQuadTree->Insert(object.second, object.second->GetCollider());
+		if (!spatialIndex->FindCollider(object.second)) {
+			spatialIndex->Insert(object.second, object.second->GetCollider(), object.second->GetCollisionLayer());
+		}
 	}
 }
 
 void ManagerBase::Reset() {
 	RemoveAllObjects();
 }
+
+const std::unordered_map<unsigned int, std::shared_ptr<ObjectBase>>& ManagerBase::GetActiveObjects() const {
+	return _activeObjects;
+}
@@ -39,6 +39,8 @@ struct BehaviorData {
 	float separationThreshold = 0.f;
 	float attractionThreshold = 0.f;
 	float decayCoefficient = 0.f;
+	//0 uses every object found by the broad phase
+	unsigned int maxSeparationNeighbours = 0;
 
 	//wander data
 	float wanderOffset = 0.f;
@@ -57,14 +59,15 @@ public:
 	virtual void Render();
 	virtual void RenderText();
 	
-	virtual void InsertObjectsQuadtree();
+	virtual void SyncSpatialIndex();
 	virtual void RemoveAllObjects() {}
 	virtual void RemoveObject(const unsigned int& objectID) {}
 	virtual void Reset();
 
+	const std::unordered_map<unsigned int, std::shared_ptr<ObjectBase>>& GetActiveObjects() const;
+
 protected:
 	std::unordered_map<unsigned int, std::shared_ptr<ObjectBase>> _activeObjects;
-	std::vector<std::shared_ptr<ObjectBase>> _removeObjects;
 
 	unsigned int _objectAmountLimit = 3000;
 };
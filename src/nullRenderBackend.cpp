@@ -0,0 +1,38 @@
+#include "nullRenderBackend.h"
+
+#include <cstring>
+#include <fstream>
+
+/*A PNG starts with an 8 byte signature and then the IHDR chunk, its width and height are big endian and 16 and 20 bytes into the file.
+A file that cannot be read gets no size, like a texture SDL_image fails to load*/
+const RenderTexture NullRenderBackend::LoadTexture(const char* path) {
+	RenderTexture texture;
+	std::ifstream file(path, std::ios::binary);
+	unsigned char header[24] = {};
+	if (!file.read((char*)header, sizeof(header)) || std::memcmp(header + 12, "IHDR", 4) != 0) {
+		return texture;
+	}
+	texture.width = (header[16] << 24) | (header[17] << 16) | (header[18] << 8) | header[19];
+	texture.height = (header[20] << 24) | (header[21] << 16) | (header[22] << 8) | header[23];
+	return texture;
+}
+
+//Roughly half the font size per character and the font size in height, the text is never drawn so it only has to be close
+const RenderTexture NullRenderBackend::CreateTextTexture(const char*, const int& fontSize, const char* text, const SDL_Color&) {
+	RenderTexture texture;
+	texture.width = (int)std::strlen(text) * fontSize / 2;
+	texture.height = fontSize;
+	return texture;
+}
+
+void NullRenderBackend::DestroyTexture(RenderTexture& texture) {
+	texture = RenderTexture();
+}
+
+const Vector2<float> NullRenderBackend::GetCursorPosition() {
+	return _cursorPosition;
+}
+
+void NullRenderBackend::SetCursorPosition(const Vector2<float>& cursorPosition) {
+	_cursorPosition = cursorPosition;
+}
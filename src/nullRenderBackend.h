@@ -0,0 +1,32 @@
+#pragma once
+#include "renderBackend.h"
+
+/*Draws nothing and keeps no pixels, for running the simulation without a window.
+A texture only gets the size stored in its PNG header and a text texture the size its font would roughly give it.
+The cursor stays where it was last set*/
+class NullRenderBackend : public RenderBackend {
+public:
+	NullRenderBackend() {}
+	~NullRenderBackend() {}
+
+	const RenderTexture LoadTexture(const char* path) override;
+	const RenderTexture CreateTextTexture(const char* fontType, const int& fontSize, const char* text, const SDL_Color& color) override;
+	void DestroyTexture(RenderTexture& texture) override;
+
+	void DrawTexture(const RenderTexture&, const SDL_Rect*, const SDL_FRect&) override {}
+	void DrawTextureRotated(const RenderTexture&, const SDL_Rect*, const SDL_FRect&, const float&, const SDL_FPoint&) override {}
+
+	void SetDrawColor(const SDL_Color&) override {}
+	void FillRectangle(const SDL_FRect&) override {}
+	void DrawRectangle(const SDL_FRect&) override {}
+	void DrawLine(const Vector2<float>&, const Vector2<float>&) override {}
+
+	void Clear(const SDL_Color&) override {}
+	void Present() override {}
+
+	const Vector2<float> GetCursorPosition() override;
+	void SetCursorPosition(const Vector2<float>& cursorPosition);
+
+private:
+	Vector2<float> _cursorPosition = { 0.f, 0.f };
+};
@@ -1,11 +1,26 @@
 #include "objectBase.h"
 
 #include "collision.h"
+#include "fixedTimestep.h"
 #include "gameEngine.h"
-#include "quadTree.h"
+#include "spatialIndex.h"
+#include "universalFunctions.h"
+
+#include <algorithm>
 
 ObjectBase::ObjectBase(const ObjectType& objectType) : _objectID(lastObjectID), _objectType(objectType) {
     lastObjectID++;
+    //Enemies steer around and attack the objects around them and projectiles hit them, the other objects never read their queried objects
+    switch (_objectType) {
+    case ObjectType::Enemy:
+    case ObjectType::Projectile:
+        _collisionMask = ToCollisionLayer(ObjectType::Enemy) | ToCollisionLayer(ObjectType::Player) |
+            ToCollisionLayer(ObjectType::Obstacle) | ToCollisionLayer(ObjectType::Weapon);
+        break;
+    default:
+        _collisionMask = 0;
+        break;
+    }
 }
 
 const unsigned int ObjectBase::GetObjectID() const {
@@ -28,10 +43,26 @@ const ObjectType ObjectBase::GetObjectType() const {
     return _objectType;
 }
 
-const std::vector<std::shared_ptr<ObjectBase>> ObjectBase::GetQueriedObjects() const {
+const unsigned int ObjectBase::GetCollisionLayer() const {
+    return ToCollisionLayer(_objectType);
+}
+
+const unsigned int ObjectBase::GetCollisionMask() const {
+    return _collisionMask;
+}
+
+const std::vector<std::shared_ptr<ObjectBase>>& ObjectBase::GetNearestObjects() const {
+    return _nearestObjects;
+}
+
+const std::vector<std::shared_ptr<ObjectBase>>& ObjectBase::GetQueriedObjects() const {
     return _queriedObjects;
 }
 
+const NeighbourList& ObjectBase::GetNeighbourList() const {
+    return _neighbourList;
+}
+
 const std::shared_ptr<ObjectBase> ObjectBase::GetTargetObject() const {
     return _currentTarget;
 }
@@ -56,6 +87,39 @@ const Vector2<float> ObjectBase::GetVelocity() const {
     return _velocity;
 }
 
+//Called for every active object before each simulation step
+void ObjectBase::StorePreviousState() {
+    _previousPosition = _position;
+    _previousOrientation = _orientation;
+    _previousStateFrame = frameNumber;
+}
+
+//Called when an object is placed somewhere new, it is drawn where it is until the next step stores its state
+void ObjectBase::ResetPreviousState() {
+    _previousStateFrame = -1;
+}
+
+//An object that was not active when the last step began has no state to blend from and is drawn where it is
+const Vector2<float> ObjectBase::GetRenderPosition() const {
+    if (_previousStateFrame != frameNumber) {
+        return _position;
+    }
+    return _previousPosition + (_position - _previousPosition) * fixedTimestep->GetInterpolation();
+}
+
+//Blends the short way around, so an orientation that wraps from PI to -PI does not spin
+const float ObjectBase::GetRenderOrientation() const {
+    if (_previousStateFrame != frameNumber) {
+        return _orientation;
+    }
+    const float turn = universalFunctions->WrapMinMax(_orientation - _previousOrientation, -PI, PI);
+    return _previousOrientation + turn * fixedTimestep->GetInterpolation();
+}
+
+SteeringState& ObjectBase::GetSteeringState() {
+    return _steeringState;
+}
+
 const int ObjectBase::GetDamage() const {
     return 0;
 }
@@ -80,14 +144,66 @@ void ObjectBase::SetVelocity(const Vector2<float>& velocity) {
     _velocity = velocity;
 }
 
-void ObjectBase::QueryObjects() {
-    _queriedObjects = objectBaseQuadTree->Query(_collider);
+//The queried objects are filled by the broad phase and keep their capacity between frames
+void ObjectBase::AddQueriedObject(const std::shared_ptr<ObjectBase>& object) {
+    _queriedObjects.emplace_back(object);
+}
+
+void ObjectBase::ClearQueriedObjects() {
+    _queriedObjects.clear();
+}
+
+void ObjectBase::SetNearestObjects(const std::vector<std::shared_ptr<ObjectBase>>& objects, const unsigned int& first, const unsigned int& count) {
+    _nearestObjects.assign(objects.begin() + first, objects.begin() + first + count);
+}
+
+void ObjectBase::SetNeighbourList(const std::vector<std::shared_ptr<ObjectBase>>& objects, const unsigned int& first, const unsigned int& count) {
+    _neighbourList.objects.assign(objects.begin() + first, objects.begin() + first + count);
+    _neighbourList.colliders.clear();
+    _neighbourList.builtPositions.clear();
+    for (unsigned int i = 0; i < _neighbourList.objects.size(); i++) {
+        _neighbourList.colliders.emplace_back(_neighbourList.objects[i]->GetCollider());
+        _neighbourList.builtPositions.emplace_back(_neighbourList.colliders.back()->GetPosition());
+    }
+    _neighbourList.builtPosition = _collider->GetPosition();
+    _neighbourList.isBuilt = true;
+}
 
-    _queriedProjectiles = projectileQuadTree->Query(_collider);
-    _queriedObjects.insert(_queriedObjects.end(), _queriedProjectiles.begin(), _queriedProjectiles.end());
+//Adds an object that came within reach while this list was still valid, a list that is not built yet finds it anyway
+void ObjectBase::AddToNeighbourList(const std::shared_ptr<ObjectBase>& object) {
+    if (!_neighbourList.isBuilt || std::find(_neighbourList.objects.begin(), _neighbourList.objects.end(), object) != _neighbourList.objects.end()) {
+        return;
+    }
+    _neighbourList.objects.emplace_back(object);
+    _neighbourList.colliders.emplace_back(object->GetCollider());
+    _neighbourList.builtPositions.emplace_back(_neighbourList.colliders.back()->GetPosition());
+}
+
+void ObjectBase::ClearNeighbourList() {
+    _neighbourList.objects.clear();
+    _neighbourList.colliders.clear();
+    _neighbourList.builtPositions.clear();
+    _neighbourList.isBuilt = false;
+}
 
-    _queriedObstacles = obstacleQuadTree->Query(_collider);
-    _queriedObjects.insert(_queriedObjects.end(), _queriedObstacles.begin(), _queriedObstacles.end());
+/*The list has to be built again once this object or one of the objects in it moved more than maxDisplacement since it was built.
+An object removed in the meantime counts as moved, it waits far away from everything*/
+const bool ObjectBase::IsNeighbourListStale(const float& maxDisplacement) const {
+    if (!_neighbourList.isBuilt) {
+        return true;
+    }
+    const float maxDisplacementSquared = maxDisplacement * maxDisplacement;
+    Vector2<float> displacement = _collider->GetPosition() - _neighbourList.builtPosition;
+    if (displacement.x * displacement.x + displacement.y * displacement.y > maxDisplacementSquared) {
+        return true;
+    }
+    for (unsigned int i = 0; i < _neighbourList.objects.size(); i++) {
+        displacement = _neighbourList.colliders[i]->GetPosition() - _neighbourList.builtPositions[i];
+        if (displacement.x * displacement.x + displacement.y * displacement.y > maxDisplacementSquared) {
+            return true;
+        }
+    }
+    return false;
 }
 
 void ObjectBase::TakeDamage(const int& damageAmount) {}
@@ -99,6 +215,8 @@ void ObjectBase::ActivateObject(const Vector2<float>& position, const Vector2<fl
 }
 
 void ObjectBase::DeactivateObject() {
+    _nearestObjects.clear();
+    ClearNeighbourList();
     _position = deactivatedPosition;
     _collider->SetPosition(_position);
 }
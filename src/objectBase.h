@@ -15,9 +15,30 @@ enum class ObjectType {
 	Count
 };
 
+//Every object type owns one collision layer bit, several layers are combined into a mask to filter queries and collision pairs
+inline const unsigned int ToCollisionLayer(const ObjectType& objectType) {
+	return 1 << (unsigned int)objectType;
+}
+
 class Collider;
+class ObjectBase;
 class Timer;
 
+//The steering state of one agent that lasts between ticks, the shared steering behaviours keep none of their own
+struct SteeringState {
+	float wanderOrientation = 0.f;
+};
+
+/*The objects within reach of an object plus a skin margin, found by one query and reused until something in it may have moved past the skin.
+Every object keeps its collider and the position the collider had when the list was built, so the list can tell how far each of them moved since*/
+struct NeighbourList {
+	std::vector<std::shared_ptr<ObjectBase>> objects;
+	std::vector<std::shared_ptr<Collider>> colliders;
+	std::vector<Vector2<float>> builtPositions;
+	Vector2<float> builtPosition = { 0.f, 0.f };
+	bool isBuilt = false;
+};
+
 class ObjectBase : public std::enable_shared_from_this<ObjectBase> {
 public:
 	ObjectBase(const ObjectType& objectType);
@@ -40,8 +61,12 @@ public:
 	const float GetOrientation() const;
 	const float GetRotation() const;
 	const ObjectType GetObjectType() const;
+	const unsigned int GetCollisionLayer() const;
+	const unsigned int GetCollisionMask() const;
 
-	const std::vector<std::shared_ptr<ObjectBase>> GetQueriedObjects() const;
+	const std::vector<std::shared_ptr<ObjectBase>>& GetNearestObjects() const;
+	const std::vector<std::shared_ptr<ObjectBase>>& GetQueriedObjects() const;
+	const NeighbourList& GetNeighbourList() const;
 	const std::shared_ptr<ObjectBase> GetTargetObject() const;
 	
 	const std::shared_ptr<Sprite> GetSprite() const;
@@ -51,6 +76,13 @@ public:
 	const Vector2<float> GetTargetPosition() const;
 	const Vector2<float> GetVelocity() const;	
 
+	void StorePreviousState();
+	void ResetPreviousState();
+	const Vector2<float> GetRenderPosition() const;
+	const float GetRenderOrientation() const;
+
+	SteeringState& GetSteeringState();
+
 	virtual const int GetDamage() const;
 
 	void SetOrientation(const float& orientation);
@@ -58,26 +90,43 @@ public:
 	void SetTargetPosition(const Vector2<float>& targetPosition);
 	void SetVelocity(const Vector2<float>& velocity);
 
-	virtual void QueryObjects();
+	void AddQueriedObject(const std::shared_ptr<ObjectBase>& object);
+	void ClearQueriedObjects();
+	void SetNearestObjects(const std::vector<std::shared_ptr<ObjectBase>>& objects, const unsigned int& first, const unsigned int& count);
+
+	void SetNeighbourList(const std::vector<std::shared_ptr<ObjectBase>>& objects, const unsigned int& first, const unsigned int& count);
+	void AddToNeighbourList(const std::shared_ptr<ObjectBase>& object);
+	void ClearNeighbourList();
+	const bool IsNeighbourListStale(const float& maxDisplacement) const;
 
 protected:
+	//The closest objects found for this object by its manager's batched nearest neighbour query, nearest first
+	std::vector<std::shared_ptr<ObjectBase>> _nearestObjects;
 	std::vector<std::shared_ptr<ObjectBase>> _queriedObjects;
-	std::vector<std::shared_ptr<ObjectBase>> _queriedProjectiles;
-	std::vector<std::shared_ptr<ObjectBase>> _queriedObstacles;
+	NeighbourList _neighbourList;
 
 	std::shared_ptr<Collider> _collider = nullptr;
 
 	std::shared_ptr<ObjectBase> _currentTarget = nullptr;
 
+	SteeringState _steeringState;
+
 	float _orientation = 0.f;
 	float _rotation = 0.f;
 
+	//Where the object was before the last simulation step, the rendering blends from it to the current state
+	Vector2<float> _previousPosition = { -10000.f, -10000.f };
+	float _previousOrientation = 0.f;
+	int _previousStateFrame = -1;
+
 	const unsigned int _objectID;
 
 	int _currentHealth = 0;
 	int _maxHealth = 0;
 
 	const ObjectType _objectType = ObjectType::Count;
+	//The layers this object wants in its queried objects
+	unsigned int _collisionMask = 0;
 
 	std::shared_ptr<Sprite> _sprite = nullptr;
 
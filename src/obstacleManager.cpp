@@ -1,10 +1,11 @@
 #include "obstacleManager.h"
 
 #include "debugDrawer.h"
+#include "flowField.h"
 #include "gameEngine.h"
 #include "objectPool.h"
 #include "obstacleWall.h"
-#include "quadTree.h"
+#include "spatialIndex.h"
 
 ObstacleManager::ObstacleManager() {
 	_objectAmountLimit = 200;
@@ -28,25 +29,23 @@ void ObstacleManager::SpawnObstacle(const Vector2<float>& position, const float&
 	_currentObstacle = _obstaclePool->SpawnObject();
 	_currentObstacle->ActivateObstacle(position, width, height, color);
 	_activeObjects.insert(std::make_pair(_currentObstacle->GetObjectID(), _currentObstacle));
+	spatialIndex->Insert(_currentObstacle, _currentObstacle->GetCollider(), _currentObstacle->GetCollisionLayer());
+	flowField->SetObstaclesChanged();
 }
 
-void ObstacleManager::InsertObjectsQuadtree() {
-	for (auto& object : _activeObjects) {
-		if (!object.second->GetCollider()->GetIsActive()) {
-			continue;
-		}
-		obstacleQuadTree->Insert(object.second, object.second->GetCollider());
-	}
-}
+//Obstacles never move, they are added to the index when spawned and taken out when removed
+void ObstacleManager::SyncSpatialIndex() {}
 
 void ObstacleManager::RemoveAllObjects() {
 	for (auto& obstacle : _activeObjects) {
 		_currentObstacle = CastAsObstacle(obstacle.second);
+		spatialIndex->Remove(obstacle.second);
 		_currentObstacle->DeactivateObject();
 		_obstaclePool->PoolObject(_currentObstacle);
 	}
 	_activeObjects.clear();
 	_currentObstacle = nullptr;
+	flowField->SetObstaclesChanged();
 }
 
 void ObstacleManager::RemoveObject(const unsigned int& objectID) {
@@ -54,10 +53,12 @@ void ObstacleManager::RemoveObject(const unsigned int& objectID) {
 		return;
 	}
 	_currentObstacle = CastAsObstacle(_activeObjects[objectID]);
+	spatialIndex->Remove(_activeObjects[objectID]);
 	_currentObstacle->DeactivateObject();
 	_obstaclePool->PoolObject(_currentObstacle);
 	_activeObjects.erase(objectID);
 	_currentObstacle = nullptr;
+	flowField->SetObstaclesChanged();
 }
 
 std::shared_ptr<Obstacle> ObstacleManager::CastAsObstacle(std::shared_ptr<ObjectBase> objectBase) {
@@ -21,7 +21,7 @@ public:
 	void SpawnObstacle(const Vector2<float>& position,
 		const float& width, const float& height, const SDL_Color& color);
 
-	void InsertObjectsQuadtree() override;
+	void SyncSpatialIndex() override;
 	void RemoveAllObjects() override;
 	void RemoveObject(const unsigned int& objectID) override;
 
@@ -3,7 +3,8 @@
 #include "collision.h"
 #include "debugDrawer.h"
 #include "gameEngine.h"
-#include "quadTree.h"
+#include "renderBackend.h"
+#include "spatialIndex.h"
 
 Obstacle::Obstacle() : ObjectBase(ObjectType::Obstacle) {
 	_boxCollider = std::make_shared<AABB>();
@@ -33,8 +34,8 @@ void Obstacle::Render() {
 
 	//debugDrawer->AddDebugRectangle(_boxCollider->GetPosition(), _boxCollider->GetMin(), _boxCollider->GetMax(), { 0, 255, 0, 255}, false);
 
-	SDL_SetRenderDrawColor(renderer, _color.r, _color.g, _color.b, _color.a);
-	SDL_RenderFillRectF(renderer, &_rect);
+	renderBackend->SetDrawColor(_color);
+	renderBackend->FillRectangle(_rect);
 }
 
 void Obstacle::RenderText() {}
@@ -43,8 +44,3 @@ const std::shared_ptr<Collider> Obstacle::GetCollider() const {
 	return _boxCollider;
 }
 
-void Obstacle::QueryObjects() {
-	_queriedObjects = objectBaseQuadTree->Query(_collider);
-	_queriedProjectiles = obstacleQuadTree->Query(_collider);
-	_queriedObjects.insert(_queriedObjects.end(), _queriedProjectiles.begin(), _queriedProjectiles.end());
-}
@@ -20,8 +20,6 @@ public:
 	
 	const std::shared_ptr<Collider> GetCollider() const override;
 
-	void QueryObjects() override;
-
 private:	
 	SDL_FRect _rect;
 
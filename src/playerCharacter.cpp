@@ -46,7 +46,7 @@ void PlayerCharacter::Update() {
 }
 
 void PlayerCharacter::Render() {
-	_sprite->RenderWithOrientation(0, _position, _orientation);
+	_sprite->RenderWithOrientation(0, GetRenderPosition(), GetRenderOrientation());
 	_weaponComponent->Render();
 }
 
@@ -74,6 +74,7 @@ void PlayerCharacter::ExecuteDeath() {
 void PlayerCharacter::Respawn() {
 	_position = _spawnPosition;
 	_orientation = 0.f;
+	ResetPreviousState();
 	
 	_currentHealth = _maxHealth;
 	_healthTextSprite->ChangeText(std::to_string(_currentHealth).c_str(), { 255, 255, 255, 255 });
@@ -22,12 +22,13 @@ void Projectile::Init() {}
 
 void Projectile::Update() {
 	_velocity = _direction * _speed;
-	_position += _velocity * deltaTime;
+	const Vector2<float> displacement = _velocity * deltaTime;
+	_position += displacement * FindTravelledFraction(displacement);
 	_collider->SetPosition(_position + _direction * (_sprite->GetHeight() * 0.25f));
 }
 
 void Projectile::Render() {
-	_sprite->RenderWithOrientation(0, _position, _orientation);
+	_sprite->RenderWithOrientation(0, GetRenderPosition(), GetRenderOrientation());
 }
 
 const std::shared_ptr<Collider> Projectile::GetCollider() const {
@@ -69,6 +70,27 @@ void Projectile::ActivateProjectile(std::shared_ptr<ObjectBase> owner, const flo
 	
 	_damage = damage;
 	_speed = speed;
+	ResetPreviousState();
+}
+
+/*Sweeps the collider over the movement of this tick, so a fast projectile or a long frame cannot carry it past something it should hit.
+It stops just inside the first object it can damage and the projectile manager damages it through the queried objects as before*/
+const float Projectile::FindTravelledFraction(const Vector2<float>& displacement) {
+	const float distance = _speed * deltaTime;
+	if (distance <= 0.f) {
+		return 1.f;
+	}
+	_sweepHits.clear();
+	spatialIndex->SweepQuery(*std::static_pointer_cast<Circle>(_collider), displacement, _sweepHits, _collisionMask);
+	for (unsigned int i = 0; i < _sweepHits.size(); i++) {
+		const ObjectType objectType = _sweepHits[i].object->GetObjectType();
+		if (objectType == _objectType || (_owner && objectType == _owner->GetObjectType())) {
+			continue;
+		}
+		const float travelledFraction = _sweepHits[i].timeOfImpact + _contactDepth / distance;
+		return travelledFraction < 1.f ? travelledFraction : 1.f;
+	}
+	return 1.f;
 }
 
 void Projectile::DeactivateObject() {
@@ -76,9 +98,3 @@ void Projectile::DeactivateObject() {
 	_position = deactivatedPosition;
 	_collider->SetPosition(_position);
 }
-
-void Projectile::QueryObjects() {
-	_queriedObjects = objectBaseQuadTree->Query(_collider);
-	_queriedObstacles = obstacleQuadTree->Query(_collider);
-	_queriedObjects.insert(_queriedObjects.end(), _queriedObstacles.begin(), _queriedObstacles.end());
-}
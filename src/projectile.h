@@ -1,9 +1,12 @@
 #pragma once
 #include "collision.h"
 #include "objectBase.h"
+#include "spatialIndex.h"
 #include "sprite.h"
 #include "vector2.h"
 
+#include <vector>
+
 enum class ProjectileType {
 	Energyblast,
 	EnemyFireball,
@@ -34,13 +37,16 @@ public:
 		const Vector2<float>& position, const int& damage, const float& speed);
 	void DeactivateObject() override;
 
-	void QueryObjects() override;
-
 private:
+	const float FindTravelledFraction(const Vector2<float>& displacement);
+
 	std::shared_ptr<ObjectBase> _owner = nullptr;
+	std::vector<SweepHit<std::shared_ptr<ObjectBase>>> _sweepHits;
 
 	ProjectileType _projectileType = ProjectileType::Count;
 	
+	//How far past the first touch the projectile stops, so the broad phase sees it overlap what it hit
+	float _contactDepth = 1.f;
 	float _speed = 200.f;
 	int _damage = 30;
 };
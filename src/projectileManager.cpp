@@ -1,13 +1,14 @@
 #include "projectileManager.h"
 
+#include "commandBuffer.h"
 #include "enemyManager.h"
 #include "enemyBase.h"
 #include "gameEngine.h"
 #include "imGuiManager.h"
 #include "objectPool.h"
 #include "playerCharacter.h"
-#include "quadTree.h"
 #include "searchSortAlgorithms.h"
+#include "spatialIndex.h"
 
 ProjectileManager::ProjectileManager() {
 	_spritePaths[ProjectileType::Energyblast] = _energyBlastSprite;
@@ -35,26 +36,20 @@ void ProjectileManager::Update() {
 	for (auto& projectile : _activeObjects) {
 		_currentProjectile = CastAsProjectile(projectile.second);
 		_currentProjectile->Update();
-		_currentProjectile->QueryObjects();
-		if (CheckCollision(_currentProjectile->GetProjectileType(), _currentProjectile->GetObjectID())) {
-			_removeObjects.emplace_back(_currentProjectile);
-			continue;
-		}	
-	}
-	while (_removeObjects.size() > 0) {
-		RemoveObject(_removeObjects.back()->GetObjectID());
-		_removeObjects.pop_back();
 	}
 	_currentProjectile = nullptr;
 }
 
-void ProjectileManager::InsertObjectsQuadtree() {
-	for (auto& object : _activeObjects) {
-		if (!object.second->GetCollider()->GetIsActive()) {
-			continue;
+/*Runs after the broad phase, which has filled every projectile with the objects it overlaps this tick.
+The hits and the projectiles that are used up go to the command buffer, which applies them once the tick is done*/
+void ProjectileManager::CheckCollisions() {
+	for (auto& projectile : _activeObjects) {
+		_currentProjectile = CastAsProjectile(projectile.second);
+		if (CheckCollision(*_currentProjectile)) {
+			commandBuffer->AddDespawn(_currentProjectile);
 		}
-		projectileQuadTree->Insert(object.second, object.second->GetCollider());
 	}
+	_currentProjectile = nullptr;
 }
 
 void ProjectileManager::CreateNewProjectile(const ProjectileType& projectileType) {
@@ -72,20 +67,20 @@ std::shared_ptr<Projectile> ProjectileManager::SpawnProjectile(std::shared_ptr<O
 	return _currentProjectile;
 }
 
-bool ProjectileManager::CheckCollision(const ProjectileType& projectileType, const unsigned int& objectID) {
+bool ProjectileManager::CheckCollision(const Projectile& projectile) {
 	_projectileHit = false;
-	if (universalFunctions->OutsideBorderX(_activeObjects[objectID]->GetPosition().x, -_activeObjects[objectID]->GetSprite()->GetHeight()) ||
-		universalFunctions->OutsideBorderY(_activeObjects[objectID]->GetPosition().y, -_activeObjects[objectID]->GetSprite()->GetHeight())) {
+	if (universalFunctions->OutsideBorderX(projectile.GetPosition().x, -projectile.GetSprite()->GetHeight()) ||
+		universalFunctions->OutsideBorderY(projectile.GetPosition().y, -projectile.GetSprite()->GetHeight())) {
 		_projectileHit = true;
 		return _projectileHit;
 	}
-	_objectsHit = _activeObjects[objectID]->GetQueriedObjects();
-	for (unsigned int i = 0; i < _objectsHit.size(); i++) {
-		if (_objectsHit[i]->GetObjectType() == _activeObjects[objectID]->GetObjectType() ||
-			_objectsHit[i]->GetObjectType() == CastAsProjectile(_activeObjects[objectID])->GetOwner()->GetObjectType()) {
+	const ObjectType ownerType = projectile.GetOwner()->GetObjectType();
+	const std::vector<std::shared_ptr<ObjectBase>>& objectsHit = projectile.GetQueriedObjects();
+	for (unsigned int i = 0; i < objectsHit.size(); i++) {
+		if (objectsHit[i]->GetObjectType() == projectile.GetObjectType() || objectsHit[i]->GetObjectType() == ownerType) {
 			continue;
 		}
-		_objectsHit[i]->TakeDamage(CastAsProjectile(_activeObjects[objectID])->GetDamage());
+		commandBuffer->AddDamage(objectsHit[i], projectile.GetDamage());
 		_projectileHit = true;
 	}
 	return _projectileHit;
@@ -94,6 +89,7 @@ bool ProjectileManager::CheckCollision(const ProjectileType& projectileType, con
 void ProjectileManager::RemoveAllObjects() {
 	for (auto& projectile : _activeObjects) {
 		_currentProjectile = CastAsProjectile(projectile.second);
+		spatialIndex->Remove(projectile.second);
 		_currentProjectile->DeactivateObject();
 		_projectilePools[_currentProjectile->GetProjectileType()]->PoolObject(_currentProjectile);
 	}
@@ -106,6 +102,7 @@ void ProjectileManager::RemoveObject(const unsigned int& objectID) {
 		return;
 	}	
 	_currentProjectile = CastAsProjectile(_activeObjects[objectID]);
+	spatialIndex->Remove(_activeObjects[objectID]);
 	_currentProjectile->DeactivateObject();
 	_projectilePools[_currentProjectile->GetProjectileType()]->PoolObject(_currentProjectile);
 	_activeObjects.erase(objectID);
@@ -13,10 +13,9 @@ public:
 
 	void Init() override;
 	void Update() override;
+	void CheckCollisions();
 
-	void InsertObjectsQuadtree() override;
-
-	bool CheckCollision(const ProjectileType& projectileType, const unsigned int& objectID);
+	bool CheckCollision(const Projectile& projectile);
 
 	void CreateNewProjectile(const ProjectileType& projectileType);
 	
@@ -31,10 +30,9 @@ private:
 	std::shared_ptr<Projectile> _currentProjectile = nullptr;
 
 	std::unordered_map<ProjectileType, std::shared_ptr<ObjectPool<std::shared_ptr<Projectile>>>> _projectilePools;
-	std::vector<std::shared_ptr<ObjectBase>> _objectsHit;
 
 	std::unordered_map<ProjectileType, const char*> _spritePaths;
-	const char* _energyBlastSprite = "res/sprites/Energyblast.png";
+	const char* _energyBlastSprite = "res/sprites/EnergyBlast.png";
 	const char* _enemyProjectileSprite = "res/sprites/Fireball.png";
 	const char* _playerProjectileSprite = "res/sprites/Arcaneball.png";
 	
@@ -1,29 +1,9 @@
 #include "quadTree.h"
 
-bool QuadTreeNode::Contains(std::shared_ptr<Collider> circleCollider) {
-	switch (circleCollider->GetColliderType()) {
-	case ColliderType::AABB:
-		return collisionCheck->AABBIntersect(*rectangle, *std::static_pointer_cast<AABB>(circleCollider));
-		break;
-	case ColliderType::Circle:
-		return collisionCheck->AABBCircleIntersect(*rectangle, *std::static_pointer_cast<Circle>(circleCollider));
-		break;
-	default:
-		break;
-	}
-	return false;
+bool QuadTreeNode::Contains(const std::shared_ptr<Collider>& collider) {
+	return ColliderIntersect(*rectangle, *collider);
 }
 
-bool QuadTreeNode::Intersect(std::shared_ptr<Collider> range) {
-	switch (range->GetColliderType()) {
-	case ColliderType::AABB:
-		return collisionCheck->AABBIntersect(*rectangle, *std::static_pointer_cast<AABB>(range));
-		break;
-	case ColliderType::Circle:
-		return collisionCheck->AABBCircleIntersect(*rectangle, *std::static_pointer_cast<Circle>(range));
-		break;
-	default:
-		break;
-	}
-	return false;
+bool QuadTreeNode::Intersect(const std::shared_ptr<Collider>& range) {
+	return ColliderIntersect(*rectangle, *range);
 }
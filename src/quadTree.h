@@ -1,220 +1,480 @@
 #pragma once
 #include "collision.h"
+#include "spatialIndex.h"
 #include "vector2.h"
 
 #include <array>
+#include <unordered_map>
 #include <vector>
 
 #include "debugDrawer.h"
 #include "gameEngine.h"
 
+/*A regular quadtree places an object in the first node its collider intersects, so a collider that straddles a split line is only found from one side.
+A loose quadtree places objects by their centre point and enlarges every node so the whole collider fits inside it*/
+enum class QuadTreeType {
+	Regular,
+	Loose,
+	Count
+};
+
 struct QuadTreeNode {
 	std::shared_ptr<AABB> rectangle = nullptr;
 
-	bool Contains(std::shared_ptr<Collider> collider);
-	bool Intersect(std::shared_ptr<Collider> range);
+	bool Contains(const std::shared_ptr<Collider>& collider);
+	bool Intersect(const std::shared_ptr<Collider>& range);
 };
 
-template<typename T> 
-class QuadTree {
+/*The quadtree is kept between frames, its nodes live in an arena and are reused through a free list.
+Objects are inserted once, moved with Update when their collider leaves their node and removed when they are despawned*/
+template<typename T>
+class QuadTree : public SpatialIndex<T> {
 public:
-	QuadTree(const QuadTreeNode& boundary, const unsigned int& capacity);
+	QuadTree(const QuadTreeNode& boundary, const unsigned int& capacity, const QuadTreeType& quadTreeType = QuadTreeType::Regular);
 	~QuadTree();
 
-	bool Insert(T object, std::shared_ptr<Collider> collider);
-	std::vector<T> Query(std::shared_ptr<Collider> range);
+	bool Insert(T object, std::shared_ptr<Collider> collider, const unsigned int& layer) override;
+	bool Remove(const T& object) override;
+	bool Update(const T& object, const std::shared_ptr<Collider>& collider, const unsigned int& layer) override;
+
+	void Query(const std::shared_ptr<Collider>& range, std::vector<T>& objectsFound, const unsigned int& layerMask) override;
 
-	void Clear();
-	void Subdivide();
-	void Render();
+	template<typename Visitor>
+	void Visit(const Collider& range, const unsigned int& layerMask, Visitor&& visitor);
+
+	void Rebuild() override;
+	void Clear() override;
+	void Render() override;
+
+	const SpatialIndexType GetSpatialIndexType() const override;
+	const unsigned int GetNumberOfObjects() const override;
+	const unsigned int GetNumberOfNodes() const;
+	const QuadTreeType GetQuadTreeType() const;
+
+	const std::shared_ptr<Collider> FindCollider(const T& object) const override;
 
 private:
-	QuadTreeNode _upperLeft;
-	QuadTreeNode _upperRight;
-	QuadTreeNode _lowerLeft;
-	QuadTreeNode _lowerRight;
+	struct Entry {
+		T object;
+		std::shared_ptr<Collider> collider = nullptr;
+		unsigned int layer = 0;
+		int nodeIndex = -1;
+	};
+
+	struct Node {
+		AABB boundary;
+		AABB looseBoundary;
+		std::array<int, 4> children = { -1, -1, -1, -1 };
+		std::vector<unsigned int> entries;
 
-	bool _divided = false;
+		int parent = -1;
+		unsigned int depth = 0;
+		unsigned int subtreeCount = 0;
+		bool divided = false;
+	};
+
+	//Node indices are passed by value, the arena can grow and move its nodes while children are allocated
+	int AllocateNode(const Vector2<float>& position, const float& height, const float& width, const int parent, const unsigned int depth);
+	void FreeNode(const int nodeIndex);
+
+	bool InsertInNode(const int nodeIndex, const unsigned int entryIndex);
+	bool InsertInLooseNode(const int nodeIndex, const unsigned int entryIndex);
+	bool IsInsideNode(const int nodeIndex, const Collider& collider);
+	bool FitsInLooseNode(const int nodeIndex, const Collider& collider);
+	void RemoveFromNode(const unsigned int entryIndex);
+	void Subdivide(const int nodeIndex);
+	void Merge(const int nodeIndex);
+	void MoveEntriesToNode(const int fromNodeIndex, const int toNodeIndex);
+
+	template<typename Visitor>
+	void VisitNode(const int nodeIndex, const Collider& range, const unsigned int& layerMask, unsigned int& candidatesTested, Visitor& visitor) const;
+
+	void RenderNode(const int nodeIndex);
+
+	const int _rootIndex = 0;
 
 	unsigned int _capacity = 0;
-	QuadTreeNode _quadTreeNode;
+	unsigned int _maxDepth = 8;
+
+	QuadTreeType _quadTreeType = QuadTreeType::Regular;
+	float _looseness = 1.f;
 
-	std::array<std::shared_ptr<QuadTree<T>>, 4> _quadTreeChildren;
-	
-	std::vector<T> _objectsFound;
-	std::vector<T> _objectsFoundInChild;
-	std::vector<T> _objectsInserted;
+	std::vector<Node> _nodes;
+	std::vector<int> _freeNodes;
 
-	std::vector<std::shared_ptr<Collider>> _colliders;
-	std::shared_ptr<AABB> _boxCollider = nullptr;
-	std::shared_ptr<Circle> _circleCollider = nullptr;
+	std::vector<Entry> _entries;
+	std::vector<unsigned int> _freeEntries;
+	std::unordered_map<T, unsigned int> _entryIndices;
 
 	SDL_Color _quadTreeColor = { 255, 125, 0, 255 };
 
 };
 template<typename T>
-inline QuadTree<T>::QuadTree(const QuadTreeNode& boundary, const unsigned int& capacity) {
-	_quadTreeNode = boundary;
+inline QuadTree<T>::QuadTree(const QuadTreeNode& boundary, const unsigned int& capacity, const QuadTreeType& quadTreeType) {
 	_capacity = capacity;
+	_quadTreeType = quadTreeType;
 
-	_quadTreeChildren[0] = nullptr;
-	_quadTreeChildren[1] = nullptr;
-	_quadTreeChildren[2] = nullptr;
-	_quadTreeChildren[3] = nullptr;
+	//Loose nodes are twice the size of their cell, which lets any collider up to half the cell size fit below the node its centre is in
+	if (_quadTreeType == QuadTreeType::Loose) {
+		_looseness = 2.f;
+	}
+
+	//Reserves enough nodes for four full levels so the arena rarely has to grow during play
+	_nodes.reserve(341);
+	AllocateNode(boundary.rectangle->GetPosition(), boundary.rectangle->GetHeight(), boundary.rectangle->GetWidth(), -1, 0);
 }
 template<typename T>
 inline QuadTree<T>::~QuadTree() {
 	Clear();
 }
 
-//Inserts an object into the quadtree node if the circle collider is in that node
+//Inserts an object into the quadtree node if the collider is in that node
+template<typename T>
+inline bool QuadTree<T>::Insert(T object, std::shared_ptr<Collider> collider, const unsigned int& layer) {
+	if (_entryIndices.contains(object)) {
+		return Update(object, collider, layer);
+	}
+	unsigned int entryIndex = 0;
+	if (_freeEntries.empty()) {
+		entryIndex = _entries.size();
+		_entries.emplace_back();
+	} else {
+		entryIndex = _freeEntries.back();
+		_freeEntries.pop_back();
+	}
+	_entries[entryIndex].object = object;
+	_entries[entryIndex].collider = collider;
+	_entries[entryIndex].layer = layer;
+
+	if (!InsertInNode(_rootIndex, entryIndex)) {
+		_entries[entryIndex] = Entry();
+		_freeEntries.emplace_back(entryIndex);
+		return false;
+	}
+	_entryIndices.insert(std::make_pair(object, entryIndex));
+	return true;
+}
+//Removes the object from its node and merges the nodes above it if they dropped below capacity
 template<typename T>
-inline bool QuadTree<T>::Insert(T object, std::shared_ptr<Collider> collider) {
-	if (!_quadTreeNode.Contains(collider)) {
+inline bool QuadTree<T>::Remove(const T& object) {
+	auto entry = _entryIndices.find(object);
+	if (entry == _entryIndices.end()) {
 		return false;
 	}
-	//If the node is at its max capacity it will subdevide into 4 nodes
-	if (_objectsInserted.size() < _capacity) {
-		_objectsInserted.emplace_back(object);
-		_colliders.emplace_back(collider);
+	const unsigned int entryIndex = entry->second;
+	_entryIndices.erase(entry);
+	RemoveFromNode(entryIndex);
+
+	_entries[entryIndex] = Entry();
+	_freeEntries.emplace_back(entryIndex);
+	return true;
+}
+/*Only moves the object when its collider has left the node it is stored in,
+most objects only move a few pixels per frame and stay where they are*/
+template<typename T>
+inline bool QuadTree<T>::Update(const T& object, const std::shared_ptr<Collider>& collider, const unsigned int& layer) {
+	auto entry = _entryIndices.find(object);
+	if (entry == _entryIndices.end()) {
+		return Insert(object, collider, layer);
+	}
+	const unsigned int entryIndex = entry->second;
+	_entries[entryIndex].collider = collider;
+	_entries[entryIndex].layer = layer;
+	if (IsInsideNode(_entries[entryIndex].nodeIndex, *collider)) {
 		return true;
+	}
+	RemoveFromNode(entryIndex);
+	if (!InsertInNode(_rootIndex, entryIndex)) {
+		//The object left the quadtree completely
+		_entryIndices.erase(entry);
+		_entries[entryIndex] = Entry();
+		_freeEntries.emplace_back(entryIndex);
+		return false;
+	}
+	return true;
+}
+//Appends the objects the collider hit to objectsFound, the caller owns the buffer so it can be reused every frame
+template<typename T>
+inline void QuadTree<T>::Query(const std::shared_ptr<Collider>& range, std::vector<T>& objectsFound, const unsigned int& layerMask) {
+	Visit(*range, layerMask, [&objectsFound](const T& object) {
+		objectsFound.emplace_back(object);
+	});
+}
+//Calls the visitor once for every object the collider hit, without copying any results between the nodes
+template<typename T>
+template<typename Visitor>
+inline void QuadTree<T>::Visit(const Collider& range, const unsigned int& layerMask, Visitor&& visitor) {
+	unsigned int candidatesTested = 0;
+	VisitNode(_rootIndex, range, layerMask, candidatesTested, visitor);
+	this->_candidatesTested += candidatesTested;
+	this->_queriesMade++;
+}
+//Moves every stored object whose collider left its node since the last update, the arena is shared by the whole tree so this runs on one thread
+template<typename T>
+inline void QuadTree<T>::Rebuild() {
+	for (unsigned int i = 0; i < _entries.size(); i++) {
+		if (!_entries[i].collider) {
+			continue;
+		}
+		const T object = _entries[i].object;
+		Update(object, _entries[i].collider, _entries[i].layer);
+	}
+}
+//Returns every node except the root to the free list, the nodes keep their entry capacity for the next time they are used
+template<typename T>
+inline void QuadTree<T>::Clear() {
+	for (unsigned int i = 0; i < _nodes.size(); i++) {
+		_nodes[i].entries.clear();
+		_nodes[i].subtreeCount = 0;
+		if (_nodes[i].divided) {
+			_nodes[i].divided = false;
+			_nodes[i].children = { -1, -1, -1, -1 };
+		}
+	}
+	_freeNodes.clear();
+	for (int i = (int)_nodes.size() - 1; i > _rootIndex; i--) {
+		_freeNodes.emplace_back(i);
+	}
+	_entries.clear();
+	_freeEntries.clear();
+	_entryIndices.clear();
+}
+template<typename T>
+inline void QuadTree<T>::Render() {
+	RenderNode(_rootIndex);
+}
+template<typename T>
+inline const unsigned int QuadTree<T>::GetNumberOfObjects() const {
+	return _entryIndices.size();
+}
+template<typename T>
+inline const unsigned int QuadTree<T>::GetNumberOfNodes() const {
+	return _nodes.size() - _freeNodes.size();
+}
+template<typename T>
+inline const SpatialIndexType QuadTree<T>::GetSpatialIndexType() const {
+	if (_quadTreeType == QuadTreeType::Loose) {
+		return SpatialIndexType::LooseQuadTree;
+	}
+	return SpatialIndexType::QuadTree;
+}
+template<typename T>
+inline const QuadTreeType QuadTree<T>::GetQuadTreeType() const {
+	return _quadTreeType;
+}
+template<typename T>
+inline const std::shared_ptr<Collider> QuadTree<T>::FindCollider(const T& object) const {
+	auto entry = _entryIndices.find(object);
+	if (entry == _entryIndices.end()) {
+		return nullptr;
+	}
+	return _entries[entry->second].collider;
+}
+template<typename T>
+inline int QuadTree<T>::AllocateNode(const Vector2<float>& position, const float& height, const float& width, const int parent, const unsigned int depth) {
+	int nodeIndex = 0;
+	if (_freeNodes.empty()) {
+		nodeIndex = _nodes.size();
+		_nodes.emplace_back();
 	} else {
-		if (!_divided) {
-			Subdivide();
+		nodeIndex = _freeNodes.back();
+		_freeNodes.pop_back();
+	}
+	_nodes[nodeIndex].boundary.Init(position, height, width);
+	_nodes[nodeIndex].looseBoundary.Init(position, height * _looseness, width * _looseness);
+	_nodes[nodeIndex].children = { -1, -1, -1, -1 };
+	_nodes[nodeIndex].entries.clear();
+	_nodes[nodeIndex].parent = parent;
+	_nodes[nodeIndex].depth = depth;
+	_nodes[nodeIndex].subtreeCount = 0;
+	_nodes[nodeIndex].divided = false;
+	return nodeIndex;
+}
+template<typename T>
+inline void QuadTree<T>::FreeNode(const int nodeIndex) {
+	if (_nodes[nodeIndex].divided) {
+		for (unsigned int i = 0; i < _nodes[nodeIndex].children.size(); i++) {
+			FreeNode(_nodes[nodeIndex].children[i]);
 		}
-		//After subdividing it checks if it can insert the object in one of the children nodes
-		if (_quadTreeChildren[0]->Insert(object, collider)) {
-			return true;
-		} else if (_quadTreeChildren[1]->Insert(object, collider)) {
-			return true;
-		} else if (_quadTreeChildren[2]->Insert(object, collider)) {
+	}
+	_nodes[nodeIndex].entries.clear();
+	_nodes[nodeIndex].divided = false;
+	_nodes[nodeIndex].subtreeCount = 0;
+	_freeNodes.emplace_back(nodeIndex);
+}
+//If the node is at its max capacity it will subdivide into 4 nodes and place the object in one of them
+template<typename T>
+inline bool QuadTree<T>::InsertInNode(const int nodeIndex, const unsigned int entryIndex) {
+	if (_quadTreeType == QuadTreeType::Loose) {
+		return InsertInLooseNode(nodeIndex, entryIndex);
+	}
+	if (!ColliderIntersect(_nodes[nodeIndex].boundary, *_entries[entryIndex].collider)) {
+		return false;
+	}
+	if (_nodes[nodeIndex].entries.size() < _capacity || _nodes[nodeIndex].depth >= _maxDepth) {
+		_nodes[nodeIndex].entries.emplace_back(entryIndex);
+		_nodes[nodeIndex].subtreeCount++;
+		_entries[entryIndex].nodeIndex = nodeIndex;
+		return true;
+	}
+	if (!_nodes[nodeIndex].divided) {
+		Subdivide(nodeIndex);
+	}
+	//After subdividing it checks if it can insert the object in one of the children nodes
+	for (unsigned int i = 0; i < _nodes[nodeIndex].children.size(); i++) {
+		if (InsertInNode(_nodes[nodeIndex].children[i], entryIndex)) {
+			_nodes[nodeIndex].subtreeCount++;
 			return true;
-		} else if (_quadTreeChildren[3]->Insert(object, collider)) {
+		}
+	}
+	return false;
+}
+/*The loose quadtree only follows the child that holds the centre of the collider,
+the object stays in the current node if the collider is too large to fit in the loose bounds of that child*/
+template<typename T>
+inline bool QuadTree<T>::InsertInLooseNode(const int nodeIndex, const unsigned int entryIndex) {
+	const Collider& collider = *_entries[entryIndex].collider;
+	if (!IsInsideNode(nodeIndex, collider)) {
+		return false;
+	}
+	if (_nodes[nodeIndex].entries.size() >= _capacity && _nodes[nodeIndex].depth < _maxDepth) {
+		if (!_nodes[nodeIndex].divided) {
+			Subdivide(nodeIndex);
+		}
+		//Children are ordered upper left, upper right, lower left, lower right
+		const Vector2<float> center = _nodes[nodeIndex].boundary.GetPosition();
+		const unsigned int childIndex = (collider.GetPosition().x < center.x ? 0 : 1) + (collider.GetPosition().y < center.y ? 0 : 2);
+		const int child = _nodes[nodeIndex].children[childIndex];
+		if (FitsInLooseNode(child, collider) && InsertInLooseNode(child, entryIndex)) {
+			_nodes[nodeIndex].subtreeCount++;
 			return true;
 		}
 	}
+	_nodes[nodeIndex].entries.emplace_back(entryIndex);
+	_nodes[nodeIndex].subtreeCount++;
+	_entries[entryIndex].nodeIndex = nodeIndex;
+	return true;
 }
-//Returns a vector of the objects the collider hit
-template<typename T>
-inline std::vector<T> QuadTree<T>::Query(std::shared_ptr<Collider> range) {
-	_objectsFound.clear();
-	//Checks if the collider is inside the quadtree node
-	if (_quadTreeNode.Intersect(range)) {
-		//Comparing the collider types, this makes the quadtree compadible with both AABB and circle colliders
-		switch (range->GetColliderType()) {
-		case ColliderType::AABB:
-			_boxCollider = std::static_pointer_cast<AABB>(range);
-			for (unsigned int i = 0; i < _objectsInserted.size(); i++) {
-				switch (_colliders[i]->GetColliderType()) {
-				case ColliderType::AABB:
-					if (collisionCheck->AABBIntersect(*_boxCollider, *std::static_pointer_cast<AABB>(_colliders[i]))) {
-						_objectsFound.emplace_back(_objectsInserted[i]);
-					}
-					break;
-				case ColliderType::Circle:
-					if (collisionCheck->AABBCircleIntersect(*_boxCollider, *std::static_pointer_cast<Circle>(_colliders[i]))) {
-						_objectsFound.emplace_back(_objectsInserted[i]);
-					}
-					break;
-				default:
-					break;
-				}
-			}
-			break;
-		case ColliderType::Circle:
-			_circleCollider = std::static_pointer_cast<Circle>(range);
-			for (unsigned int i = 0; i < _objectsInserted.size(); i++) {
-				switch (_colliders[i]->GetColliderType()) {
-				case ColliderType::AABB:
-					if (collisionCheck->AABBCircleIntersect(*std::static_pointer_cast<AABB>(_colliders[i]), *_circleCollider)) {
-						_objectsFound.emplace_back(_objectsInserted[i]);
-					}
-					break;
-				case ColliderType::Circle:
-					if (collisionCheck->CircleIntersect(*_circleCollider, *std::static_pointer_cast<Circle>(_colliders[i]))) {
-						_objectsFound.emplace_back(_objectsInserted[i]);
-					}
-					break;
-				default:
-					break;
-				}
-			}
-			break;
-		default:
+//Checks if the object still belongs to the node, the root keeps every collider whose centre is inside the quadtree
+template<typename T>
+inline bool QuadTree<T>::IsInsideNode(const int nodeIndex, const Collider& collider) {
+	if (_quadTreeType != QuadTreeType::Loose) {
+		return ColliderIntersect(_nodes[nodeIndex].boundary, collider);
+	}
+	const AABB& boundary = _nodes[nodeIndex].boundary;
+	if (collider.GetPosition().x < boundary.GetMin().x || collider.GetPosition().x > boundary.GetMax().x ||
+		collider.GetPosition().y < boundary.GetMin().y || collider.GetPosition().y > boundary.GetMax().y) {
+		return false;
+	}
+	return nodeIndex == _rootIndex || FitsInLooseNode(nodeIndex, collider);
+}
+template<typename T>
+inline bool QuadTree<T>::FitsInLooseNode(const int nodeIndex, const Collider& collider) {
+	const AABB& looseBoundary = _nodes[nodeIndex].looseBoundary;
+	const Vector2<float> halfExtents = collider.GetHalfExtents();
+	return (collider.GetPosition().x - halfExtents.x >= looseBoundary.GetMin().x &&
+		collider.GetPosition().x + halfExtents.x <= looseBoundary.GetMax().x &&
+		collider.GetPosition().y - halfExtents.y >= looseBoundary.GetMin().y &&
+		collider.GetPosition().y + halfExtents.y <= looseBoundary.GetMax().y);
+}
+template<typename T>
+inline void QuadTree<T>::RemoveFromNode(const unsigned int entryIndex) {
+	const int nodeIndex = _entries[entryIndex].nodeIndex;
+	std::vector<unsigned int>& entries = _nodes[nodeIndex].entries;
+	for (unsigned int i = 0; i < entries.size(); i++) {
+		if (entries[i] == entryIndex) {
+			entries[i] = entries.back();
+			entries.pop_back();
 			break;
 		}
+	}
+	_entries[entryIndex].nodeIndex = -1;
 
-		/*If the node has divided, the query function is called from every child
-		Then I insert the queried objects from all the children into the objectsFound vector*/
-		if (_divided) {
-			_objectsFoundInChild.clear();
-			if (_quadTreeChildren[0]) {
-				_objectsFoundInChild = _quadTreeChildren[0]->Query(range);
-				_objectsFound.insert(_objectsFound.end(), _objectsFoundInChild.begin(), _objectsFoundInChild.end());
-			}
-			if (_quadTreeChildren[1]) {
-				_objectsFoundInChild = _quadTreeChildren[1]->Query(range);
-				_objectsFound.insert(_objectsFound.end(), _objectsFoundInChild.begin(), _objectsFoundInChild.end());
-			}
-			if (_quadTreeChildren[2]) {
-				_objectsFoundInChild = _quadTreeChildren[2]->Query(range);
-				_objectsFound.insert(_objectsFound.end(), _objectsFoundInChild.begin(), _objectsFoundInChild.end());
-			}
-			if (_quadTreeChildren[3]) {
-				_objectsFoundInChild = _quadTreeChildren[3]->Query(range);
-				_objectsFound.insert(_objectsFound.end(), _objectsFoundInChild.begin(), _objectsFoundInChild.end());
-			}
+	//Walks up to the root and merges the highest node whose whole subtree fits within its capacity
+	int mergeIndex = -1;
+	for (int i = nodeIndex; i != -1; i = _nodes[i].parent) {
+		_nodes[i].subtreeCount--;
+		if (_nodes[i].divided && _nodes[i].subtreeCount < _capacity) {
+			mergeIndex = i;
 		}
 	}
-	return _objectsFound;
+	if (mergeIndex != -1) {
+		Merge(mergeIndex);
+	}
 }
+/*When dividing, I create 4 children that is a quarter of the size of the current node
+and sets divided to true to prevent the node from calling Subdivide more than once*/
 template<typename T>
-inline void QuadTree<T>::Clear() {
-	_objectsInserted.clear();
-	_colliders.clear();
-	_quadTreeChildren[0] = nullptr;
-	_quadTreeChildren[1] = nullptr;
-	_quadTreeChildren[2] = nullptr;
-	_quadTreeChildren[3] = nullptr;
-	_divided = false;
+inline void QuadTree<T>::Subdivide(const int nodeIndex) {
+	const Vector2<float> position = _nodes[nodeIndex].boundary.GetPosition();
+	const float height = _nodes[nodeIndex].boundary.GetHeight();
+	const float width = _nodes[nodeIndex].boundary.GetWidth();
+	const unsigned int depth = _nodes[nodeIndex].depth + 1;
+
+	const int upperLeft = AllocateNode({ position.x - (width * 0.25f), position.y - (height * 0.25f) }, height * 0.5f, width * 0.5f, nodeIndex, depth);
+	const int upperRight = AllocateNode({ position.x + (width * 0.25f), position.y - (height * 0.25f) }, height * 0.5f, width * 0.5f, nodeIndex, depth);
+	const int lowerLeft = AllocateNode({ position.x - (width * 0.25f), position.y + (height * 0.25f) }, height * 0.5f, width * 0.5f, nodeIndex, depth);
+	const int lowerRight = AllocateNode({ position.x + (width * 0.25f), position.y + (height * 0.25f) }, height * 0.5f, width * 0.5f, nodeIndex, depth);
+	_nodes[nodeIndex].children = { upperLeft, upperRight, lowerLeft, lowerRight };
+	_nodes[nodeIndex].divided = true;
 }
-/*When dividing, I create 4 children that is a quarter of the size of the current node
-and sets devided to true to prevent the node from calling Subdevide more than once*/
-template<typename T>
-inline void QuadTree<T>::Subdivide() {
-	_upperLeft.rectangle = std::make_shared<AABB>();
-	_upperLeft.rectangle->Init({ _quadTreeNode.rectangle->GetPosition().x - (_quadTreeNode.rectangle->GetWidth() * 0.25f),
-		_quadTreeNode.rectangle->GetPosition().y - (_quadTreeNode.rectangle->GetHeight() * 0.25f) },
-		_quadTreeNode.rectangle->GetHeight() * 0.5f, _quadTreeNode.rectangle->GetWidth() * 0.5f);
-	_quadTreeChildren[0] = std::make_shared<QuadTree<T>>(_upperLeft, _capacity);
-
-	_upperRight.rectangle = std::make_shared<AABB>();
-	_upperRight.rectangle->Init({ _quadTreeNode.rectangle->GetPosition().x + (_quadTreeNode.rectangle->GetWidth() * 0.25f),
-		_quadTreeNode.rectangle->GetPosition().y - (_quadTreeNode.rectangle->GetHeight() * 0.25f) },
-		_quadTreeNode.rectangle->GetHeight() * 0.5f, _quadTreeNode.rectangle->GetWidth() * 0.5f);
-	_quadTreeChildren[1] = std::make_shared<QuadTree<T>>(_upperRight, _capacity);
-
-	_lowerLeft.rectangle = std::make_shared<AABB>();
-	_lowerLeft.rectangle->Init({ _quadTreeNode.rectangle->GetPosition().x - (_quadTreeNode.rectangle->GetWidth() * 0.25f),
-		_quadTreeNode.rectangle->GetPosition().y + (_quadTreeNode.rectangle->GetHeight() * 0.25f) },
-		_quadTreeNode.rectangle->GetHeight() * 0.5f, _quadTreeNode.rectangle->GetWidth() * 0.5f);
-	_quadTreeChildren[2] = std::make_shared<QuadTree<T>>(_lowerLeft, _capacity);
-
-	_lowerRight.rectangle = std::make_shared<AABB>();
-	_lowerRight.rectangle->Init({ _quadTreeNode.rectangle->GetPosition().x + (_quadTreeNode.rectangle->GetWidth() * 0.25f),
-		_quadTreeNode.rectangle->GetPosition().y + (_quadTreeNode.rectangle->GetHeight() * 0.25f) },
-		_quadTreeNode.rectangle->GetHeight() * 0.5f, _quadTreeNode.rectangle->GetWidth() * 0.5f);
-	_quadTreeChildren[3] = std::make_shared<QuadTree<T>>(_lowerRight, _capacity);
-	_divided = true;
+//Pulls every object in the children up into the node and returns the children to the free list
+template<typename T>
+inline void QuadTree<T>::Merge(const int nodeIndex) {
+	for (unsigned int i = 0; i < _nodes[nodeIndex].children.size(); i++) {
+		MoveEntriesToNode(_nodes[nodeIndex].children[i], nodeIndex);
+		FreeNode(_nodes[nodeIndex].children[i]);
+	}
+	_nodes[nodeIndex].children = { -1, -1, -1, -1 };
+	_nodes[nodeIndex].divided = false;
+	_nodes[nodeIndex].subtreeCount = _nodes[nodeIndex].entries.size();
 }
 template<typename T>
-inline void QuadTree<T>::Render() {
-	debugDrawer->AddDebugRectangle(_quadTreeNode.rectangle.GetPosition(), _quadTreeNode.rectangle.GetMin(),
-		_quadTreeNode.rectangle.GetMax(), _quadTreeColor);
+inline void QuadTree<T>::MoveEntriesToNode(const int fromNodeIndex, const int toNodeIndex) {
+	for (unsigned int i = 0; i < _nodes[fromNodeIndex].entries.size(); i++) {
+		_entries[_nodes[fromNodeIndex].entries[i]].nodeIndex = toNodeIndex;
+		_nodes[toNodeIndex].entries.emplace_back(_nodes[fromNodeIndex].entries[i]);
+	}
+	_nodes[fromNodeIndex].entries.clear();
+	if (_nodes[fromNodeIndex].divided) {
+		for (unsigned int i = 0; i < _nodes[fromNodeIndex].children.size(); i++) {
+			MoveEntriesToNode(_nodes[fromNodeIndex].children[i], toNodeIndex);
+		}
+	}
+}
+template<typename T>
+template<typename Visitor>
+inline void QuadTree<T>::VisitNode(const int nodeIndex, const Collider& range, const unsigned int& layerMask, unsigned int& candidatesTested, Visitor& visitor) const {
+	//Checks if the collider is inside the quadtree node, for a loose quadtree the enlarged bounds are used
+	const Node& node = _nodes[nodeIndex];
+	if (!ColliderIntersect(node.looseBoundary, range)) {
+		return;
+	}
+	for (unsigned int i = 0; i < node.entries.size(); i++) {
+		const Entry& entry = _entries[node.entries[i]];
+		if ((entry.layer & layerMask) == 0) {
+			continue;
+		}
+		candidatesTested++;
+		if (ColliderIntersect(range, *entry.collider)) {
+			visitor(entry.object);
+		}
+	}
+	//If the node has divided, every child is visited with the same visitor
+	if (node.divided) {
+		for (unsigned int i = 0; i < node.children.size(); i++) {
+			VisitNode(node.children[i], range, layerMask, candidatesTested, visitor);
+		}
+	}
+}
+template<typename T>
+inline void QuadTree<T>::RenderNode(const int nodeIndex) {
+	debugDrawer->AddDebugRectangle(_nodes[nodeIndex].boundary.GetPosition(), _nodes[nodeIndex].boundary.GetMin(),
+		_nodes[nodeIndex].boundary.GetMax(), _quadTreeColor, false);
 
-	for (unsigned int i = 0; i < _quadTreeChildren.size(); i++) {
-		if (_quadTreeChildren[i]) {
-			_quadTreeChildren[i]->Render();
+	if (_nodes[nodeIndex].divided) {
+		for (unsigned int i = 0; i < _nodes[nodeIndex].children.size(); i++) {
+			RenderNode(_nodes[nodeIndex].children[i]);
 		}
 	}
 }
\ No newline at end of file
@@ -3,78 +3,89 @@
 #include "debugDrawer.h"
 #include "gameEngine.h"
 
-RayPoint RayCast::RayCastToAABB(std::shared_ptr<AABB> boxCollider, const Ray& ray) {
-	_rayDirection = ray.startPosition + ray.direction;
-	_rayCastPoint = ClosestPoint(ray, {
-		FindPoint(boxCollider->GetMin(), {boxCollider->GetMin().x, boxCollider->GetMax().y}, ray, _rayDirection),
-		FindPoint({ boxCollider->GetMin().x, boxCollider->GetMax().y }, boxCollider->GetMax(), ray, _rayDirection),
-		FindPoint(boxCollider->GetMin(), { boxCollider->GetMax().x, boxCollider->GetMin().y }, ray, _rayDirection),
-		FindPoint({ boxCollider->GetMax().x, boxCollider->GetMin().y}, boxCollider->GetMax(), ray, _rayDirection)
+RayPoint RayCastToAABB(const AABB& boxCollider, const Ray& ray) {
+	const Vector2<float> rayDirection = ray.startPosition + ray.direction;
+	const RayPoint rayCastPoint = ClosestPoint(ray, {
+		FindPoint(boxCollider.GetMin(), {boxCollider.GetMin().x, boxCollider.GetMax().y}, ray, rayDirection),
+		FindPoint({ boxCollider.GetMin().x, boxCollider.GetMax().y }, boxCollider.GetMax(), ray, rayDirection),
+		FindPoint(boxCollider.GetMin(), { boxCollider.GetMax().x, boxCollider.GetMin().y }, ray, rayDirection),
+		FindPoint({ boxCollider.GetMax().x, boxCollider.GetMin().y}, boxCollider.GetMax(), ray, rayDirection)
 	});
 
-	if (ray.length < Vector2<float>::distanceBetweenVectors(ray.startPosition, _rayCastPoint.position)) {
+	if (ray.length < Vector2<float>::distanceBetweenVectors(ray.startPosition, rayCastPoint.position)) {
 		return RayPoint();
 	}
-	return _rayCastPoint;
+	return rayCastPoint;
 }
 
-RayPoint RayCast::FindPoint(const Vector2<float>& wallStart, const Vector2<float>& wallEnd, const Ray& ray, const Vector2<float>& rayDir) {
-	_denominator = (wallStart.x - wallEnd.x) * (ray.startPosition.y - rayDir.y) -
+RayPoint FindPoint(const Vector2<float>& wallStart, const Vector2<float>& wallEnd, const Ray& ray, const Vector2<float>& rayDir) {
+	const float denominator = (wallStart.x - wallEnd.x) * (ray.startPosition.y - rayDir.y) -
 		(wallStart.y - wallEnd.y) * (ray.startPosition.x - rayDir.x);
-	if (_denominator == 0) {
+	if (denominator == 0) {
 		return RayPoint();
 	}
-	_t = ((wallStart.x - ray.startPosition.x) * (ray.startPosition.y - rayDir.y) -
-		(wallStart.y - ray.startPosition.y) * (ray.startPosition.x - rayDir.x)) / _denominator;
-	_u = -((wallStart.x - wallEnd.x) * (wallStart.y - ray.startPosition.y) -
-		(wallStart.y - wallEnd.y) * (wallStart.x - ray.startPosition.x)) / _denominator;
-	if (_t > 0 && _t < 1 && _u > 0) {
-		_rayPoint.position.x = wallStart.x + _t * (wallEnd.x - wallStart.x);
-		_rayPoint.position.y = wallStart.y + _t * (wallEnd.y - wallStart.y);
-		_rayPoint.pointHit = true;
-		_rayPointNormalA = { wallStart.y - wallEnd.y, wallStart.x - wallEnd.x };
-		_rayPointNormalA.normalize();
-		_rayPointNormalB = { -_rayPointNormalA.x, -_rayPointNormalA.y };
-		if (Vector2<float>::distanceBetweenVectors(ray.startPosition, _rayPoint.position + _rayPointNormalA) <
-			Vector2<float>::distanceBetweenVectors(ray.startPosition, _rayPoint.position + _rayPointNormalB)) {
-			_rayPoint.normal = _rayPointNormalA;
+	const float t = ((wallStart.x - ray.startPosition.x) * (ray.startPosition.y - rayDir.y) -
+		(wallStart.y - ray.startPosition.y) * (ray.startPosition.x - rayDir.x)) / denominator;
+	const float u = -((wallStart.x - wallEnd.x) * (wallStart.y - ray.startPosition.y) -
+		(wallStart.y - wallEnd.y) * (wallStart.x - ray.startPosition.x)) / denominator;
+	if (t > 0 && t < 1 && u > 0) {
+		RayPoint rayPoint;
+		rayPoint.position.x = wallStart.x + t * (wallEnd.x - wallStart.x);
+		rayPoint.position.y = wallStart.y + t * (wallEnd.y - wallStart.y);
+		rayPoint.pointHit = true;
+		Vector2<float> rayPointNormalA = { wallStart.y - wallEnd.y, wallStart.x - wallEnd.x };
+		rayPointNormalA.normalize();
+		const Vector2<float> rayPointNormalB = { -rayPointNormalA.x, -rayPointNormalA.y };
+		if (Vector2<float>::distanceBetweenVectors(ray.startPosition, rayPoint.position + rayPointNormalA) <
+			Vector2<float>::distanceBetweenVectors(ray.startPosition, rayPoint.position + rayPointNormalB)) {
+			rayPoint.normal = rayPointNormalA;
 		} else {
-			_rayPoint.normal = _rayPointNormalB;
+			rayPoint.normal = rayPointNormalB;
 		}
 
-		return _rayPoint;
+		return rayPoint;
 	}
-	_rayPoint.pointHit = false;
-	_rayPoint.normal = { 0.f, 0.f };
-	_rayPoint.position = { 0.f, 0.f };
-	return _rayPoint;
+	return RayPoint();
 }
 
-RayPoint RayCast::ClosestPoint(const Ray& ray, const std::array<RayPoint, 4>& points) {
-	_distanceToWall[0] = Vector2<float>::distanceBetweenVectors(ray.startPosition, points[0].position);
-	_distanceToWall[1] = Vector2<float>::distanceBetweenVectors(ray.startPosition, points[1].position);
-	_distanceToWall[2] = Vector2<float>::distanceBetweenVectors(ray.startPosition, points[2].position);
-	_distanceToWall[3] = Vector2<float>::distanceBetweenVectors(ray.startPosition, points[3].position);
+RayPoint ClosestPoint(const Ray& ray, const std::array<RayPoint, 4>& points) {
+	std::array<float, 4> distanceToWall;
+	distanceToWall[0] = Vector2<float>::distanceBetweenVectors(ray.startPosition, points[0].position);
+	distanceToWall[1] = Vector2<float>::distanceBetweenVectors(ray.startPosition, points[1].position);
+	distanceToWall[2] = Vector2<float>::distanceBetweenVectors(ray.startPosition, points[2].position);
+	distanceToWall[3] = Vector2<float>::distanceBetweenVectors(ray.startPosition, points[3].position);
 	
-	if (_distanceToWall[0] < _distanceToWall[1] && _distanceToWall[0] < _distanceToWall[2] && _distanceToWall[0] < _distanceToWall[3]) {
+	if (distanceToWall[0] < distanceToWall[1] && distanceToWall[0] < distanceToWall[2] && distanceToWall[0] < distanceToWall[3]) {
 		if (points[0].pointHit) {
 			return points[0];
 		}
 	}
-	if (_distanceToWall[1] < _distanceToWall[0] && _distanceToWall[1] < _distanceToWall[2] && _distanceToWall[1] < _distanceToWall[3]) {
+	if (distanceToWall[1] < distanceToWall[0] && distanceToWall[1] < distanceToWall[2] && distanceToWall[1] < distanceToWall[3]) {
 		if (points[1].pointHit) {
 			return points[1];
 		}
 	}
-	if (_distanceToWall[2] < _distanceToWall[0] && _distanceToWall[2] < _distanceToWall[1] && _distanceToWall[2] < _distanceToWall[3]) {
+	if (distanceToWall[2] < distanceToWall[0] && distanceToWall[2] < distanceToWall[1] && distanceToWall[2] < distanceToWall[3]) {
 		if (points[2].pointHit) {
 			return points[2];
 		}
 	}
-	if (_distanceToWall[3] < _distanceToWall[0] && _distanceToWall[3] < _distanceToWall[1] && _distanceToWall[3] < _distanceToWall[2]) {
+	if (distanceToWall[3] < distanceToWall[0] && distanceToWall[3] < distanceToWall[1] && distanceToWall[3] < distanceToWall[2]) {
 		if (points[3].pointHit) {
 			return points[3];
 		}
 	}
 	return RayPoint();
+}
+
+RayPoint RayCast::RayCastToAABB(std::shared_ptr<AABB> boxCollider, const Ray& ray) {
+	return ::RayCastToAABB(*boxCollider, ray);
+}
+
+RayPoint RayCast::FindPoint(const Vector2<float>& wallStart, const Vector2<float>& wallEnd, const Ray& ray, const Vector2<float>& rayDir) {
+	return ::FindPoint(wallStart, wallEnd, ray, rayDir);
+}
+
+RayPoint RayCast::ClosestPoint(const Ray& ray, const std::array<RayPoint, 4>& points) {
+	return ::ClosestPoint(ray, points);
 }
\ No newline at end of file
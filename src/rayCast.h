@@ -3,6 +3,7 @@
 #include "vector2.h"
 
 #include <array>
+#include <memory>
 
 struct RayPoint {
 	Vector2<float> position = { 0.f, 0.f };
@@ -10,6 +11,12 @@ struct RayPoint {
 	bool pointHit = false;	
 };
 
+//Stateless ray casts, they only read their arguments so any number of threads can run them at once
+RayPoint RayCastToAABB(const AABB& boxCollider, const Ray& ray);
+RayPoint FindPoint(const Vector2<float>& wallStart, const Vector2<float>& wallEnd, const Ray& ray, const Vector2<float>& rayDir);
+RayPoint ClosestPoint(const Ray& ray, const std::array<RayPoint, 4>& points);
+
+//Kept for the callers that go through the global rayCast, every cast forwards to the stateless function of the same name
 class RayCast {
 public:
 	RayCast(){}
@@ -20,19 +27,4 @@ public:
 	RayPoint FindPoint(const Vector2<float>& wallStart, const Vector2<float>& wallEnd, const Ray& ray, const Vector2<float>& rayDir);
 	RayPoint ClosestPoint(const Ray& ray, const std::array<RayPoint, 4>& points);
 
-
-private:
-	std::array<float, 4> _distanceToWall = {0.f, 0.f, 0.f, 0.f };
-	RayPoint _rayCastPoint;
-
-	float _denominator = 0.f;
-	float _t = 0.f;
-	float _u = 0.f;
-
-	RayPoint _rayPoint;
-
-	Vector2<float> _rayDirection = { 0.f, 0.f };
-	Vector2<float> _rayPointNormalA = { 0.f, 0.f };
-	Vector2<float> _rayPointNormalB = { 0.f, 0.f };
-
 };
\ No newline at end of file
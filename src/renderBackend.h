@@ -0,0 +1,39 @@
+#pragma once
+#include <SDL2/SDL_pixels.h>
+#include <SDL2/SDL_rect.h>
+
+#include "vector2.h"
+
+//A texture a backend made, handle belongs to the backend and is null when it keeps no pixels
+struct RenderTexture {
+	void* handle = nullptr;
+	int width = 0;
+	int height = 0;
+};
+
+/*Everything the game draws, loads or reads from the window goes through the backend set in renderBackend.
+The SDL backend draws to the window, the null backend draws nothing and only works out the sizes of the textures,
+so the simulation can run in a process that has no window or GPU. The sizes have to match, the colliders are made from them*/
+class RenderBackend {
+public:
+	RenderBackend() {}
+	virtual ~RenderBackend() {}
+
+	virtual const RenderTexture LoadTexture(const char* path) = 0;
+	virtual const RenderTexture CreateTextTexture(const char* fontType, const int& fontSize, const char* text, const SDL_Color& color) = 0;
+	virtual void DestroyTexture(RenderTexture& texture) = 0;
+
+	//source is the part of the texture drawn, nullptr draws all of it
+	virtual void DrawTexture(const RenderTexture& texture, const SDL_Rect* source, const SDL_FRect& destination) = 0;
+	virtual void DrawTextureRotated(const RenderTexture& texture, const SDL_Rect* source, const SDL_FRect& destination, const float& orientation, const SDL_FPoint& center) = 0;
+
+	virtual void SetDrawColor(const SDL_Color& color) = 0;
+	virtual void FillRectangle(const SDL_FRect& rectangle) = 0;
+	virtual void DrawRectangle(const SDL_FRect& rectangle) = 0;
+	virtual void DrawLine(const Vector2<float>& startPosition, const Vector2<float>& endPosition) = 0;
+
+	virtual void Clear(const SDL_Color& color) = 0;
+	virtual void Present() = 0;
+
+	virtual const Vector2<float> GetCursorPosition() = 0;
+};
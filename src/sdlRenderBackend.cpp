@@ -0,0 +1,89 @@
+#include "sdlRenderBackend.h"
+#include "gameEngine.h"
+
+#include <SDL2/SDL_image.h>
+
+SDLRenderBackend::SDLRenderBackend(SDL_Renderer* renderer) : _renderer(renderer) {}
+
+SDLRenderBackend::~SDLRenderBackend() {
+	for (auto& font : _fonts) {
+		TTF_CloseFont(font.second);
+	}
+}
+
+const RenderTexture SDLRenderBackend::LoadTexture(const char* path) {
+	RenderTexture texture;
+	SDL_Texture* sdlTexture = IMG_LoadTexture(_renderer, path);
+	SDL_QueryTexture(sdlTexture, NULL, NULL, &texture.width, &texture.height);
+	texture.handle = sdlTexture;
+	return texture;
+}
+
+const RenderTexture SDLRenderBackend::CreateTextTexture(const char* fontType, const int& fontSize, const char* text, const SDL_Color& color) {
+	RenderTexture texture;
+	SDL_Surface* textSurface = TTF_RenderText_Solid(GetFont(fontType, fontSize), text, color);
+	if (!textSurface) {
+		return texture;
+	}
+	texture.handle = SDL_CreateTextureFromSurface(_renderer, textSurface);
+	texture.width = textSurface->w;
+	texture.height = textSurface->h;
+	SDL_FreeSurface(textSurface);
+	return texture;
+}
+
+void SDLRenderBackend::DestroyTexture(RenderTexture& texture) {
+	if (texture.handle) {
+		SDL_DestroyTexture((SDL_Texture*)texture.handle);
+	}
+	texture = RenderTexture();
+}
+
+void SDLRenderBackend::DrawTexture(const RenderTexture& texture, const SDL_Rect* source, const SDL_FRect& destination) {
+	SDL_RenderCopyF(_renderer, (SDL_Texture*)texture.handle, source, &destination);
+}
+
+//The orientation is in radians, SDL turns the texture in degrees
+void SDLRenderBackend::DrawTextureRotated(const RenderTexture& texture, const SDL_Rect* source, const SDL_FRect& destination, const float& orientation, const SDL_FPoint& center) {
+	SDL_RenderCopyExF(_renderer, (SDL_Texture*)texture.handle, source, &destination, orientation * 180 / PI, &center, SDL_FLIP_NONE);
+}
+
+void SDLRenderBackend::SetDrawColor(const SDL_Color& color) {
+	SDL_SetRenderDrawColor(_renderer, color.r, color.g, color.b, color.a);
+}
+
+void SDLRenderBackend::FillRectangle(const SDL_FRect& rectangle) {
+	SDL_RenderFillRectF(_renderer, &rectangle);
+}
+
+void SDLRenderBackend::DrawRectangle(const SDL_FRect& rectangle) {
+	SDL_RenderDrawRectF(_renderer, &rectangle);
+}
+
+void SDLRenderBackend::DrawLine(const Vector2<float>& startPosition, const Vector2<float>& endPosition) {
+	SDL_RenderDrawLineF(_renderer, startPosition.x, startPosition.y, endPosition.x, endPosition.y);
+}
+
+void SDLRenderBackend::Clear(const SDL_Color& color) {
+	SetDrawColor(color);
+	SDL_RenderClear(_renderer);
+}
+
+void SDLRenderBackend::Present() {
+	SDL_RenderPresent(_renderer);
+}
+
+const Vector2<float> SDLRenderBackend::GetCursorPosition() {
+	int x = 0;
+	int y = 0;
+	SDL_GetMouseState(&x, &y);
+	return Vector2<float>(x, y);
+}
+
+TTF_Font* SDLRenderBackend::GetFont(const char* fontType, const int& fontSize) {
+	const std::string key = std::string(fontType) + ":" + std::to_string(fontSize);
+	if (!_fonts.contains(key)) {
+		_fonts[key] = TTF_OpenFont(fontType, fontSize);
+	}
+	return _fonts[key];
+}
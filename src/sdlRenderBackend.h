@@ -0,0 +1,40 @@
+#pragma once
+#include "renderBackend.h"
+
+#include <SDL2/SDL.h>
+#include <SDL2/SDL_ttf.h>
+
+#include <string>
+#include <unordered_map>
+
+//Draws with an SDL renderer, only the windowed game links it
+class SDLRenderBackend : public RenderBackend {
+public:
+	SDLRenderBackend(SDL_Renderer* renderer);
+	~SDLRenderBackend();
+
+	const RenderTexture LoadTexture(const char* path) override;
+	const RenderTexture CreateTextTexture(const char* fontType, const int& fontSize, const char* text, const SDL_Color& color) override;
+	void DestroyTexture(RenderTexture& texture) override;
+
+	void DrawTexture(const RenderTexture& texture, const SDL_Rect* source, const SDL_FRect& destination) override;
+	void DrawTextureRotated(const RenderTexture& texture, const SDL_Rect* source, const SDL_FRect& destination, const float& orientation, const SDL_FPoint& center) override;
+
+	void SetDrawColor(const SDL_Color& color) override;
+	void FillRectangle(const SDL_FRect& rectangle) override;
+	void DrawRectangle(const SDL_FRect& rectangle) override;
+	void DrawLine(const Vector2<float>& startPosition, const Vector2<float>& endPosition) override;
+
+	void Clear(const SDL_Color& color) override;
+	void Present() override;
+
+	const Vector2<float> GetCursorPosition() override;
+
+private:
+	TTF_Font* GetFont(const char* fontType, const int& fontSize);
+
+	SDL_Renderer* _renderer = nullptr;
+
+	//Every font and size is opened once and shared by the text sprites that use it
+	std::unordered_map<std::string, TTF_Font*> _fonts;
+};
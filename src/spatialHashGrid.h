@@ -0,0 +1,349 @@
+#pragma once
+#include "collision.h"
+#include "spatialIndex.h"
+#include "vector2.h"
+
+#include <algorithm>
+#include <cmath>
+#include <unordered_map>
+#include <vector>
+
+#include "debugDrawer.h"
+#include "gameEngine.h"
+#include "jobSystem.h"
+
+/*Uniform grid over the play area, every object is stored once, in the cell the centre of its collider is in.
+Queries grow their range by the largest half extent stored, so an object reaching into a cell from its neighbour is still found.
+Cells are hashed into one flat array by row and column, positions outside the grid are clamped into the border cells so nothing is dropped.
+Works best when the cell size is close to the size of the colliders stored in it*/
+template<typename T>
+class SpatialHashGrid : public SpatialIndex<T> {
+public:
+	SpatialHashGrid(const AABB& boundary, const float& cellSize);
+	~SpatialHashGrid();
+
+	bool Insert(T object, std::shared_ptr<Collider> collider, const unsigned int& layer) override;
+	bool Remove(const T& object) override;
+	bool Update(const T& object, const std::shared_ptr<Collider>& collider, const unsigned int& layer) override;
+
+	void Query(const std::shared_ptr<Collider>& range, std::vector<T>& objectsFound, const unsigned int& layerMask) override;
+	void QueryNearest(const Vector2<float>& point, const unsigned int& k, const float& maxDistance, std::vector<T>& objectsFound, const unsigned int& layerMask) override;
+
+	template<typename Visitor>
+	void Visit(const Collider& range, const unsigned int& layerMask, Visitor&& visitor);
+
+	void Rebuild() override;
+	void Clear() override;
+	void Render() override;
+
+	const SpatialIndexType GetSpatialIndexType() const override;
+	const unsigned int GetNumberOfObjects() const override;
+	const float GetCellSize() const;
+
+	const std::shared_ptr<Collider> FindCollider(const T& object) const override;
+
+private:
+	struct CellRange {
+		int minColumn = 0;
+		int minRow = 0;
+		int maxColumn = -1;
+		int maxRow = -1;
+	};
+
+	struct Entry {
+		T object;
+		std::shared_ptr<Collider> collider = nullptr;
+		unsigned int layer = 0;
+		//The cell the centre of the collider is in, the only cell the entry is stored in
+		int centreCell = -1;
+	};
+
+	const CellRange GetCellRange(const Collider& collider, const Vector2<float>& padding) const;
+	const int GetCellIndex(const int column, const int row) const;
+	const int GetCentreCell(const Collider& collider) const;
+
+	void AddToCell(const unsigned int entryIndex);
+	void RemoveFromCell(const unsigned int entryIndex);
+	void GrowMaxHalfExtents(const Collider& collider);
+
+	AABB _boundary;
+	float _cellSize = 0.f;
+	float _inverseCellSize = 0.f;
+	int _columns = 0;
+	int _rows = 0;
+
+	std::vector<std::vector<unsigned int>> _cells;
+
+	std::vector<Entry> _entries;
+	std::vector<unsigned int> _freeEntries;
+	std::unordered_map<T, unsigned int> _entryIndices;
+
+	//Largest half extents of the stored colliders, only grows between rebuilds
+	Vector2<float> _maxHalfExtents = { 0.f, 0.f };
+
+	//Centre cell of every entry as the last rebuild found it, written by the workers and compared after they finish
+	std::vector<int> _rebuildCentreCells;
+	static constexpr unsigned int _entriesPerJob = 256;
+
+	SDL_Color _gridColor = { 0, 125, 255, 255 };
+
+};
+template<typename T>
+inline SpatialHashGrid<T>::SpatialHashGrid(const AABB& boundary, const float& cellSize) {
+	_boundary = boundary;
+	_cellSize = cellSize;
+	_inverseCellSize = 1.f / cellSize;
+	_columns = std::max(1, (int)std::ceil(boundary.GetWidth() * _inverseCellSize));
+	_rows = std::max(1, (int)std::ceil(boundary.GetHeight() * _inverseCellSize));
+	_cells.resize(_columns * _rows);
+}
+template<typename T>
+inline SpatialHashGrid<T>::~SpatialHashGrid() {
+	Clear();
+}
+template<typename T>
+inline bool SpatialHashGrid<T>::Insert(T object, std::shared_ptr<Collider> collider, const unsigned int& layer) {
+	if (_entryIndices.contains(object)) {
+		return Update(object, collider, layer);
+	}
+	unsigned int entryIndex = 0;
+	if (_freeEntries.empty()) {
+		entryIndex = _entries.size();
+		_entries.emplace_back();
+	} else {
+		entryIndex = _freeEntries.back();
+		_freeEntries.pop_back();
+	}
+	_entries[entryIndex].object = object;
+	_entries[entryIndex].collider = collider;
+	_entries[entryIndex].layer = layer;
+	_entries[entryIndex].centreCell = GetCentreCell(*collider);
+	AddToCell(entryIndex);
+	GrowMaxHalfExtents(*collider);
+	_entryIndices.insert(std::make_pair(object, entryIndex));
+	return true;
+}
+template<typename T>
+inline bool SpatialHashGrid<T>::Remove(const T& object) {
+	auto entry = _entryIndices.find(object);
+	if (entry == _entryIndices.end()) {
+		return false;
+	}
+	const unsigned int entryIndex = entry->second;
+	_entryIndices.erase(entry);
+	RemoveFromCell(entryIndex);
+
+	_entries[entryIndex] = Entry();
+	_freeEntries.emplace_back(entryIndex);
+	return true;
+}
+//Only touches the cells when the centre of the collider moved into a different cell
+template<typename T>
+inline bool SpatialHashGrid<T>::Update(const T& object, const std::shared_ptr<Collider>& collider, const unsigned int& layer) {
+	auto entry = _entryIndices.find(object);
+	if (entry == _entryIndices.end()) {
+		return Insert(object, collider, layer);
+	}
+	const unsigned int entryIndex = entry->second;
+	_entries[entryIndex].collider = collider;
+	_entries[entryIndex].layer = layer;
+	GrowMaxHalfExtents(*collider);
+	const int centreCell = GetCentreCell(*collider);
+	if (centreCell == _entries[entryIndex].centreCell) {
+		return true;
+	}
+	RemoveFromCell(entryIndex);
+	_entries[entryIndex].centreCell = centreCell;
+	AddToCell(entryIndex);
+	return true;
+}
+//Appends the objects the collider hit to objectsFound, the caller owns the buffer so it can be reused every frame
+template<typename T>
+inline void SpatialHashGrid<T>::Query(const std::shared_ptr<Collider>& range, std::vector<T>& objectsFound, const unsigned int& layerMask) {
+	Visit(*range, layerMask, [&objectsFound](const T& object) {
+		objectsFound.emplace_back(object);
+	});
+}
+/*Calls the visitor once for every object the collider hit.
+Every object is in exactly one cell, so each one is tested once without marking it and the query never writes to the grid*/
+template<typename T>
+template<typename Visitor>
+inline void SpatialHashGrid<T>::Visit(const Collider& range, const unsigned int& layerMask, Visitor&& visitor) {
+	unsigned int candidatesTested = 0;
+	const CellRange cellRange = GetCellRange(range, _maxHalfExtents);
+	for (int row = cellRange.minRow; row <= cellRange.maxRow; row++) {
+		for (int column = cellRange.minColumn; column <= cellRange.maxColumn; column++) {
+			const std::vector<unsigned int>& cell = _cells[GetCellIndex(column, row)];
+			for (unsigned int i = 0; i < cell.size(); i++) {
+				const Entry& entry = _entries[cell[i]];
+				if ((entry.layer & layerMask) == 0) {
+					continue;
+				}
+				candidatesTested++;
+				if (ColliderIntersect(range, *entry.collider)) {
+					visitor(entry.object);
+				}
+			}
+		}
+	}
+	this->_candidatesTested += candidatesTested;
+	this->_queriesMade++;
+}
+/*Searches the cells in square rings around the cell of the point and stops once the next ring is farther away than the k found.
+A ring is at least one cell size farther out than the previous one, and the centre of every object in it is at least that far away*/
+template<typename T>
+inline void SpatialHashGrid<T>::QueryNearest(const Vector2<float>& point, const unsigned int& k, const float& maxDistance, std::vector<T>& objectsFound, const unsigned int& layerMask) {
+	this->_queriesMade++;
+	if (k == 0) {
+		return;
+	}
+	thread_local std::vector<typename SpatialIndex<T>::NearestCandidate> nearest;
+	unsigned int candidatesTested = 0;
+	const float maxDistanceSquared = maxDistance * maxDistance;
+	const int pointColumn = std::clamp((int)std::floor((point.x - _boundary.GetMin().x) * _inverseCellSize), 0, _columns - 1);
+	const int pointRow = std::clamp((int)std::floor((point.y - _boundary.GetMin().y) * _inverseCellSize), 0, _rows - 1);
+	const int lastRing = std::max(_columns, _rows);
+	nearest.clear();
+	for (int ring = 0; ring <= lastRing; ring++) {
+		const float ringDistance = std::max(0, ring - 1) * _cellSize;
+		if (ringDistance * ringDistance > maxDistanceSquared || (nearest.size() == k && ringDistance * ringDistance >= nearest.front().distanceSquared)) {
+			break;
+		}
+		for (int row = std::max(0, pointRow - ring); row <= std::min(_rows - 1, pointRow + ring); row++) {
+			//The top and bottom row of the ring are walked in full, the rows in between only have their two end cells
+			const bool fullRow = row == pointRow - ring || row == pointRow + ring;
+			const int columnStep = fullRow ? 1 : std::max(1, 2 * ring);
+			for (int column = pointColumn - ring; column <= pointColumn + ring; column += columnStep) {
+				if (column < 0 || column >= _columns) {
+					continue;
+				}
+				const std::vector<unsigned int>& cell = _cells[GetCellIndex(column, row)];
+				for (unsigned int i = 0; i < cell.size(); i++) {
+					const Entry& entry = _entries[cell[i]];
+					if ((entry.layer & layerMask) == 0) {
+						continue;
+					}
+					candidatesTested++;
+					const Vector2<float> delta = entry.collider->GetPosition() - point;
+					const float distanceSquared = delta.x * delta.x + delta.y * delta.y;
+					if (distanceSquared <= maxDistanceSquared) {
+						SpatialIndex<T>::OfferNearest(nearest, k, distanceSquared, entry.object);
+					}
+				}
+			}
+		}
+	}
+	this->_candidatesTested += candidatesTested;
+	SpatialIndex<T>::AppendNearest(nearest, objectsFound);
+}
+/*Re-reads every stored collider and moves the entries whose centre changed cell, the others are left where they are.
+The centre cells are found in parallel, then the few entries that moved are re-binned on the calling thread*/
+template<typename T>
+inline void SpatialHashGrid<T>::Rebuild() {
+	_rebuildCentreCells.resize(_entries.size());
+	jobSystem->ParallelFor(_entries.size(), _entriesPerJob, [this](const unsigned int firstEntry, const unsigned int lastEntry) {
+		for (unsigned int i = firstEntry; i < lastEntry; i++) {
+			if (_entries[i].collider) {
+				_rebuildCentreCells[i] = GetCentreCell(*_entries[i].collider);
+			}
+		}
+	});
+	_maxHalfExtents = { 0.f, 0.f };
+	for (unsigned int i = 0; i < _entries.size(); i++) {
+		if (!_entries[i].collider) {
+			continue;
+		}
+		GrowMaxHalfExtents(*_entries[i].collider);
+		if (_rebuildCentreCells[i] != _entries[i].centreCell) {
+			RemoveFromCell(i);
+			_entries[i].centreCell = _rebuildCentreCells[i];
+			AddToCell(i);
+		}
+	}
+}
+//Empties every cell but keeps their capacity for the next time they are filled
+template<typename T>
+inline void SpatialHashGrid<T>::Clear() {
+	for (unsigned int i = 0; i < _cells.size(); i++) {
+		_cells[i].clear();
+	}
+	_entries.clear();
+	_freeEntries.clear();
+	_entryIndices.clear();
+	_rebuildCentreCells.clear();
+	_maxHalfExtents = { 0.f, 0.f };
+}
+//Draws the cells that currently hold objects
+template<typename T>
+inline void SpatialHashGrid<T>::Render() {
+	for (int row = 0; row < _rows; row++) {
+		for (int column = 0; column < _columns; column++) {
+			if (_cells[GetCellIndex(column, row)].empty()) {
+				continue;
+			}
+			Vector2<float> min = { _boundary.GetMin().x + column * _cellSize, _boundary.GetMin().y + row * _cellSize };
+			Vector2<float> max = { min.x + _cellSize, min.y + _cellSize };
+			debugDrawer->AddDebugRectangle((min + max) * 0.5f, min, max, _gridColor, false);
+		}
+	}
+}
+template<typename T>
+inline const SpatialIndexType SpatialHashGrid<T>::GetSpatialIndexType() const {
+	return SpatialIndexType::SpatialHashGrid;
+}
+template<typename T>
+inline const unsigned int SpatialHashGrid<T>::GetNumberOfObjects() const {
+	return _entryIndices.size();
+}
+template<typename T>
+inline const float SpatialHashGrid<T>::GetCellSize() const {
+	return _cellSize;
+}
+template<typename T>
+inline const std::shared_ptr<Collider> SpatialHashGrid<T>::FindCollider(const T& object) const {
+	auto entry = _entryIndices.find(object);
+	if (entry == _entryIndices.end()) {
+		return nullptr;
+	}
+	return _entries[entry->second].collider;
+}
+template<typename T>
+inline const typename SpatialHashGrid<T>::CellRange SpatialHashGrid<T>::GetCellRange(const Collider& collider, const Vector2<float>& padding) const {
+	const Vector2<float> halfExtents = collider.GetHalfExtents() + padding;
+	CellRange cellRange;
+	cellRange.minColumn = std::clamp((int)std::floor((collider.GetPosition().x - halfExtents.x - _boundary.GetMin().x) * _inverseCellSize), 0, _columns - 1);
+	cellRange.minRow = std::clamp((int)std::floor((collider.GetPosition().y - halfExtents.y - _boundary.GetMin().y) * _inverseCellSize), 0, _rows - 1);
+	cellRange.maxColumn = std::clamp((int)std::floor((collider.GetPosition().x + halfExtents.x - _boundary.GetMin().x) * _inverseCellSize), 0, _columns - 1);
+	cellRange.maxRow = std::clamp((int)std::floor((collider.GetPosition().y + halfExtents.y - _boundary.GetMin().y) * _inverseCellSize), 0, _rows - 1);
+	return cellRange;
+}
+template<typename T>
+inline const int SpatialHashGrid<T>::GetCellIndex(const int column, const int row) const {
+	return row * _columns + column;
+}
+template<typename T>
+inline const int SpatialHashGrid<T>::GetCentreCell(const Collider& collider) const {
+	const int column = std::clamp((int)std::floor((collider.GetPosition().x - _boundary.GetMin().x) * _inverseCellSize), 0, _columns - 1);
+	const int row = std::clamp((int)std::floor((collider.GetPosition().y - _boundary.GetMin().y) * _inverseCellSize), 0, _rows - 1);
+	return GetCellIndex(column, row);
+}
+template<typename T>
+inline void SpatialHashGrid<T>::AddToCell(const unsigned int entryIndex) {
+	_cells[_entries[entryIndex].centreCell].emplace_back(entryIndex);
+}
+//Swaps the entry with the last one in the cell, the order inside a cell does not matter
+template<typename T>
+inline void SpatialHashGrid<T>::RemoveFromCell(const unsigned int entryIndex) {
+	std::vector<unsigned int>& cell = _cells[_entries[entryIndex].centreCell];
+	auto entry = std::find(cell.begin(), cell.end(), entryIndex);
+	if (entry != cell.end()) {
+		*entry = cell.back();
+		cell.pop_back();
+	}
+}
+template<typename T>
+inline void SpatialHashGrid<T>::GrowMaxHalfExtents(const Collider& collider) {
+	const Vector2<float> halfExtents = collider.GetHalfExtents();
+	_maxHalfExtents.x = std::max(_maxHalfExtents.x, halfExtents.x);
+	_maxHalfExtents.y = std::max(_maxHalfExtents.y, halfExtents.y);
+}
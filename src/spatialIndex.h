@@ -0,0 +1,349 @@
+#pragma once
+#include "collision.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <memory>
+#include <vector>
+
+#include "gameEngine.h"
+#include "jobSystem.h"
+
+enum class SpatialIndexType {
+	QuadTree,
+	LooseQuadTree,
+	SpatialHashGrid,
+	BoundingVolumeHierarchy,
+	LinearQuadTree,
+	Layered,
+	Count
+};
+
+//Query mask that accepts every layer
+const unsigned int allCollisionLayers = 0xffffffff;
+
+//The first object a ray query hit, position and normal are where the ray entered its collider
+template<typename T>
+struct RayHit {
+	T object;
+	Vector2<float> position = { 0.f, 0.f };
+	Vector2<float> normal = { 0.f, 0.f };
+	float distance = 0.f;
+	bool hit = false;
+};
+
+//An object a swept circle touches, timeOfImpact is the fraction of the movement done when it first touches it
+template<typename T>
+struct SweepHit {
+	T object;
+	float timeOfImpact = 0.f;
+};
+
+//One nearest neighbour query in a batch
+struct NearestQuery {
+	Vector2<float> point = { 0.f, 0.f };
+	float maxDistance = 0.f;
+	unsigned int k = 0;
+	unsigned int layerMask = allCollisionLayers;
+};
+
+//Where the results of one query in a batch start in the shared output and how many there are
+struct QueryResultRange {
+	unsigned int first = 0;
+	unsigned int count = 0;
+};
+
+/*Common surface of the structures that store objects by their colliders, so every index can pick its own backend.
+Every object is stored with a layer bit and queries take a mask of the layers they want, the other entries are skipped before the narrow phase.
+Visit is a template and lives on each backend, code that holds a SpatialIndex queries through Query with a reused buffer.
+The queries only read the index, so any number of threads can run them at once as long as nothing is inserted, removed or rebuilt*/
+template<typename T>
+class SpatialIndex {
+public:
+	SpatialIndex() {}
+	virtual ~SpatialIndex() {}
+
+	virtual bool Insert(T object, std::shared_ptr<Collider> collider, const unsigned int& layer) = 0;
+	virtual bool Remove(const T& object) = 0;
+	virtual bool Update(const T& object, const std::shared_ptr<Collider>& collider, const unsigned int& layer) = 0;
+
+	virtual void Query(const std::shared_ptr<Collider>& range, std::vector<T>& objectsFound, const unsigned int& layerMask) = 0;
+	virtual void QueryNearest(const Vector2<float>& point, const unsigned int& k, const float& maxDistance, std::vector<T>& objectsFound, const unsigned int& layerMask);
+	virtual const RayHit<T> RayQuery(const Ray& ray, const unsigned int& layerMask);
+	void SweepQuery(const Circle& circle, const Vector2<float>& displacement, std::vector<SweepHit<T>>& hits, const unsigned int& layerMask);
+
+	void QueryNearestBatch(const std::vector<NearestQuery>& queries, std::vector<T>& objectsFound, std::vector<QueryResultRange>& resultRanges);
+
+	virtual void Rebuild() = 0;
+	virtual void Clear() = 0;
+	virtual void Render() = 0;
+
+	virtual const SpatialIndexType GetSpatialIndexType() const = 0;
+	virtual const unsigned int GetNumberOfObjects() const = 0;
+
+	virtual const unsigned int GetCandidatesTested() const;
+	const float GetCandidatesPerQuery() const;
+	virtual void ResetStatistics();
+
+	virtual const std::shared_ptr<Collider> FindCollider(const T& object) const = 0;
+
+	static bool RayIntersectsBounds(const Ray& ray, const Vector2<float>& min, const Vector2<float>& max);
+	static bool RayIntersectsBounds(const Ray& ray, const Vector2<float>& min, const Vector2<float>& max, float& distance);
+	static bool RayCastCollider(const Ray& ray, const Collider& collider, float& distance, Vector2<float>& normal);
+
+protected:
+	struct NearestCandidate {
+		float distanceSquared = 0.f;
+		T object;
+	};
+
+	static void OfferNearest(std::vector<NearestCandidate>& nearest, const unsigned int& k, const float& distanceSquared, const T& object);
+	static void AppendNearest(std::vector<NearestCandidate>& nearest, std::vector<T>& objectsFound);
+	static const float DistanceSquaredToBounds(const Vector2<float>& point, const Vector2<float>& min, const Vector2<float>& max);
+
+	static bool ClipRayAxis(const float& start, const float& direction, const float& min, const float& max, float& tMin, float& tMax);
+	static bool RayCastBounds(const Ray& ray, const Vector2<float>& min, const Vector2<float>& max, float& distance, Vector2<float>& normal);
+	static bool RayCastCircle(const Ray& ray, const Vector2<float>& centre, const float& radius, float& distance, Vector2<float>& normal);
+
+	//Counted once per query so the queries of a batch can add to them from several threads
+	std::atomic<unsigned int> _candidatesTested = 0;
+	std::atomic<unsigned int> _queriesMade = 0;
+
+private:
+	//Small enough to spread a wave over every core, large enough that a worker is not started for a handful of queries
+	static constexpr unsigned int _queriesPerBatchJob = 64;
+
+};
+/*Appends up to k objects whose collider centre lies within maxDistance of the point, nearest first.
+Backends without a best first traversal query the circle around the point and keep the k nearest of the result*/
+template<typename T>
+inline void SpatialIndex<T>::QueryNearest(const Vector2<float>& point, const unsigned int& k, const float& maxDistance, std::vector<T>& objectsFound, const unsigned int& layerMask) {
+	if (k == 0) {
+		return;
+	}
+	//Every thread running queries keeps its own scratch
+	thread_local std::shared_ptr<Circle> nearestBounds = std::make_shared<Circle>();
+	thread_local std::vector<T> candidates;
+	thread_local std::vector<NearestCandidate> nearest;
+	nearestBounds->Init(point, maxDistance);
+	candidates.clear();
+	Query(nearestBounds, candidates, layerMask);
+
+	const float maxDistanceSquared = maxDistance * maxDistance;
+	nearest.clear();
+	for (unsigned int i = 0; i < candidates.size(); i++) {
+		const Vector2<float> delta = FindCollider(candidates[i])->GetPosition() - point;
+		const float distanceSquared = delta.x * delta.x + delta.y * delta.y;
+		if (distanceSquared <= maxDistanceSquared) {
+			OfferNearest(nearest, k, distanceSquared, candidates[i]);
+		}
+	}
+	AppendNearest(nearest, objectsFound);
+}
+/*Returns the first collider the ray segment hits.
+Backends without an ordered ray traversal query the box around the segment and ray cast every object in it*/
+template<typename T>
+inline const RayHit<T> SpatialIndex<T>::RayQuery(const Ray& ray, const unsigned int& layerMask) {
+	thread_local std::shared_ptr<AABB> rayBounds = std::make_shared<AABB>();
+	thread_local std::vector<T> candidates;
+	const Vector2<float> rayEnd = ray.startPosition + ray.direction * ray.length;
+	rayBounds->Init((ray.startPosition + rayEnd) * 0.5f, std::abs(rayEnd.y - ray.startPosition.y), std::abs(rayEnd.x - ray.startPosition.x));
+	candidates.clear();
+	Query(rayBounds, candidates, layerMask);
+
+	RayHit<T> rayHit;
+	float distance = 0.f;
+	Vector2<float> normal = { 0.f, 0.f };
+	for (unsigned int i = 0; i < candidates.size(); i++) {
+		if (RayCastCollider(ray, *FindCollider(candidates[i]), distance, normal) && (!rayHit.hit || distance < rayHit.distance)) {
+			rayHit.object = candidates[i];
+			rayHit.distance = distance;
+			rayHit.normal = normal;
+			rayHit.hit = true;
+		}
+	}
+	if (rayHit.hit) {
+		rayHit.position = ray.startPosition + ray.direction * rayHit.distance;
+	}
+	return rayHit;
+}
+/*Appends every object the circle touches while it moves by displacement, first touched first.
+Queries the box around the start and end of the movement and finds the time of impact of every object in it, so a fast circle cannot pass through an object between two ticks*/
+template<typename T>
+inline void SpatialIndex<T>::SweepQuery(const Circle& circle, const Vector2<float>& displacement, std::vector<SweepHit<T>>& hits, const unsigned int& layerMask) {
+	thread_local std::shared_ptr<AABB> sweptBounds = std::make_shared<AABB>();
+	thread_local std::vector<T> candidates;
+	const float radius = circle.GetRadius();
+	sweptBounds->Init(circle.GetPosition() + displacement * 0.5f, std::abs(displacement.y) + radius * 2.f, std::abs(displacement.x) + radius * 2.f);
+	candidates.clear();
+	Query(sweptBounds, candidates, layerMask);
+
+	const unsigned int firstHit = hits.size();
+	SweepHit<T> sweepHit;
+	for (unsigned int i = 0; i < candidates.size(); i++) {
+		if (SweptCircleIntersect(circle, displacement, *FindCollider(candidates[i]), sweepHit.timeOfImpact)) {
+			sweepHit.object = candidates[i];
+			hits.emplace_back(sweepHit);
+		}
+	}
+	std::stable_sort(hits.begin() + firstHit, hits.end(), [](const SweepHit<T>& hitA, const SweepHit<T>& hitB) {
+		return hitA.timeOfImpact < hitB.timeOfImpact;
+	});
+}
+/*Runs every nearest neighbour query on the worker threads and joins the results in the order of the queries, every query keeps its own k, distance and mask.
+The results of queries[i] are objectsFound[resultRanges[i].first] up to resultRanges[i].count objects later.
+Each call keeps its own outputs, so batches on the same index can run at once*/
+template<typename T>
+inline void SpatialIndex<T>::QueryNearestBatch(const std::vector<NearestQuery>& queries, std::vector<T>& objectsFound, std::vector<QueryResultRange>& resultRanges) {
+	const unsigned int queryCount = queries.size();
+	resultRanges.resize(queryCount);
+	//One output per job of the ParallelFor, every job writes to its own output and its own part of resultRanges
+	std::vector<std::vector<T>> jobObjectsFound((queryCount + _queriesPerBatchJob - 1) / _queriesPerBatchJob);
+	jobSystem->ParallelFor(queryCount, _queriesPerBatchJob, [this, &queries, &resultRanges, &jobObjectsFound](const unsigned int firstQuery, const unsigned int lastQuery) {
+		std::vector<T>& objectsFoundByJob = jobObjectsFound[firstQuery / _queriesPerBatchJob];
+		for (unsigned int i = firstQuery; i < lastQuery; i++) {
+			resultRanges[i].first = objectsFoundByJob.size();
+			QueryNearest(queries[i].point, queries[i].k, queries[i].maxDistance, objectsFoundByJob, queries[i].layerMask);
+			resultRanges[i].count = objectsFoundByJob.size() - resultRanges[i].first;
+		}
+	});
+	//Joining in job order keeps the results in the order of the queries
+	for (unsigned int i = 0; i < jobObjectsFound.size(); i++) {
+		const unsigned int offset = objectsFound.size();
+		const unsigned int firstQuery = i * _queriesPerBatchJob;
+		for (unsigned int j = firstQuery; j < std::min(queryCount, firstQuery + _queriesPerBatchJob); j++) {
+			resultRanges[j].first += offset;
+		}
+		objectsFound.insert(objectsFound.end(), jobObjectsFound[i].begin(), jobObjectsFound[i].end());
+	}
+}
+template<typename T>
+inline const unsigned int SpatialIndex<T>::GetCandidatesTested() const {
+	return _candidatesTested;
+}
+//Returns how many colliders the narrow phase tested per query since the statistics were reset
+template<typename T>
+inline const float SpatialIndex<T>::GetCandidatesPerQuery() const {
+	if (_queriesMade == 0) {
+		return 0.f;
+	}
+	return (float)GetCandidatesTested() / (float)_queriesMade;
+}
+template<typename T>
+inline void SpatialIndex<T>::ResetStatistics() {
+	_candidatesTested = 0;
+	_queriesMade = 0;
+}
+//Slab test, checks if the ray segment overlaps the box between min and max
+template<typename T>
+inline bool SpatialIndex<T>::RayIntersectsBounds(const Ray& ray, const Vector2<float>& min, const Vector2<float>& max) {
+	float distance = 0.f;
+	return RayIntersectsBounds(ray, min, max, distance);
+}
+//Also gives the distance along the ray where it enters the box, 0 when it starts inside
+template<typename T>
+inline bool SpatialIndex<T>::RayIntersectsBounds(const Ray& ray, const Vector2<float>& min, const Vector2<float>& max, float& distance) {
+	float tMin = 0.f;
+	float tMax = ray.length;
+	if (!ClipRayAxis(ray.startPosition.x, ray.direction.x, min.x, max.x, tMin, tMax) ||
+		!ClipRayAxis(ray.startPosition.y, ray.direction.y, min.y, max.y, tMin, tMax)) {
+		return false;
+	}
+	distance = tMin;
+	return true;
+}
+//Exact ray cast against a collider, the direction of the ray has to be normalized
+template<typename T>
+inline bool SpatialIndex<T>::RayCastCollider(const Ray& ray, const Collider& collider, float& distance, Vector2<float>& normal) {
+	switch (collider.GetColliderType()) {
+	case ColliderType::AABB:
+		return RayCastBounds(ray, collider.GetPosition() - collider.GetHalfExtents(), collider.GetPosition() + collider.GetHalfExtents(), distance, normal);
+	case ColliderType::Circle:
+		return RayCastCircle(ray, collider.GetPosition(), static_cast<const Circle&>(collider).GetRadius(), distance, normal);
+	default:
+		return false;
+	}
+}
+//Keeps the k nearest candidates in a max heap, so the farthest one is the first to be replaced
+template<typename T>
+inline void SpatialIndex<T>::OfferNearest(std::vector<NearestCandidate>& nearest, const unsigned int& k, const float& distanceSquared, const T& object) {
+	auto isNearer = [](const NearestCandidate& candidateA, const NearestCandidate& candidateB) {
+		return candidateA.distanceSquared < candidateB.distanceSquared;
+	};
+	if (nearest.size() < k) {
+		nearest.emplace_back(NearestCandidate{ distanceSquared, object });
+		std::push_heap(nearest.begin(), nearest.end(), isNearer);
+		return;
+	}
+	if (distanceSquared >= nearest.front().distanceSquared) {
+		return;
+	}
+	std::pop_heap(nearest.begin(), nearest.end(), isNearer);
+	nearest.back() = NearestCandidate{ distanceSquared, object };
+	std::push_heap(nearest.begin(), nearest.end(), isNearer);
+}
+//Sorts the heap nearest first and appends it to objectsFound
+template<typename T>
+inline void SpatialIndex<T>::AppendNearest(std::vector<NearestCandidate>& nearest, std::vector<T>& objectsFound) {
+	std::sort_heap(nearest.begin(), nearest.end(), [](const NearestCandidate& candidateA, const NearestCandidate& candidateB) {
+		return candidateA.distanceSquared < candidateB.distanceSquared;
+	});
+	for (unsigned int i = 0; i < nearest.size(); i++) {
+		objectsFound.emplace_back(nearest[i].object);
+	}
+	nearest.clear();
+}
+//Lower bound of the distance from the point to anything inside the box
+template<typename T>
+inline const float SpatialIndex<T>::DistanceSquaredToBounds(const Vector2<float>& point, const Vector2<float>& min, const Vector2<float>& max) {
+	const float deltaX = std::max({ min.x - point.x, 0.f, point.x - max.x });
+	const float deltaY = std::max({ min.y - point.y, 0.f, point.y - max.y });
+	return deltaX * deltaX + deltaY * deltaY;
+}
+template<typename T>
+inline bool SpatialIndex<T>::ClipRayAxis(const float& start, const float& direction, const float& min, const float& max, float& tMin, float& tMax) {
+	if (std::abs(direction) < rayParallelThreshold) {
+		//The ray runs parallel to the slab and has to start inside it
+		return start >= min && start <= max;
+	}
+	const float inverseDirection = 1.f / direction;
+	float tNear = (min - start) * inverseDirection;
+	float tFar = (max - start) * inverseDirection;
+	if (tNear > tFar) {
+		std::swap(tNear, tFar);
+	}
+	tMin = std::max(tMin, tNear);
+	tMax = std::min(tMax, tFar);
+	return tMin <= tMax;
+}
+//Slab test that also gives the normal of the side the ray entered through, see RayIntersect
+template<typename T>
+inline bool SpatialIndex<T>::RayCastBounds(const Ray& ray, const Vector2<float>& min, const Vector2<float>& max, float& distance, Vector2<float>& normal) {
+	return RayIntersect(ray, BoxShape{ min.x, min.y, max.x, max.y }, distance, normal);
+}
+//Same rules as the box, a ray starting inside the circle hits where it leaves it
+template<typename T>
+inline bool SpatialIndex<T>::RayCastCircle(const Ray& ray, const Vector2<float>& centre, const float& radius, float& distance, Vector2<float>& normal) {
+	const Vector2<float> offset = ray.startPosition - centre;
+	const float projection = offset.x * ray.direction.x + offset.y * ray.direction.y;
+	const float startDistance = offset.x * offset.x + offset.y * offset.y - radius * radius;
+	if (startDistance > 0.f && projection > 0.f) {
+		//Starts outside and points away
+		return false;
+	}
+	const float discriminant = projection * projection - startDistance;
+	if (discriminant < 0.f || radius <= 0.f) {
+		return false;
+	}
+	const bool startsInside = startDistance <= 0.f;
+	distance = startsInside ? -projection + std::sqrt(discriminant) : -projection - std::sqrt(discriminant);
+	if (distance < 0.f || distance > ray.length) {
+		return false;
+	}
+	normal = (ray.startPosition + ray.direction * distance - centre) * (1.f / radius);
+	if (startsInside) {
+		normal = normal * -1.f;
+	}
+	return true;
+}
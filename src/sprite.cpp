@@ -2,27 +2,28 @@
 #include "gameEngine.h"
 
 void Sprite::Load(const char* path) {
-	_texture = IMG_LoadTexture(renderer, path);
-	SDL_QueryTexture(_texture, NULL, NULL, &_widthI, &_heightI);
+	_texture = renderBackend->LoadTexture(path);
+	_widthI = _texture.width;
+	_heightI = _texture.height;
 	_widthF = _widthI;
 	_heightF = _heightI;
 }
 
-void Sprite::Render(const int& spriteIndex, const Vector2<float>& position) {
+void Sprite::Render(const int&, const Vector2<float>& position) {
 	_rect = { position.x, position.y, _widthF, _heightF };	
-	SDL_RenderCopyF(renderer, _texture, NULL, &_rect);
+	renderBackend->DrawTexture(_texture, nullptr, _rect);
 }
 
-void Sprite::RenderCentered(const int& spriteIndex, const Vector2<float>& position) {
+void Sprite::RenderCentered(const int&, const Vector2<float>& position) {
 	_rect = { position.x - _widthF / 2, position.y - _heightF / 2, _widthF, _heightF };
-	SDL_RenderCopyF(renderer, _texture, nullptr, &_rect);
+	renderBackend->DrawTexture(_texture, nullptr, _rect);
 }
 
-void Sprite::RenderWithOrientation(const int& spriteIndex, const Vector2<float>& position, const float& orientation) {
+void Sprite::RenderWithOrientation(const int&, const Vector2<float>& position, const float& orientation) {
 	_rectCopy = { 0, 0, _widthI, _heightI };
 	_rectDest = { position.x - _widthF / 2, position.y - _heightF / 2, _widthF, _heightF };
 	_center = { _widthF / 2, _heightF / 2 };
-	SDL_RenderCopyExF(renderer, _texture, &_rectCopy, &_rectDest, orientation * 180 / PI, &_center, SDL_FLIP_NONE);
+	renderBackend->DrawTextureRotated(_texture, &_rectCopy, _rectDest, orientation, _center);
 }
 
 const float Sprite::GetWidth() const {
@@ -36,19 +37,18 @@ const float Sprite::GetHeight() const {
 void SpriteSheet::Render(const int& spriteIndex, const Vector2<float>& position) {
 	_rectCopy = { spriteIndex * _widthI, 0, _widthI, _heightI };
 	_rectDest = { position.x, position.y, _widthF, _heightF };
-	SDL_RenderCopyF(renderer, _texture, &_rectCopy, &_rectDest);
+	renderBackend->DrawTexture(_texture, &_rectCopy, _rectDest);
 }
 
 void SpriteSheet::RenderCentered(const int& spriteIndex, const Vector2<float>& position) {
 	_rectCopy = { spriteIndex * _widthI, 0, _widthI, _heightI };
 	_rectDest = { position.x - _widthF / 2, position.y - _heightF / 2, _widthF, _heightF };
-	SDL_RenderCopyF(renderer, _texture, &_rectCopy, &_rectDest);
+	renderBackend->DrawTexture(_texture, &_rectCopy, _rectDest);
 }
 
 void SpriteSheet::RenderWithOrientation(const int& spriteIndex, const Vector2<float>& position, const float& orientation) {
 	_rectCopy = { spriteIndex * _widthI, 0, _widthI, _heightI };
 	_rectDest = { position.x - _widthF / 2, position.y - _heightF / 2, _widthF, _heightF };
 	_center = { _widthF / 2, _heightF / 2 };
-	SDL_RenderCopyExF(renderer, _texture, &_rectCopy, &_rectDest,
-		orientation * 180 / PI, &_center, SDL_FLIP_NONE);
+	renderBackend->DrawTextureRotated(_texture, &_rectCopy, _rectDest, orientation, _center);
 }
\ No newline at end of file
@@ -1,8 +1,8 @@
 #pragma once
-#include <SDL2/SDL_image.h>
-
+#include "renderBackend.h"
 #include "vector2.h"
 
+//Draws a texture loaded through the renderBackend, the null backend only gives it its width and height
 class Sprite {
 public:
 	Sprite() {}
@@ -22,7 +22,7 @@ protected:
 	SDL_FRect _rect;
 	SDL_Rect _rectCopy;
 	SDL_FRect _rectDest;
-	SDL_Texture* _texture = nullptr;
+	RenderTexture _texture;
 
 	float _widthF = 0.f;
 	float _heightF = 0.f;
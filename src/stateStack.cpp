@@ -1,12 +1,16 @@
 #include "stateStack.h"
 
+#include "broadPhase.h"
+#include "commandBuffer.h"
+#include "debugDrawer.h"
 #include "enemyManager.h"
 #include "gameEngine.h"
+#include "jobSystem.h"
 #include "objectBase.h"
 #include "obstacleManager.h"
 #include "playerCharacter.h"
 #include "projectileManager.h"
-#include "quadTree.h"
+#include "spatialIndex.h"
 #include "textSprite.h"
 #include "timerHandler.h"
 #include "weaponManager.h"
@@ -111,6 +115,7 @@ const GameMode GameStateHandler::GetGameMode() const {
 }
 
 InGameState::InGameState() {
+	commandBuffer->Clear();
 	enemyManager->Reset();
 	projectileManager->Reset();
 	weaponManager->RemoveAllObjects();
@@ -120,12 +125,18 @@ InGameState::InGameState() {
 }
 
 void InGameState::Update() {
-	enemyManager->InsertObjectsQuadtree();
-	obstacleManager->InsertObjectsQuadtree();
-	projectileManager->InsertObjectsQuadtree();	
-	weaponManager->InsertObjectsQuadtree();
+	enemyManager->SyncSpatialIndex();
+	obstacleManager->SyncSpatialIndex();
+	projectileManager->SyncSpatialIndex();	
+	weaponManager->SyncSpatialIndex();
+	for (unsigned int i = 0; i < playerCharacters.size(); i++) {
+		if (!spatialIndex->FindCollider(playerCharacters[i])) {
+			spatialIndex->Insert(playerCharacters[i], playerCharacters[i]->GetCollider(), playerCharacters[i]->GetCollisionLayer());
+		}
+	}
+	//Every stored collider is re-read in one parallel pass instead of moving the objects one at a time
+	spatialIndex->Rebuild();
 	for (unsigned int i = 0; i < playerCharacters.size(); i++) {
-		objectBaseQuadTree->Insert(playerCharacters[i], playerCharacters[i]->GetCollider());
 		playerCharacters[i]->Update();
 	}
 	enemyManager->Update();
@@ -133,6 +144,20 @@ void InGameState::Update() {
 	projectileManager->Update();
 	timerHandler->Update();
 	weaponManager->Update();
+
+	/*Everything has moved, the overlapping pairs are found once and the projectile hits are resolved from them.
+	They run as a chain in the frame graph, the projectile job is only queued once the broad phase job has finished*/
+	JobGraph& frameGraph = jobSystem->GetFrameGraph();
+	const std::shared_ptr<Job> broadPhaseJob = frameGraph.AddJob([]() {
+		broadPhase->Update();
+	});
+	const std::shared_ptr<Job> projectileCollisionJob = frameGraph.AddJob([]() {
+		projectileManager->CheckCollisions();
+	}, { broadPhaseJob });
+	jobSystem->Wait(projectileCollisionJob);
+
+	//Every manager is done iterating its objects, the damage, deaths and spawns of the tick are applied here
+	commandBuffer->Flush();
 }
 
 void InGameState::Render() {
@@ -0,0 +1,109 @@
+#include "steeringBatch.h"
+
+#include <algorithm>
+
+//The behaviours that only read the agent, its target and its neighbours, the others change the agent or need queries of their own
+bool SteeringBatch::IsBatched(const SteeringBehaviorType& behaviorType) {
+	switch (behaviorType) {
+	case SteeringBehaviorType::Align:
+	case SteeringBehaviorType::Arrive:
+	case SteeringBehaviorType::Evade:
+	case SteeringBehaviorType::Face:
+	case SteeringBehaviorType::Flee:
+	case SteeringBehaviorType::Pursue:
+	case SteeringBehaviorType::Seek:
+	case SteeringBehaviorType::Separation:
+		return true;
+	default:
+		return false;
+	}
+}
+
+//Whether the pipeline has a behaviour for the type, an enemy that weights a behaviour its pipeline lacks has to use its own priority steering
+bool SteeringBatch::Steers(const SteeringPipelineType& pipelineType, const SteeringBehaviorType& behaviorType) {
+	switch (pipelineType) {
+	case SteeringPipelineType::HumanSurvival:
+		return HumanSurvivalSteering::Steers(behaviorType);
+	case SteeringPipelineType::HumanFormation:
+		return HumanFormationSteering::Steers(behaviorType);
+	case SteeringPipelineType::Boar:
+		return BoarSteering::Steers(behaviorType);
+	case SteeringPipelineType::BoarBoss:
+		return BoarBossSteering::Steers(behaviorType);
+	default:
+		return false;
+	}
+}
+
+//Agents of the same pipeline that are added one after another share one range
+void SteeringBatch::AddAgent(const SteeringPipelineType& pipelineType, const ObjectBase& objectBase, const BehaviorData& behaviorData, const SteeringWeights& weights) {
+	const unsigned int index = _agents.Size();
+	_agents.Add(objectBase, behaviorData, weights);
+	if (!_pipelineRanges.empty() && _pipelineRanges.back().pipelineType == pipelineType && _pipelineRanges.back().last == index) {
+		_pipelineRanges.back().last++;
+		return;
+	}
+	PipelineRange pipelineRange;
+	pipelineRange.pipelineType = pipelineType;
+	pipelineRange.first = index;
+	pipelineRange.last = index + 1;
+	_pipelineRanges.emplace_back(pipelineRange);
+}
+
+void SteeringBatch::Clear() {
+	_agents.Clear();
+	_pipelineRanges.clear();
+	_chunks.clear();
+}
+
+/*Every agent only writes its own steering, so the ranges can be cut and the parts run at the same time.
+The chunks are counted from the start of their range, with a chunk size that is a multiple of the widest lanes every agent goes through the same lanes as when the whole range runs*/
+void SteeringBatch::SplitIntoChunks(const unsigned int& chunkSize) {
+	_chunks.clear();
+	const unsigned int size = std::max(1u, chunkSize);
+	for (unsigned int i = 0; i < _pipelineRanges.size(); i++) {
+		for (unsigned int first = _pipelineRanges[i].first; first < _pipelineRanges[i].last; first += size) {
+			PipelineRange chunk;
+			chunk.pipelineType = _pipelineRanges[i].pipelineType;
+			chunk.first = first;
+			chunk.last = std::min(_pipelineRanges[i].last, first + size);
+			_chunks.emplace_back(chunk);
+		}
+	}
+}
+
+void SteeringBatch::RunChunk(const unsigned int& chunkIndex) {
+	RunRange(_chunks[chunkIndex]);
+}
+
+const unsigned int SteeringBatch::GetChunkCount() const {
+	return _chunks.size();
+}
+
+//One switch per range, inside it the pipeline calls every behaviour it blends directly
+void SteeringBatch::RunRange(const PipelineRange& pipelineRange) {
+	switch (pipelineRange.pipelineType) {
+	case SteeringPipelineType::HumanSurvival:
+		HumanSurvivalSteering::Run(_agents, pipelineRange.first, pipelineRange.last);
+		break;
+	case SteeringPipelineType::HumanFormation:
+		HumanFormationSteering::Run(_agents, pipelineRange.first, pipelineRange.last);
+		break;
+	case SteeringPipelineType::Boar:
+		BoarSteering::Run(_agents, pipelineRange.first, pipelineRange.last);
+		break;
+	case SteeringPipelineType::BoarBoss:
+		BoarBossSteering::Run(_agents, pipelineRange.first, pipelineRange.last);
+		break;
+	default:
+		break;
+	}
+}
+
+const SteeringOutput SteeringBatch::GetSteering(const unsigned int& agentIndex) const {
+	return _agents.GetSteering(agentIndex);
+}
+
+const unsigned int SteeringBatch::Size() const {
+	return _agents.Size();
+}
@@ -0,0 +1,44 @@
+#pragma once
+#include "steeringBehavior.h"
+#include "steeringPipeline.h"
+
+#include <vector>
+
+struct BehaviorData;
+class ObjectBase;
+
+/*Runs the steering of many agents one behaviour at a time, every behaviour is one loop over the agents instead of one virtual call per agent.
+The agents of one pipeline are stored next to each other and the pipeline runs over their range, so every behaviour it blends is called directly*/
+class SteeringBatch {
+public:
+	SteeringBatch() {}
+	~SteeringBatch() {}
+
+	static bool IsBatched(const SteeringBehaviorType& behaviorType);
+	static bool Steers(const SteeringPipelineType& pipelineType, const SteeringBehaviorType& behaviorType);
+
+	void AddAgent(const SteeringPipelineType& pipelineType, const ObjectBase& objectBase, const BehaviorData& behaviorData, const SteeringWeights& weights);
+	void Clear();
+
+	void SplitIntoChunks(const unsigned int& chunkSize);
+	void RunChunk(const unsigned int& chunkIndex);
+	const unsigned int GetChunkCount() const;
+
+	const SteeringOutput GetSteering(const unsigned int& agentIndex) const;
+	const unsigned int Size() const;
+
+private:
+	//Agents [first, last) run the same pipeline
+	struct PipelineRange {
+		SteeringPipelineType pipelineType = SteeringPipelineType::Count;
+		unsigned int first = 0;
+		unsigned int last = 0;
+	};
+
+	void RunRange(const PipelineRange& pipelineRange);
+
+	SteeringAgents _agents;
+	std::vector<PipelineRange> _pipelineRanges;
+	//The pipeline ranges cut into parts that can run on different threads
+	std::vector<PipelineRange> _chunks;
+};
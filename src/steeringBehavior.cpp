@@ -7,125 +7,133 @@
 #include "objectBase.h"
 #include "obstacleManager.h"
 #include "obstacleWall.h"
-#include "quadTree.h"
-#include "rayCast.h"
+#include "spatialIndex.h"
+#include "steeringBatch.h"
 #include "universalFunctions.h"
 
 AlignBehavior::AlignBehavior() {
 	_behaviorType = SteeringBehaviorType::Align;
 }
 
-SteeringOutput AlignBehavior::Steering(const BehaviorData& behaviorData, ObjectBase& objectBase) {
-	if (fabs(_targetOrientation) <= FLT_EPSILON) {
-		_targetOrientation = behaviorData.targetOrientation;
-	}
+SteeringOutput AlignBehavior::Steering(const BehaviorData& behaviorData, ObjectBase& objectBase) const {
+	return AlignToOrientation(behaviorData, objectBase, behaviorData.targetOrientation);
+}
+
+SteeringOutput AlignBehavior::AlignToOrientation(const BehaviorData& behaviorData, const ObjectBase& objectBase, const float& targetOrientation) const {
 	//Calculates the speed that the enemy will rotate and clamps it between -PI, PI radians(-180, 180 degree)
-	_rotation = _targetOrientation - objectBase.GetOrientation();
-	_rotation = universalFunctions->WrapMinMax(_rotation, -PI, PI);
+	float rotation = targetOrientation - objectBase.GetOrientation();
+	rotation = universalFunctions->WrapMinMax(rotation, -PI, PI);
 
 	//Uses a variable that will always be the positive value and use it for the if statements
-	_rotationSize = abs(_rotation);
+	const float rotationSize = abs(rotation);
 
 	//Compare the rotationSize value with targetRadius and slowDownRadius
-	if (_rotationSize < behaviorData.angularTargetRadius) {
+	if (rotationSize < behaviorData.angularTargetRadius) {
 		//If the rotationSize is less than the angularTargetRadius, it means that the enemy doesn't need to rotate
 		return SteeringOutput();
 	}
-	if (_rotationSize > behaviorData.angularSlowDownRadius) {
+	float wantedRotation = 0.f;
+	if (rotationSize > behaviorData.angularSlowDownRadius) {
 		//If rotationSize is larger than slowDownRadius, the enemy will rotate based on the maxRotation
-		_wantedRotation = behaviorData.maxRotation;
+		wantedRotation = behaviorData.maxRotation;
 	} else {
 		//If rotationSize is less than slowDownRadius, calculate the rotation scaled by the rotationSize and slowDownRadius
-		_wantedRotation = behaviorData.maxRotation * _rotationSize / behaviorData.angularSlowDownRadius;
+		wantedRotation = behaviorData.maxRotation * rotationSize / behaviorData.angularSlowDownRadius;
 	}
 	//Multiplies wantedRotation with the direction of the rotation
-	_wantedRotation *= _rotation / _rotationSize;
+	wantedRotation *= rotation / rotationSize;
 
 	//Calculates the angularVelocity the enemy will rotate compared to its current rotation
-	_result.angularVelocity = _wantedRotation - objectBase.GetRotation();
-	_result.angularVelocity /= behaviorData.timeToTarget;
+	SteeringOutput result;
+	result.angularVelocity = wantedRotation - objectBase.GetRotation();
+	result.angularVelocity /= behaviorData.timeToTarget;
 
 	//Makes sure the angular acceleration doesn't go beyond the maxAngularAcceleration
-	_angularAcceleration = abs(_result.angularVelocity);
-	if (_angularAcceleration > behaviorData.maxAngularAcceleration) {
-		_result.angularVelocity /= _angularAcceleration;
-		_result.angularVelocity *= behaviorData.maxAngularAcceleration;
+	const float angularAcceleration = abs(result.angularVelocity);
+	if (angularAcceleration > behaviorData.maxAngularAcceleration) {
+		result.angularVelocity /= angularAcceleration;
+		result.angularVelocity *= behaviorData.maxAngularAcceleration;
 	}
-	//Make sure to return the linearVelocity as 0, since this behavior will only change the angularVelocity
-	_result.linearVelocity = Vector2(0.f, 0.f);
-	_targetOrientation = 0.f;
-	return _result;
+	//The linearVelocity stays 0, since this behavior will only change the angularVelocity
+	return result;
 }
 
 FaceBehavior::FaceBehavior() {
 	_behaviorType = SteeringBehaviorType::Face;
 }
 
-SteeringOutput FaceBehavior::Steering(const BehaviorData& behaviorData, ObjectBase& objectBase) {
-	_direction = objectBase.GetTargetPosition() - objectBase.GetPosition();
-	if (_direction.absolute() == 0) {
+SteeringOutput FaceBehavior::Steering(const BehaviorData& behaviorData, ObjectBase& objectBase) const {
+	const Vector2<float> direction = objectBase.GetTargetPosition() - objectBase.GetPosition();
+	if (direction.absolute() == 0) {
 		return SteeringOutput();
 	}
-	//Sets the targetOrientation based on the direction using atan2f
-	_targetOrientation = universalFunctions->VectorAsOrientation(_direction);
-
-	//returns the steering function from alignBehavior which aligns the character with the targetOrientation
-	return AlignBehavior::Steering(behaviorData, objectBase);
+	//Aligns the character with the targetOrientation, based on the direction using atan2f
+	return AlignToOrientation(behaviorData, objectBase, universalFunctions->VectorAsOrientation(direction));
+}
+LookAtDirectionBehavior::LookAtDirectionBehavior() {
+	_behaviorType = SteeringBehaviorType::LookAtDirection;
 }
-LookAtDirectionBehavior::LookAtDirectionBehavior() {}
 
-SteeringOutput LookAtDirectionBehavior::Steering(const BehaviorData& behaviorData, ObjectBase& objectBase) {
+SteeringOutput LookAtDirectionBehavior::Steering(const BehaviorData& behaviorData, ObjectBase& objectBase) const {
 	//If the enemy doesn't have a veolcity, return 0
 	if (objectBase.GetVelocity().absolute() == 0) {
 		return SteeringOutput();
 	}
 	//Sets the targetOrientation to the velocity as orientation using atan2f
-	_targetOrientation = universalFunctions->VectorAsOrientation(objectBase.GetVelocity());
-	return AlignBehavior::Steering(behaviorData, objectBase);
+	return AlignToOrientation(behaviorData, objectBase, universalFunctions->VectorAsOrientation(objectBase.GetVelocity()));
 }
 
 ArriveBehavior::ArriveBehavior() {
 	_behaviorType = SteeringBehaviorType::Arrive;
 }
 
-SteeringOutput ArriveBehavior::Steering(const BehaviorData& behaviorData, ObjectBase& objectBase) {
+SteeringOutput ArriveBehavior::Steering(const BehaviorData& behaviorData, ObjectBase& objectBase) const {
 	//Calculates the direction and distance between target and enemy
-	_direction = objectBase.GetTargetPosition() - objectBase.GetPosition();
-	_distance = _direction.absolute();
+	const Vector2<float> direction = objectBase.GetTargetPosition() - objectBase.GetPosition();
+	const float distance = direction.absolute();
 	
 	//If distance is in target radius, the behavior will return and not update the behavior further
-	if (_distance < behaviorData.linearTargetRadius) {
+	if (distance < behaviorData.linearTargetRadius) {
 		return SteeringOutput();
 	}
-	if (_distance > behaviorData.linearSlowDownRadius) {
+	float targetSpeed = 0.f;
+	if (distance > behaviorData.linearSlowDownRadius) {
 		//If distance is larger than the slowDownRadius, set the targetSpeed to maxSpeed
-		_targetSpeed = behaviorData.maxSpeed;
+		targetSpeed = behaviorData.maxSpeed;
 	} else {
 		//If distance is smaller than slowDownRadius, calculate targetSpeed scaled by the distance and slowDownRadius
-		_targetSpeed = behaviorData.maxSpeed * _distance / behaviorData.linearSlowDownRadius;
+		targetSpeed = behaviorData.maxSpeed * distance / behaviorData.linearSlowDownRadius;
 	}
 	//Normalize the direction and combine targetVelocity with the targetSpeed
-	_targetVelocity = _direction.normalized();
-	_targetVelocity *= _targetSpeed;
+	Vector2<float> targetVelocity = direction.normalized();
+	targetVelocity *= targetSpeed;
 
 	//Set the difference between the targetVelocity and the enemies current velocity as the resulted velocity
-	_result.linearVelocity = _targetVelocity - objectBase.GetVelocity();
-	_result.linearVelocity /= behaviorData.timeToTarget;
+	SteeringOutput result;
+	result.linearVelocity = targetVelocity - objectBase.GetVelocity();
+	result.linearVelocity /= behaviorData.timeToTarget;
 
 	//Make sure the velocity doesn't go beyond maxAcceleration
-	universalFunctions->LimitVelocity(_result.linearVelocity, behaviorData.maxLinearAcceleration);
+	universalFunctions->LimitVelocity(result.linearVelocity, behaviorData.maxLinearAcceleration);
 
-	//Make sure to return the angularVelocity as 0, since this behavior will only change the linearVelocity
-	_result.angularVelocity = 0.f;
-	return _result;
+	//The angularVelocity stays 0, since this behavior will only change the linearVelocity
+	return result;
 }
 
 CollisionAvoidanceBehavior::CollisionAvoidanceBehavior() {
 	_behaviorType = SteeringBehaviorType::CollisionAbvoidance;
 }
 
-SteeringOutput CollisionAvoidanceBehavior::Steering(const BehaviorData& behaviorData, ObjectBase& objectBase) {
-	_currentCollider = std::static_pointer_cast<Circle>(objectBase.GetCollider());
+SteeringOutput CollisionAvoidanceBehavior::Steering(const BehaviorData& behaviorData, ObjectBase& objectBase) const {
+	const float radius = std::static_pointer_cast<Circle>(objectBase.GetCollider())->GetRadius();
+
+	bool gotTarget = false;
+	float shortestTime = FLT_MAX;
+	Vector2<float> firstTargetPosition = { 0.f, 0.f };
+	Vector2<float> firstRelativePos = { 0.f, 0.f };
+	Vector2<float> firstRelativeVel = { 0.f, 0.f };
+	float firstMinSeparation = 0.f;
+	float firstDistance = 0.f;
 
 	//Gets all objectBase that has collided with this enemy through the quadTree
 	for (unsigned int i = 0; i < objectBase.GetQueriedObjects().size(); i++) {
@@ -135,164 +143,176 @@ SteeringOutput CollisionAvoidanceBehavior::Steering(const BehaviorData& behavior
 			continue;
 		}
 		//Calculate the relative speed, position and velocity between current enemy and targetEnemy
-		_relativePos = objectBase.GetQueriedObjects()[i]->GetPosition() - objectBase.GetPosition();
-		_relativeVel = objectBase.GetQueriedObjects()[i]->GetVelocity() - objectBase.GetVelocity();
-		_relativeSpeed = _relativeVel.absolute();
+		const Vector2<float> relativePos = objectBase.GetQueriedObjects()[i]->GetPosition() - objectBase.GetPosition();
+		const Vector2<float> relativeVel = objectBase.GetQueriedObjects()[i]->GetVelocity() - objectBase.GetVelocity();
+		const float relativeSpeed = relativeVel.absolute();
 
 		//Calculates the time to collision betwwen the current enemy and targetEnemy
-		_timeToCollision = Vector2<float>::dotProduct(_relativePos, _relativeVel) / (_relativeSpeed * _relativeSpeed);
+		const float timeToCollision = Vector2<float>::dotProduct(relativePos, relativeVel) / (relativeSpeed * relativeSpeed);
 		
 		//See if a collision is going to happen
-		_distance = _relativePos.absolute();
-		_minSeparation = _distance - _relativeSpeed * _timeToCollision;
+		const float distance = relativePos.absolute();
+		const float minSeparation = distance - relativeSpeed * timeToCollision;
 
 		/*If minSeparation is larger than colliders diameter,
 		then the enemies won't collide and collisionAvoidance is not need*/
-		if (_minSeparation > _currentCollider->GetRadius() * 5.f) {
+		if (minSeparation > radius * 5.f) {
 			continue;
 		}
 		//If the current timeToCollision is the shortest, set the targetEnemy as the first target
-		if (_timeToCollision < _shortestTime) {
-			_shortestTime = _timeToCollision;
-			_firstTargetPosition = objectBase.GetQueriedObjects()[i]->GetPosition();
-			_firstMinSeparation = _minSeparation;
-			_firstDistance = _distance;
-			_firstRelativePos = _relativePos;
-			_firstRelativeVel = _relativeVel;
-			_gotTarget = true;
+		if (timeToCollision < shortestTime) {
+			shortestTime = timeToCollision;
+			firstTargetPosition = objectBase.GetQueriedObjects()[i]->GetPosition();
+			firstMinSeparation = minSeparation;
+			firstDistance = distance;
+			firstRelativePos = relativePos;
+			firstRelativeVel = relativeVel;
+			gotTarget = true;
 		}
 	}
 	//If there is not target, return 0 since there is no target to avoid
-	if (!_gotTarget) {
+	if (!gotTarget) {
 		return SteeringOutput();
 	}
 
+	Vector2<float> relativePos = { 0.f, 0.f };
 	//If they are already colliding, base the steering of the current position
-	if (_firstMinSeparation <= 0 || _firstDistance < 2 * _currentCollider->GetRadius()) {
-		_relativePos = objectBase.GetPosition() - _firstTargetPosition;
+	if (firstMinSeparation <= 0 || firstDistance < 2 * radius) {
+		relativePos = objectBase.GetPosition() - firstTargetPosition;
 	} else {
 		//Calculates the future relativePosition
-		_relativePos = _firstRelativePos + _firstRelativeVel * _shortestTime;
+		relativePos = firstRelativePos + firstRelativeVel * shortestTime;
 	}
-	_relativePos.normalize();
-	_gotTarget = false;
-	_shortestTime = FLT_MAX;
+	relativePos.normalize();
 
 	//Avoid the target by returning acceleration beased on the relativePosition
-	_result.linearVelocity = _relativePos * behaviorData.maxLinearAcceleration;
-
-	_result.angularVelocity = 0.f;
-	return _result;
+	SteeringOutput result;
+	result.linearVelocity = relativePos * behaviorData.maxLinearAcceleration;
+	return result;
 }
 
 SeekBehavior::SeekBehavior(const SteeringBehaviorType& behaviorType) {
 	_behaviorType = behaviorType;
 }
 
-SteeringOutput SeekBehavior::Steering(const BehaviorData& behaviorData, ObjectBase& objectBase) {
+SteeringOutput SeekBehavior::Steering(const BehaviorData& behaviorData, ObjectBase& objectBase) const {
+	SteeringOutput result;
 	if (_behaviorType == SteeringBehaviorType::Evade || _behaviorType == SteeringBehaviorType::Flee) {
 		//If the target is using the seek behavior, calculate the velocity from the targetPosition and enemyPosition
-		_result.linearVelocity = objectBase.GetPosition() - objectBase.GetTargetPosition();
+		result.linearVelocity = objectBase.GetPosition() - objectBase.GetTargetPosition();
 
 	} else if (_behaviorType == SteeringBehaviorType::Pursue || _behaviorType == SteeringBehaviorType::Seek) {
 		//If the target is using the flee behavior, calculate the velocity from the enemyPosition and targetPosition
-		_result.linearVelocity = objectBase.GetTargetPosition() - objectBase.GetPosition();
+		result.linearVelocity = objectBase.GetTargetPosition() - objectBase.GetPosition();
 
 	} else {
 		//If an unrelated behavior has been chosen, use seek as default
-		_result.linearVelocity = objectBase.GetTargetPosition() - objectBase.GetPosition();
+		result.linearVelocity = objectBase.GetTargetPosition() - objectBase.GetPosition();
 	}
 
 	//Set the velocity based on the maxAcceleration
-	_result.linearVelocity = _result.linearVelocity.normalized();
-	_result.linearVelocity *= behaviorData.maxLinearAcceleration;
+	result.linearVelocity = result.linearVelocity.normalized();
+	result.linearVelocity *= behaviorData.maxLinearAcceleration;
 
 	//Make sure the velocity doesn't go above the maxSpeed
-	universalFunctions->LimitVelocity(_result.linearVelocity, behaviorData.maxSpeed);
+	universalFunctions->LimitVelocity(result.linearVelocity, behaviorData.maxSpeed);
 
-	//Make sure to return the angularVelocity as 0, since this behavior will only change the linearVelocity
-	_result.angularVelocity = 0.f;
-	return _result;
+	//The angularVelocity stays 0, since this behavior will only change the linearVelocity
+	return result;
 }
 
 ObstacleAvoidanceBehavior::ObstacleAvoidanceBehavior() : SeekBehavior(SteeringBehaviorType::Seek) {
 	_behaviorType = SteeringBehaviorType::ObstacleAvoidance;
-	_circleCollider = std::make_shared<Circle>();
 }
 
-SteeringOutput ObstacleAvoidanceBehavior::Steering(const BehaviorData& behaviorData, ObjectBase& objectBase) {
+SteeringOutput ObstacleAvoidanceBehavior::Steering(const BehaviorData& behaviorData, ObjectBase& objectBase) const {
 	//Sets that values for the ray cast and its smaller, rotated rays called whiskers
-	_rayPoint.pointHit = false;
-	_ray.length = behaviorData.lookAhead;
-	_ray.direction = (objectBase.GetVelocity() * _ray.length).normalized();
-	_ray.startPosition = objectBase.GetPosition();
-
-	_whiskerA = _ray;
-	_whiskerA.length = _ray.length * 0.5f;
-	_whiskerA.direction = _ray.direction.rotated(-PI * 0.125f);
-
-	_whiskerB = _ray;
-	_whiskerB.length = _ray.length * 0.5f;
-	_whiskerB.direction = _ray.direction.rotated(PI * 0.125f);
-
-	//debugDrawer->AddDebugLine(objectBase.GetPosition(), objectBase.GetPosition() + _ray.direction * _ray.length, { 0, 255, 0, 255 });
-	//debugDrawer->AddDebugLine(objectBase.GetPosition(), objectBase.GetPosition() + _whiskerA.direction * _whiskerA.length, { 0, 255, 0, 255 });
-	//debugDrawer->AddDebugLine(objectBase.GetPosition(), objectBase.GetPosition() + _whiskerB.direction * _whiskerB.length, { 0, 255, 0, 255 });
-
-	_circleCollider->Init(objectBase.GetPosition(), behaviorData.lookAhead);
-	_queriedObstacles = obstacleQuadTree->Query(_circleCollider);
-
-	//Goes through the obstacles and see if any of the rays intersects with the obstacle
-	for (std::shared_ptr<ObjectBase> object : _queriedObstacles) {
-		if (object->GetCollider()->GetColliderType() != ColliderType::AABB) {
-			//Makes sure the object is an obstacle and has an AABB collider
-			continue;
-		}
-		_currentCollider = std::static_pointer_cast<AABB>(std::static_pointer_cast<AABB>(object->GetCollider()));
-		//If any of the rays hit, break the loop
-		_rayPoint = rayCast->RayCastToAABB(_currentCollider, _ray);
-		if (_rayPoint.pointHit) {
-			break;
-		}
-		_rayPoint = rayCast->RayCastToAABB(_currentCollider, _whiskerA);
-		if (_rayPoint.pointHit) {
-			break;
+	Ray ray;
+	ray.length = behaviorData.lookAhead;
+	ray.direction = (objectBase.GetVelocity() * ray.length).normalized();
+	ray.startPosition = objectBase.GetPosition();
+
+	Ray whiskerA = ray;
+	whiskerA.length = ray.length * 0.5f;
+	whiskerA.direction = ray.direction.rotated(-PI * 0.125f);
+
+	Ray whiskerB = ray;
+	whiskerB.length = ray.length * 0.5f;
+	whiskerB.direction = ray.direction.rotated(PI * 0.125f);
+
+	//debugDrawer->AddDebugLine(objectBase.GetPosition(), objectBase.GetPosition() + ray.direction * ray.length, { 0, 255, 0, 255 });
+	//debugDrawer->AddDebugLine(objectBase.GetPosition(), objectBase.GetPosition() + whiskerA.direction * whiskerA.length, { 0, 255, 0, 255 });
+	//debugDrawer->AddDebugLine(objectBase.GetPosition(), objectBase.GetPosition() + whiskerB.direction * whiskerB.length, { 0, 255, 0, 255 });
+
+	//Scratch space of the query and the ray casts, kept per thread since every agent shares this behaviour
+	thread_local std::shared_ptr<AABB> rayRange = std::make_shared<AABB>();
+	thread_local std::vector<std::shared_ptr<ObjectBase>> obstaclesFound;
+	thread_local BoxColliders obstacleBoxes;
+	thread_local RayPacket rayPacket;
+	thread_local std::vector<RayPacketHit> rayPacketHits;
+
+	//The obstacles that can be hit lie in the bounds of the three rays, they are found with one query instead of one per ray
+	rayPacket.Clear();
+	Vector2<float> rangeMin = ray.startPosition;
+	Vector2<float> rangeMax = ray.startPosition;
+	for (const Ray& currentRay : { ray, whiskerA, whiskerB }) {
+		rayPacket.Add(currentRay);
+		const Vector2<float> rayEnd = currentRay.startPosition + currentRay.direction * currentRay.length;
+		rangeMin = { std::min(rangeMin.x, rayEnd.x), std::min(rangeMin.y, rayEnd.y) };
+		rangeMax = { std::max(rangeMax.x, rayEnd.x), std::max(rangeMax.y, rayEnd.y) };
+	}
+	//Grown by a unit so an obstacle the ray only reaches with its end is still found
+	rangeMin -= Vector2<float>(1.f, 1.f);
+	rangeMax += Vector2<float>(1.f, 1.f);
+	rayRange->Init((rangeMin + rangeMax) * 0.5f, rangeMax.y - rangeMin.y, rangeMax.x - rangeMin.x);
+	obstaclesFound.clear();
+	spatialIndex->Query(rayRange, obstaclesFound, ToCollisionLayer(ObjectType::Obstacle));
+	if (obstaclesFound.empty()) {
+		return SteeringOutput();
+	}
+	obstacleBoxes.Clear();
+	for (unsigned int i = 0; i < obstaclesFound.size(); i++) {
+		if (obstaclesFound[i]->GetCollider()->GetColliderType() == ColliderType::AABB) {
+			obstacleBoxes.Add(ToBoxShape(static_cast<const AABB&>(*obstaclesFound[i]->GetCollider())));
 		}
-		_rayPoint = rayCast->RayCastToAABB(_currentCollider, _whiskerB);
-		if (_rayPoint.pointHit) {
-			break;
+	}
+	//The query holds shared pointers to the obstacles, they are not kept alive past this call
+	obstaclesFound.clear();
+	RayCastPacket(rayPacket, obstacleBoxes, 0, obstacleBoxes.Size(), rayPacketHits);
+
+	//The rays are checked in order, starting with the main ray, the first one that hit an obstacle is avoided
+	for (unsigned int i = 0; i < rayPacketHits.size(); i++) {
+		if (rayPacketHits[i].hit) {
+			//Set the targetPosition based on the hit position, its normal combined with the avoidanceDistance
+			const Vector2<float> hitPosition = rayPacket.rays[i].startPosition + rayPacket.rays[i].direction * rayPacketHits[i].distance;
+			objectBase.SetTargetPosition(hitPosition + rayPacketHits[i].normal * behaviorData.avoidDistance);
+			//Avoid the object by using seekBehavior toward the target position
+			return SeekBehavior::Steering(behaviorData, objectBase);
 		}
-
 	}
 	//If no object is intersecting, return 0
-	if (!_rayPoint.pointHit) {
-		return SteeringOutput();
-	}
-	//When the raypoint intersects, set the targetPosition based on the rayPoint position, its normal combined with the avoidanceDistance 
-	objectBase.SetTargetPosition(_rayPoint.position + _rayPoint.normal * behaviorData.avoidDistance);
-
-	//Avoid the object by using seekBehavior toward the target position
-	return SeekBehavior::Steering(behaviorData, objectBase);
+	return SteeringOutput();
 }
 PursueBehavior::PursueBehavior(const SteeringBehaviorType& behaviorType) : SeekBehavior(behaviorType) {
 	_behaviorType = behaviorType;
 }
 
-SteeringOutput PursueBehavior::Steering(const BehaviorData& behaviorData, ObjectBase& objectBase) {
+SteeringOutput PursueBehavior::Steering(const BehaviorData& behaviorData, ObjectBase& objectBase) const {
 	//Calculate the distance between enemy and target 
-	_distance = (objectBase.GetPosition() - objectBase.GetTargetPosition()).absolute();
+	const float distance = (objectBase.GetPosition() - objectBase.GetTargetPosition()).absolute();
 	//Set the current speed the enemy is travelling
-	_speed = objectBase.GetVelocity().absolute();
+	const float speed = objectBase.GetVelocity().absolute();
 
+	float prediction = 0.f;
 	//Checks if the speed gives a reasonable predction time
-	if (_speed <= _distance / behaviorData.maxPrediction) {
-		_prediction = behaviorData.maxPrediction;
+	if (speed <= distance / behaviorData.maxPrediction) {
+		prediction = behaviorData.maxPrediction;
 	} else {
 		//If not, calculate the prediction time based on the distance and speed
-		_prediction = _distance / _speed;
+		prediction = distance / speed;
 	}
 	//Sets the targetPosition to the targets position added with the targets velocity multiplied with the calculated prediction
-	objectBase.SetTargetPosition(objectBase.GetTargetPosition() + (behaviorData.targetsVelocity * _prediction));
+	objectBase.SetTargetPosition(objectBase.GetTargetPosition() + (behaviorData.targetsVelocity * prediction));
 	//Runs the seek steering behavior with the new calculated targetPosition
 	return SeekBehavior::Steering(behaviorData, objectBase);
 }
@@ -301,80 +321,89 @@ SeparationBehavior::SeparationBehavior(const SteeringBehaviorType& behaviorType)
 	_behaviorType = behaviorType;
 }
 
-SteeringOutput SeparationBehavior::Steering(const BehaviorData& behaviorData, ObjectBase& objectBase) {
-	_result.angularVelocity = 0.f;
-	_result.linearVelocity = { 0.f, 0.f };
+SteeringOutput SeparationBehavior::Steering(const BehaviorData& behaviorData, ObjectBase& objectBase) const {
+	SteeringOutput result;
 
-	//Loops through all objects detected by the quadtree
-	for (unsigned int i = 0; i < objectBase.GetQueriedObjects().size(); i++) {
-		if (objectBase.GetQueriedObjects()[i]->GetObjectType() == ObjectType::Projectile) {
-			continue;
+	//In dense crowds separation only pushes away from the closest few neighbours inside its threshold, found by the manager's batched query
+	if (_behaviorType == SteeringBehaviorType::Separation && behaviorData.maxSeparationNeighbours > 0) {
+		for (unsigned int i = 0; i < objectBase.GetNearestObjects().size(); i++) {
+			if (objectBase.GetObjectID() != objectBase.GetNearestObjects()[i]->GetObjectID()) {
+				AddNeighbourSteering(behaviorData, objectBase, *objectBase.GetNearestObjects()[i], result);
+			}
 		}
+		return result;
+	}
+	//Loops through all objects found by the broad phase, the collision mask of enemies already leaves out projectiles
+	for (unsigned int i = 0; i < objectBase.GetQueriedObjects().size(); i++) {
 		//Skips if the enemy in the loop is the same one as the current one
 		if (objectBase.GetObjectID() == objectBase.GetQueriedObjects()[i]->GetObjectID()) {
 			continue;
 		}
-		//Sets the targetPosition and calculate the direction and distance based on the current targetEnemy
-		_targetPosition = objectBase.GetQueriedObjects()[i]->GetPosition();
-		_direction = objectBase.GetPosition() - _targetPosition;
-		_distance = _direction.absolute();
-		switch (_behaviorType) {
-		case SteeringBehaviorType::Attraction:
-			if (_distance > behaviorData.attractionThreshold) {
-				_strength = std::min(behaviorData.decayCoefficient / (_distance * _distance), behaviorData.maxLinearAcceleration);
-				_direction.normalize();
-				_result.linearVelocity -= _direction * _strength;
-			}
-			break;
-
-		case SteeringBehaviorType::Separation:
-			if (_distance < behaviorData.separationThreshold) {
-				//Using the inverse quare law to calculate the separation strength
-				_strength = std::min(behaviorData.decayCoefficient / (_distance * _distance), behaviorData.maxLinearAcceleration);	
-				_direction.normalize();
-				_result.linearVelocity += _direction * _strength;
-			}
-			break;
-
-		default:
-			break;
+		AddNeighbourSteering(behaviorData, objectBase, *objectBase.GetQueriedObjects()[i], result);
+	}
+	return result;
+}
+
+void SeparationBehavior::AddNeighbourSteering(const BehaviorData& behaviorData, const ObjectBase& objectBase, const ObjectBase& neighbour, SteeringOutput& result) const {
+	//Calculate the direction and distance based on the current targetEnemy
+	Vector2<float> direction = objectBase.GetPosition() - neighbour.GetPosition();
+	const float distance = direction.absolute();
+	float strength = 0.f;
+	switch (_behaviorType) {
+	case SteeringBehaviorType::Attraction:
+		if (distance > behaviorData.attractionThreshold) {
+			strength = std::min(behaviorData.decayCoefficient / (distance * distance), behaviorData.maxLinearAcceleration);
+			direction.normalize();
+			result.linearVelocity -= direction * strength;
+		}
+		break;
+
+	case SteeringBehaviorType::Separation:
+		if (distance < behaviorData.separationThreshold) {
+			//Using the inverse quare law to calculate the separation strength
+			strength = std::min(behaviorData.decayCoefficient / (distance * distance), behaviorData.maxLinearAcceleration);	
+			direction.normalize();
+			result.linearVelocity += direction * strength;
 		}
+		break;
+
+	default:
+		break;
 	}
-	return _result;
 }
 
 VelocityMatchBehavior::VelocityMatchBehavior() {
 	_behaviorType = SteeringBehaviorType::VelocityMatch;
 }
 
-SteeringOutput VelocityMatchBehavior::Steering(const BehaviorData& behaviorData, ObjectBase& objectBase) {
+SteeringOutput VelocityMatchBehavior::Steering(const BehaviorData& behaviorData, ObjectBase& objectBase) const {
 	//Calculates the velocity between the targets and current enemy
-	_result.linearVelocity = behaviorData.targetsVelocity - objectBase.GetVelocity();
-	_result.linearVelocity /= behaviorData.timeToTarget;
+	SteeringOutput result;
+	result.linearVelocity = behaviorData.targetsVelocity - objectBase.GetVelocity();
+	result.linearVelocity /= behaviorData.timeToTarget;
 
 	//Make sure the velocity doesn't get higher than the max acceleration
-	universalFunctions->LimitVelocity(_result.linearVelocity, behaviorData.maxLinearAcceleration);
-	_result.angularVelocity = 0.f;
-	return _result;
+	universalFunctions->LimitVelocity(result.linearVelocity, behaviorData.maxLinearAcceleration);
+	return result;
 }
 
 WanderBehavior::WanderBehavior() : SeekBehavior(SteeringBehaviorType::Seek) {
-	SteeringBehavior::_behaviorType = SteeringBehaviorType::Wander;
+	FaceBehavior::_behaviorType = SteeringBehaviorType::Wander;
 }
 
-SteeringOutput WanderBehavior::Steering(const BehaviorData& behaviorData, ObjectBase& objectBase) {
-	_randomNumber = universalFunctions->RandomBinomialFloat(-1, 1) * behaviorData.wanderRate;
-	//Set the current wander orientation based on a random value combined with the wander rate
-	_wanderOrientation += _randomNumber;
+SteeringOutput WanderBehavior::Steering(const BehaviorData& behaviorData, ObjectBase& objectBase) const {
+	//Set the current wander orientation of the agent based on a random value combined with the wander rate
+	SteeringState& steeringState = objectBase.GetSteeringState();
+	steeringState.wanderOrientation += universalFunctions->RandomBinomialFloat(-1, 1) * behaviorData.wanderRate;
 
 	//Calculates the combined orientation between the enemy and the current wanderOrientation
-	_targetOrientation = _wanderOrientation + objectBase.GetOrientation();
+	const float targetOrientation = steeringState.wanderOrientation + objectBase.GetOrientation();
 
 	//Calculates the center position of the target
-	_targetPosition = objectBase.GetPosition() - (universalFunctions->OrientationAsVector(objectBase.GetOrientation()) * behaviorData.wanderOffset);
+	const Vector2<float> targetPosition = objectBase.GetPosition() - (universalFunctions->OrientationAsVector(objectBase.GetOrientation()) * behaviorData.wanderOffset);
 
 	//If the target is near the border, add rotation based to prevent it from going outside
-	if (universalFunctions->OutsideBorderX(_targetPosition.x, _outOfBorderOffset) || universalFunctions->OutsideBorderY(_targetPosition.y, _outOfBorderOffset)) {
+	if (universalFunctions->OutsideBorderX(targetPosition.x, _outOfBorderOffset) || universalFunctions->OutsideBorderY(targetPosition.y, _outOfBorderOffset)) {
 		if (objectBase.GetRotation() >= 0) {
 			objectBase.SetRotation(objectBase.GetRotation() + behaviorData.maxRotation * deltaTime);
 
@@ -384,10 +413,10 @@ SteeringOutput WanderBehavior::Steering(const BehaviorData& behaviorData, Object
 	}
 
 	//Adds the orientation and wanderRadius as an offset to the targetPosition
-	objectBase.SetTargetPosition(_targetPosition - (universalFunctions->OrientationAsVector(_targetOrientation) * behaviorData.wanderRadius));
+	objectBase.SetTargetPosition(targetPosition - (universalFunctions->OrientationAsVector(targetOrientation) * behaviorData.wanderRadius));
 	
 	debugDrawer->AddDebugCross(objectBase.GetTargetPosition(), 15.f, { 0, 255, 0, 255 });
-	debugDrawer->AddDebugCircle(_targetPosition, behaviorData.wanderRadius, { 0, 255,0,255 });
+	debugDrawer->AddDebugCircle(targetPosition, behaviorData.wanderRadius, { 0, 255,0,255 });
 
 	return { SeekBehavior::Steering(behaviorData, objectBase).linearVelocity, FaceBehavior::Steering(behaviorData, objectBase).angularVelocity };
 }
@@ -431,6 +460,18 @@ bool BlendSteering::ReplaceSteeringBehavior(const SteeringBehaviorType& oldBehav
 	return false;
 }
 
+//Fills the weights of the group if the steering batch can run every behaviour in it
+bool BlendSteering::GetBatchWeights(SteeringWeights& weights) const {
+	weights.fill(0.f);
+	for (auto& behavior : _behaviorsMap) {
+		if (!SteeringBatch::IsBatched(behavior.first)) {
+			return false;
+		}
+		weights[(unsigned int)behavior.first] = behavior.second.weight;
+	}
+	return true;
+}
+
 SteeringOutput PrioritySteering::Steering(const BehaviorData& behaviorData, ObjectBase& objectBase) {
 	_result.linearVelocity = { 0.f, 0.f };
 	_result.angularVelocity = 0.f;
@@ -476,7 +517,15 @@ bool PrioritySteering::ReplaceSteeringBehavior(const SteeringBehaviorType& oldBe
 	return false;
 }
 
-SteeringOutput SteeringBehavior::Steering(const BehaviorData& behaviorData, ObjectBase& objectBase) {
+//A single group is always used, so its blend is the whole steering. With more groups the first one that steers wins, which the batch does not do
+bool PrioritySteering::GetBatchWeights(SteeringWeights& weights) const {
+	if (_groups.size() != 1) {
+		return false;
+	}
+	return _groups[0].GetBatchWeights(weights);
+}
+
+SteeringOutput SteeringBehavior::Steering(const BehaviorData&, ObjectBase&) const {
 	return SteeringOutput();
 }
 
@@ -1,7 +1,9 @@
 #pragma once
-#include "rayCast.h"
+#include "collisionKernels.h"
+#include "spatialIndex.h"
 #include "vector2.h"
 
+#include <array>
 #include <memory>
 #include <unordered_map>
 #include <vector>
@@ -34,50 +36,41 @@ struct SteeringOutput {
 	float angularVelocity = 0.f;
 };
 
+/*The behaviours keep no state between calls, so one instance of each is shared by every agent.
+State that has to last between ticks, like the wander orientation, lives in the agent's SteeringState*/
 class SteeringBehavior {
 public:
 	SteeringBehavior() {}
 	~SteeringBehavior() {}
-	virtual SteeringOutput Steering(const BehaviorData& behaviorData, ObjectBase& objectBase);
+	virtual SteeringOutput Steering(const BehaviorData& behaviorData, ObjectBase& objectBase) const;
 	virtual const SteeringBehaviorType GetBehaviorType() const;
 
 protected:
 	SteeringBehaviorType _behaviorType = SteeringBehaviorType::Count;
-	SteeringOutput _result;
 };
 
 class AlignBehavior : public SteeringBehavior {
 public:
 	AlignBehavior();
 	~AlignBehavior() {}
-	SteeringOutput Steering(const BehaviorData& behaviorData, ObjectBase& objectBase) override;
+	SteeringOutput Steering(const BehaviorData& behaviorData, ObjectBase& objectBase) const override;
 
 protected:
-	float _targetOrientation = 0.f;
-
-private:
-	float _angularAcceleration = 0.f;
-	float _wantedRotation = 0.f;
-	float _rotation = 0.f;
-	float _rotationSize = 0.f;
+	SteeringOutput AlignToOrientation(const BehaviorData& behaviorData, const ObjectBase& objectBase, const float& targetOrientation) const;
 };
 class FaceBehavior : public AlignBehavior {
 public:
 	FaceBehavior();
 	~FaceBehavior() {}
 
-	SteeringOutput Steering(const BehaviorData& behaviorData, ObjectBase& objectBase) override;
-
-private:
-	Vector2<float> _direction = { 0.f, 0.f };
-
+	SteeringOutput Steering(const BehaviorData& behaviorData, ObjectBase& objectBase) const override;
 };
 class LookAtDirectionBehavior : public AlignBehavior {
 public:
 	LookAtDirectionBehavior();
 	~LookAtDirectionBehavior() {}
 
-	SteeringOutput Steering(const BehaviorData& behaviorData, ObjectBase& objectBase) override;
+	SteeringOutput Steering(const BehaviorData& behaviorData, ObjectBase& objectBase) const override;
 };
 
 class ArriveBehavior : public SteeringBehavior {
@@ -85,14 +78,7 @@ public:
 	ArriveBehavior();
 	~ArriveBehavior() {}
 
-	SteeringOutput Steering(const BehaviorData& behaviorData, ObjectBase& objectBase) override;
-
-private:
-	Vector2<float> _targetVelocity = { 0.f, 0.f };
-	Vector2<float> _direction = { 0.f, 0.f };
-
-	float _targetSpeed = 0.f;
-	float _distance = 0.f;
+	SteeringOutput Steering(const BehaviorData& behaviorData, ObjectBase& objectBase) const override;
 };
 
 class CollisionAvoidanceBehavior : public SteeringBehavior {
@@ -100,29 +86,7 @@ public:
 	CollisionAvoidanceBehavior();
 	~CollisionAvoidanceBehavior() {}
 
-	SteeringOutput Steering(const BehaviorData& behaviorData, ObjectBase& objectBase) override;
-
-private:
-	std::shared_ptr<Circle> _currentCollider = nullptr;
-
-	bool _gotTarget = false;
-
-	Vector2<float> _firstTargetPosition = { 0.f, 0.f };
-	Vector2<float> _firstRelativePos = { 0.f, 0.f };
-	Vector2<float> _firstRelativeVel = { 0.f, 0.f };
-
-	Vector2<float> _relativePos = { 0.f, 0.f };
-	Vector2<float> _relativeVel = { 0.f, 0.f };
-
-	float _firstMinSeparation = 0.f;
-	float _firstDistance = 0.f;
-
-	float _relativeSpeed = 0.f;
-	float _timeToCollision = 0.f;
-	float _distance = 0.f;
-	float _minSeparation = 0.f;
-
-	float _shortestTime = FLT_MAX;
+	SteeringOutput Steering(const BehaviorData& behaviorData, ObjectBase& objectBase) const override;
 };
 
 class SeekBehavior : public SteeringBehavior {
@@ -130,7 +94,7 @@ public:
 	SeekBehavior(const SteeringBehaviorType& behaviorType);
 	~SeekBehavior() {}
 
-	SteeringOutput Steering(const BehaviorData& behaviorData, ObjectBase& objectBase) override;
+	SteeringOutput Steering(const BehaviorData& behaviorData, ObjectBase& objectBase) const override;
 
 };
 class ObstacleAvoidanceBehavior : public SeekBehavior {
@@ -138,29 +102,14 @@ public:
 	ObstacleAvoidanceBehavior();
 	~ObstacleAvoidanceBehavior() {}
 
-	SteeringOutput Steering(const BehaviorData& behaviorData, ObjectBase& objectBase) override;
-
-private:
-	std::shared_ptr<AABB> _currentCollider = nullptr;
-	std::shared_ptr<Circle> _circleCollider = nullptr;
-	std::vector<std::shared_ptr<ObjectBase>> _queriedObstacles;
-
-	Ray _ray;
-	Ray _whiskerA;
-	Ray _whiskerB;
-	RayPoint _rayPoint;
+	SteeringOutput Steering(const BehaviorData& behaviorData, ObjectBase& objectBase) const override;
 };
 class PursueBehavior : public SeekBehavior {
 public:
 	PursueBehavior(const SteeringBehaviorType& behaviorType);
 	~PursueBehavior() {}
 
-	SteeringOutput Steering(const BehaviorData& behaviorData, ObjectBase& objectBase) override;
-
-private:
-	float _distance = 0.f;
-	float _speed = 0.f;
-	float _prediction = 0.f;
+	SteeringOutput Steering(const BehaviorData& behaviorData, ObjectBase& objectBase) const override;
 };
 
 class SeparationBehavior : public SteeringBehavior {
@@ -168,13 +117,10 @@ public:
 	SeparationBehavior(const SteeringBehaviorType& behaviorType);
 	~SeparationBehavior() {}
 
-	SteeringOutput Steering(const BehaviorData& behaviorData, ObjectBase& objectBase) override;
+	SteeringOutput Steering(const BehaviorData& behaviorData, ObjectBase& objectBase) const override;
 
 private:
-	Vector2<float> _targetPosition = Vector2<float>(0, 0);
-	Vector2<float> _direction = Vector2<float>(0, 0);
-	float _distance = 0;
-	float _strength = 0.f;
+	void AddNeighbourSteering(const BehaviorData& behaviorData, const ObjectBase& objectBase, const ObjectBase& neighbour, SteeringOutput& result) const;
 };
 
 class VelocityMatchBehavior : public SteeringBehavior {
@@ -182,7 +128,7 @@ public:
 	VelocityMatchBehavior();
 	~VelocityMatchBehavior() {}
 
-	SteeringOutput Steering(const BehaviorData& behaviorData, ObjectBase& objectBase) override;
+	SteeringOutput Steering(const BehaviorData& behaviorData, ObjectBase& objectBase) const override;
 };
 
 class WanderBehavior : public FaceBehavior, public SeekBehavior {
@@ -190,14 +136,10 @@ public:
 	WanderBehavior();
 	~WanderBehavior() {}
 
-	SteeringOutput Steering(const BehaviorData& behaviorData, ObjectBase& objectBase) override;
+	SteeringOutput Steering(const BehaviorData& behaviorData, ObjectBase& objectBase) const override;
 
 private:
-	Vector2<float> _targetPosition = { 0.f, 0.f };
-
 	float _outOfBorderOffset = 25.f;
-	float _randomNumber = 0.f;
-	float _wanderOrientation = 0.f;
 };
 
 struct BehaviorAndWeight {
@@ -205,6 +147,9 @@ struct BehaviorAndWeight {
 	float weight = 1.f;
 };
 
+//The weight of every behaviour type in a blend group, 0 for the types the group does not use
+using SteeringWeights = std::array<float, (unsigned int)SteeringBehaviorType::Count>;
+
 class BlendSteering {
 public:
 	BlendSteering() {}
@@ -218,6 +163,8 @@ public:
 	bool RemoveSteeringBehavior(const SteeringBehaviorType& behaviorType);
 	bool ReplaceSteeringBehavior(const SteeringBehaviorType& oldBehaviorType, const BehaviorAndWeight& newBehavior);
 
+	bool GetBatchWeights(SteeringWeights& weights) const;
+
 private:
 	SteeringOutput _result;
 	SteeringOutput _currentSteering;
@@ -240,6 +187,8 @@ public:
 	bool RemoveSteeringBheavior(const SteeringBehaviorType& oldBehaviorType);
 	bool ReplaceSteeringBehavior(const SteeringBehaviorType& oldBehaviorType, const BehaviorAndWeight& newBehavior);
 
+	bool GetBatchWeights(SteeringWeights& weights) const;
+
 private:
 	std::vector<BlendSteering> _groups;
 	SteeringOutput _result;
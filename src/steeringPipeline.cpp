@@ -0,0 +1,324 @@
+#include "steeringPipeline.h"
+
+#include "collisionKernels.h"
+#include "gameEngine.h"
+#include "managerBase.h"
+#include "objectBase.h"
+#include "universalFunctions.h"
+
+//Copies the state the pipelines read, the neighbours are only copied for agents that use separation
+void SteeringAgents::Add(const ObjectBase& objectBase, const BehaviorData& behaviorData, const SteeringWeights& agentWeights) {
+	const Vector2<float> position = objectBase.GetPosition();
+	const Vector2<float> velocity = objectBase.GetVelocity();
+	const Vector2<float> targetPosition = objectBase.GetTargetPosition();
+	positionX.emplace_back(position.x);
+	positionY.emplace_back(position.y);
+	velocityX.emplace_back(velocity.x);
+	velocityY.emplace_back(velocity.y);
+	targetX.emplace_back(targetPosition.x);
+	targetY.emplace_back(targetPosition.y);
+	targetsVelocityX.emplace_back(behaviorData.targetsVelocity.x);
+	targetsVelocityY.emplace_back(behaviorData.targetsVelocity.y);
+	orientation.emplace_back(objectBase.GetOrientation());
+	rotation.emplace_back(objectBase.GetRotation());
+	targetOrientation.emplace_back(behaviorData.targetOrientation);
+
+	timeToTarget.emplace_back(behaviorData.timeToTarget);
+	maxLinearAcceleration.emplace_back(behaviorData.maxLinearAcceleration);
+	maxSpeed.emplace_back(behaviorData.maxSpeed);
+	linearSlowDownRadius.emplace_back(behaviorData.linearSlowDownRadius);
+	linearTargetRadius.emplace_back(behaviorData.linearTargetRadius);
+	maxPrediction.emplace_back(behaviorData.maxPrediction);
+	angularSlowDownRadius.emplace_back(behaviorData.angularSlowDownRadius);
+	angularTargetRadius.emplace_back(behaviorData.angularTargetRadius);
+	maxAngularAcceleration.emplace_back(behaviorData.maxAngularAcceleration);
+	maxRotation.emplace_back(behaviorData.maxRotation);
+	separationThreshold.emplace_back(behaviorData.separationThreshold);
+	decayCoefficient.emplace_back(behaviorData.decayCoefficient);
+
+	for (unsigned int i = 0; i < agentWeights.size(); i++) {
+		weights[i].emplace_back(agentWeights[i]);
+	}
+	firstNeighbour.emplace_back(neighbourX.size());
+	if (agentWeights[(unsigned int)SteeringBehaviorType::Separation] != 0.f) {
+		//Same neighbours as the separation behaviour, the closest few if the manager found them, otherwise everything the broad phase found
+		const std::vector<std::shared_ptr<ObjectBase>>& neighbours = behaviorData.maxSeparationNeighbours > 0 ? objectBase.GetNearestObjects() : objectBase.GetQueriedObjects();
+		for (unsigned int i = 0; i < neighbours.size(); i++) {
+			if (neighbours[i]->GetObjectID() == objectBase.GetObjectID()) {
+				continue;
+			}
+			const Vector2<float> neighbourPosition = neighbours[i]->GetPosition();
+			neighbourX.emplace_back(neighbourPosition.x);
+			neighbourY.emplace_back(neighbourPosition.y);
+		}
+	}
+	neighbourCount.emplace_back(neighbourX.size() - firstNeighbour.back());
+	linearX.emplace_back(0.f);
+	linearY.emplace_back(0.f);
+	angular.emplace_back(0.f);
+}
+
+void SteeringAgents::Clear() {
+	positionX.clear();
+	positionY.clear();
+	velocityX.clear();
+	velocityY.clear();
+	targetX.clear();
+	targetY.clear();
+	targetsVelocityX.clear();
+	targetsVelocityY.clear();
+	orientation.clear();
+	rotation.clear();
+	targetOrientation.clear();
+
+	timeToTarget.clear();
+	maxLinearAcceleration.clear();
+	maxSpeed.clear();
+	linearSlowDownRadius.clear();
+	linearTargetRadius.clear();
+	maxPrediction.clear();
+	angularSlowDownRadius.clear();
+	angularTargetRadius.clear();
+	maxAngularAcceleration.clear();
+	maxRotation.clear();
+	separationThreshold.clear();
+	decayCoefficient.clear();
+
+	for (unsigned int i = 0; i < weights.size(); i++) {
+		weights[i].clear();
+	}
+
+	firstNeighbour.clear();
+	neighbourCount.clear();
+	neighbourX.clear();
+	neighbourY.clear();
+
+	linearX.clear();
+	linearY.clear();
+	angular.clear();
+}
+
+void SteeringAgents::ClearSteering(const unsigned int& first, const unsigned int& last) {
+	for (unsigned int i = first; i < last; i++) {
+		linearX[i] = 0.f;
+		linearY[i] = 0.f;
+		angular[i] = 0.f;
+	}
+}
+
+const unsigned int SteeringAgents::Size() const {
+	return positionX.size();
+}
+
+const SteeringOutput SteeringAgents::GetSteering(const unsigned int& index) const {
+	SteeringOutput steeringOutput;
+	steeringOutput.linearVelocity = { linearX[index], linearY[index] };
+	steeringOutput.angularVelocity = angular[index];
+	return steeringOutput;
+}
+
+void SteeringAgents::SetSteering(const unsigned int& index, const SteeringOutput& steeringOutput) {
+	linearX[index] = steeringOutput.linearVelocity.x;
+	linearY[index] = steeringOutput.linearVelocity.y;
+	angular[index] = steeringOutput.angularVelocity;
+}
+
+/*Full groups of agents go through the widest instruction set the build has, the remainder through the scalar lane.
+The same loop is in the seek and pursue kernels*/
+void ArriveSteering::Run(SteeringAgents& agents, const unsigned int& first, const unsigned int& last) {
+	unsigned int index = first;
+#if defined(COLLISION_KERNELS_AVX) || defined(COLLISION_KERNELS_SSE)
+	for (; index + SimdLanes::count <= last; index += SimdLanes::count) {
+		RunLanes<SimdLanes>(agents, index);
+	}
+#endif
+	for (; index < last; index++) {
+		RunLanes<ScalarLanes>(agents, index);
+	}
+}
+
+//Same steps as ArriveBehavior, the branches are turned into selects so every lane takes the same path
+template<typename Lanes>
+inline void ArriveSteering::RunLanes(SteeringAgents& agents, const unsigned int& index) {
+	using Type = typename Lanes::Type;
+	const Type zero = Lanes::Broadcast(0.f);
+	const Type deltaX = Lanes::Sub(Lanes::Load(&agents.targetX[index]), Lanes::Load(&agents.positionX[index]));
+	const Type deltaY = Lanes::Sub(Lanes::Load(&agents.targetY[index]), Lanes::Load(&agents.positionY[index]));
+	const Type distance = Lanes::Sqrt(Lanes::Add(Lanes::Mul(deltaX, deltaX), Lanes::Mul(deltaY, deltaY)));
+
+	const Type maxSpeed = Lanes::Load(&agents.maxSpeed[index]);
+	const Type slowDownRadius = Lanes::Load(&agents.linearSlowDownRadius[index]);
+	const Type targetSpeed = Lanes::Select(Lanes::Greater(distance, slowDownRadius), maxSpeed, Lanes::Div(Lanes::Mul(maxSpeed, distance), slowDownRadius));
+	const typename Lanes::Mask moving = Lanes::Greater(distance, zero);
+	const Type targetVelocityX = Lanes::Select(moving, Lanes::Mul(Lanes::Div(deltaX, distance), targetSpeed), zero);
+	const Type targetVelocityY = Lanes::Select(moving, Lanes::Mul(Lanes::Div(deltaY, distance), targetSpeed), zero);
+
+	const Type timeToTarget = Lanes::Load(&agents.timeToTarget[index]);
+	Type linearX = Lanes::Div(Lanes::Sub(targetVelocityX, Lanes::Load(&agents.velocityX[index])), timeToTarget);
+	Type linearY = Lanes::Div(Lanes::Sub(targetVelocityY, Lanes::Load(&agents.velocityY[index])), timeToTarget);
+
+	const Type maxLinearAcceleration = Lanes::Load(&agents.maxLinearAcceleration[index]);
+	const Type acceleration = Lanes::Sqrt(Lanes::Add(Lanes::Mul(linearX, linearX), Lanes::Mul(linearY, linearY)));
+	const typename Lanes::Mask limited = Lanes::Greater(acceleration, maxLinearAcceleration);
+	linearX = Lanes::Select(limited, Lanes::Mul(Lanes::Div(linearX, acceleration), maxLinearAcceleration), linearX);
+	linearY = Lanes::Select(limited, Lanes::Mul(Lanes::Div(linearY, acceleration), maxLinearAcceleration), linearY);
+
+	//Inside the target radius the agent has arrived and the behaviour does not steer
+	const typename Lanes::Mask arrived = Lanes::Less(distance, Lanes::Load(&agents.linearTargetRadius[index]));
+	const Type weight = Lanes::Load(&agents.weights[(unsigned int)SteeringBehaviorType::Arrive][index]);
+	Lanes::Store(&agents.linearX[index], Lanes::Add(Lanes::Load(&agents.linearX[index]), Lanes::Mul(weight, Lanes::Select(arrived, zero, linearX))));
+	Lanes::Store(&agents.linearY[index], Lanes::Add(Lanes::Load(&agents.linearY[index]), Lanes::Mul(weight, Lanes::Select(arrived, zero, linearY))));
+}
+
+void SeekSteering::Run(SteeringAgents& agents, const unsigned int& first, const unsigned int& last) {
+	unsigned int index = first;
+#if defined(COLLISION_KERNELS_AVX) || defined(COLLISION_KERNELS_SSE)
+	for (; index + SimdLanes::count <= last; index += SimdLanes::count) {
+		RunLanes<SimdLanes>(agents, index);
+	}
+#endif
+	for (; index < last; index++) {
+		RunLanes<ScalarLanes>(agents, index);
+	}
+}
+
+//Seek and flee steer along the same line, flee is seek with a negative weight
+template<typename Lanes>
+inline void SeekSteering::RunLanes(SteeringAgents& agents, const unsigned int& index) {
+	using Type = typename Lanes::Type;
+	Type linearX;
+	Type linearY;
+	Acceleration<Lanes>(Lanes::Sub(Lanes::Load(&agents.targetX[index]), Lanes::Load(&agents.positionX[index])),
+		Lanes::Sub(Lanes::Load(&agents.targetY[index]), Lanes::Load(&agents.positionY[index])),
+		Lanes::Load(&agents.maxLinearAcceleration[index]), Lanes::Load(&agents.maxSpeed[index]), linearX, linearY);
+
+	const Type weight = Lanes::Sub(Lanes::Load(&agents.weights[(unsigned int)SteeringBehaviorType::Seek][index]),
+		Lanes::Load(&agents.weights[(unsigned int)SteeringBehaviorType::Flee][index]));
+	Lanes::Store(&agents.linearX[index], Lanes::Add(Lanes::Load(&agents.linearX[index]), Lanes::Mul(weight, linearX)));
+	Lanes::Store(&agents.linearY[index], Lanes::Add(Lanes::Load(&agents.linearY[index]), Lanes::Mul(weight, linearY)));
+}
+
+//Full acceleration along the delta, which SeekBehavior then limits to the max speed
+template<typename Lanes>
+inline void SeekSteering::Acceleration(const typename Lanes::Type& deltaX, const typename Lanes::Type& deltaY, const typename Lanes::Type& maxLinearAcceleration,
+	const typename Lanes::Type& maxSpeed, typename Lanes::Type& linearX, typename Lanes::Type& linearY) {
+	using Type = typename Lanes::Type;
+	const Type zero = Lanes::Broadcast(0.f);
+	const Type distance = Lanes::Sqrt(Lanes::Add(Lanes::Mul(deltaX, deltaX), Lanes::Mul(deltaY, deltaY)));
+	const typename Lanes::Mask moving = Lanes::Greater(distance, zero);
+	const Type acceleration = Lanes::Min(maxLinearAcceleration, maxSpeed);
+	linearX = Lanes::Select(moving, Lanes::Mul(Lanes::Div(deltaX, distance), acceleration), zero);
+	linearY = Lanes::Select(moving, Lanes::Mul(Lanes::Div(deltaY, distance), acceleration), zero);
+}
+
+void PursueSteering::Run(SteeringAgents& agents, const unsigned int& first, const unsigned int& last) {
+	unsigned int index = first;
+#if defined(COLLISION_KERNELS_AVX) || defined(COLLISION_KERNELS_SSE)
+	for (; index + SimdLanes::count <= last; index += SimdLanes::count) {
+		RunLanes<SimdLanes>(agents, index);
+	}
+#endif
+	for (; index < last; index++) {
+		RunLanes<ScalarLanes>(agents, index);
+	}
+}
+
+/*Seeks the position the target will have once the agent could reach it at its current speed, never further ahead than maxPrediction.
+Unlike PursueBehavior the predicted position is not written back to the agent, so the other behaviours still steer toward the target itself*/
+template<typename Lanes>
+inline void PursueSteering::RunLanes(SteeringAgents& agents, const unsigned int& index) {
+	using Type = typename Lanes::Type;
+	const Type positionX = Lanes::Load(&agents.positionX[index]);
+	const Type positionY = Lanes::Load(&agents.positionY[index]);
+	const Type targetX = Lanes::Load(&agents.targetX[index]);
+	const Type targetY = Lanes::Load(&agents.targetY[index]);
+	const Type deltaX = Lanes::Sub(targetX, positionX);
+	const Type deltaY = Lanes::Sub(targetY, positionY);
+	const Type distance = Lanes::Sqrt(Lanes::Add(Lanes::Mul(deltaX, deltaX), Lanes::Mul(deltaY, deltaY)));
+	const Type velocityX = Lanes::Load(&agents.velocityX[index]);
+	const Type velocityY = Lanes::Load(&agents.velocityY[index]);
+	const Type speed = Lanes::Sqrt(Lanes::Add(Lanes::Mul(velocityX, velocityX), Lanes::Mul(velocityY, velocityY)));
+
+	//Compared as speed * maxPrediction <= distance so a standing agent never divides by its speed
+	const Type maxPrediction = Lanes::Load(&agents.maxPrediction[index]);
+	const Type prediction = Lanes::Select(Lanes::LessEqual(Lanes::Mul(speed, maxPrediction), distance), maxPrediction, Lanes::Div(distance, speed));
+	const Type predictedX = Lanes::Add(targetX, Lanes::Mul(Lanes::Load(&agents.targetsVelocityX[index]), prediction));
+	const Type predictedY = Lanes::Add(targetY, Lanes::Mul(Lanes::Load(&agents.targetsVelocityY[index]), prediction));
+
+	Type linearX;
+	Type linearY;
+	SeekSteering::Acceleration<Lanes>(Lanes::Sub(predictedX, positionX), Lanes::Sub(predictedY, positionY),
+		Lanes::Load(&agents.maxLinearAcceleration[index]), Lanes::Load(&agents.maxSpeed[index]), linearX, linearY);
+
+	const Type weight = Lanes::Sub(Lanes::Load(&agents.weights[(unsigned int)SteeringBehaviorType::Pursue][index]),
+		Lanes::Load(&agents.weights[(unsigned int)SteeringBehaviorType::Evade][index]));
+	Lanes::Store(&agents.linearX[index], Lanes::Add(Lanes::Load(&agents.linearX[index]), Lanes::Mul(weight, linearX)));
+	Lanes::Store(&agents.linearY[index], Lanes::Add(Lanes::Load(&agents.linearY[index]), Lanes::Mul(weight, linearY)));
+}
+
+//Turns toward the target orientation of the agent
+void AlignSteering::Run(SteeringAgents& agents, const unsigned int& first, const unsigned int& last) {
+	const std::vector<float>& weights = agents.weights[(unsigned int)SteeringBehaviorType::Align];
+	for (unsigned int i = first; i < last; i++) {
+		agents.angular[i] += weights[i] * Steering(agents, i, agents.targetOrientation[i]);
+	}
+}
+
+//Same steps as AlignBehavior for one agent
+const float AlignSteering::Steering(const SteeringAgents& agents, const unsigned int& index, const float& targetOrientation) {
+	const float rotation = universalFunctions->WrapMinMax(targetOrientation - agents.orientation[index], -PI, PI);
+	const float rotationSize = std::abs(rotation);
+	if (rotationSize < agents.angularTargetRadius[index]) {
+		return 0.f;
+	}
+	float wantedRotation = agents.maxRotation[index];
+	if (rotationSize <= agents.angularSlowDownRadius[index]) {
+		wantedRotation = agents.maxRotation[index] * rotationSize / agents.angularSlowDownRadius[index];
+	}
+	wantedRotation *= rotation / rotationSize;
+
+	float angularVelocity = (wantedRotation - agents.rotation[index]) / agents.timeToTarget[index];
+	const float angularAcceleration = std::abs(angularVelocity);
+	if (angularAcceleration > agents.maxAngularAcceleration[index]) {
+		angularVelocity /= angularAcceleration;
+		angularVelocity *= agents.maxAngularAcceleration[index];
+	}
+	return angularVelocity;
+}
+
+//Turns toward the direction of the target position, the atan2 keeps it one agent at a time
+void FaceSteering::Run(SteeringAgents& agents, const unsigned int& first, const unsigned int& last) {
+	const std::vector<float>& weights = agents.weights[(unsigned int)SteeringBehaviorType::Face];
+	for (unsigned int i = first; i < last; i++) {
+		const float deltaX = agents.targetX[i] - agents.positionX[i];
+		const float deltaY = agents.targetY[i] - agents.positionY[i];
+		const float distance = std::sqrt(deltaX * deltaX + deltaY * deltaY);
+		if (distance > 0.f) {
+			agents.angular[i] += weights[i] * AlignSteering::Steering(agents, i, atan2f(deltaX / distance, -deltaY / distance));
+		}
+	}
+}
+
+//Pushes every agent away from the neighbours inside its threshold, with a strength that falls off with the square of the distance
+void SeparationSteering::Run(SteeringAgents& agents, const unsigned int& first, const unsigned int& last) {
+	const std::vector<float>& weights = agents.weights[(unsigned int)SteeringBehaviorType::Separation];
+	for (unsigned int i = first; i < last; i++) {
+		float linearX = 0.f;
+		float linearY = 0.f;
+		const unsigned int lastNeighbour = agents.firstNeighbour[i] + agents.neighbourCount[i];
+		for (unsigned int j = agents.firstNeighbour[i]; j < lastNeighbour; j++) {
+			const float deltaX = agents.positionX[i] - agents.neighbourX[j];
+			const float deltaY = agents.positionY[i] - agents.neighbourY[j];
+			const float distance = std::sqrt(deltaX * deltaX + deltaY * deltaY);
+			if (distance >= agents.separationThreshold[i] || distance <= 0.f) {
+				continue;
+			}
+			float strength = agents.decayCoefficient[i] / (distance * distance);
+			strength = strength < agents.maxLinearAcceleration[i] ? strength : agents.maxLinearAcceleration[i];
+			linearX += deltaX / distance * strength;
+			linearY += deltaY / distance * strength;
+		}
+		agents.linearX[i] += weights[i] * linearX;
+		agents.linearY[i] += weights[i] * linearY;
+	}
+}
@@ -0,0 +1,172 @@
+#pragma once
+#include "steeringBehavior.h"
+#include "vector2.h"
+
+#include <cfloat>
+#include <cmath>
+#include <vector>
+
+struct BehaviorData;
+class ObjectBase;
+
+//The steering pipeline of every enemy archetype, Count leaves the enemy to its own priority steering
+enum class SteeringPipelineType {
+	HumanSurvival,
+	HumanFormation,
+	Boar,
+	BoarBoss,
+	Count
+};
+
+//The state of every agent in a steering batch with one array per field, so a behaviour reads the same field of several agents with one instruction
+struct SteeringAgents {
+	void Add(const ObjectBase& objectBase, const BehaviorData& behaviorData, const SteeringWeights& agentWeights);
+	void Clear();
+	void ClearSteering(const unsigned int& first, const unsigned int& last);
+	const unsigned int Size() const;
+
+	const SteeringOutput GetSteering(const unsigned int& index) const;
+	void SetSteering(const unsigned int& index, const SteeringOutput& steeringOutput);
+
+	std::vector<float> positionX;
+	std::vector<float> positionY;
+	std::vector<float> velocityX;
+	std::vector<float> velocityY;
+	std::vector<float> targetX;
+	std::vector<float> targetY;
+	std::vector<float> targetsVelocityX;
+	std::vector<float> targetsVelocityY;
+	std::vector<float> orientation;
+	std::vector<float> rotation;
+	std::vector<float> targetOrientation;
+
+	std::vector<float> timeToTarget;
+	std::vector<float> maxLinearAcceleration;
+	std::vector<float> maxSpeed;
+	std::vector<float> linearSlowDownRadius;
+	std::vector<float> linearTargetRadius;
+	std::vector<float> maxPrediction;
+	std::vector<float> angularSlowDownRadius;
+	std::vector<float> angularTargetRadius;
+	std::vector<float> maxAngularAcceleration;
+	std::vector<float> maxRotation;
+	std::vector<float> separationThreshold;
+	std::vector<float> decayCoefficient;
+
+	std::array<std::vector<float>, (unsigned int)SteeringBehaviorType::Count> weights;
+
+	//The neighbours of agent i are neighbourX/Y[firstNeighbour[i]] up to neighbourCount[i] positions later
+	std::vector<unsigned int> firstNeighbour;
+	std::vector<unsigned int> neighbourCount;
+	std::vector<float> neighbourX;
+	std::vector<float> neighbourY;
+
+	//The blended steering every behaviour adds to
+	std::vector<float> linearX;
+	std::vector<float> linearY;
+	std::vector<float> angular;
+};
+
+/*Stateless behaviours the steering batch runs, each adds its weighted steering to the agents in [first, last).
+They give the same steering as the behaviour classes of the same name, the linear ones steer several agents with one instruction*/
+struct ArriveSteering {
+	static void Run(SteeringAgents& agents, const unsigned int& first, const unsigned int& last);
+	static bool Steers(const SteeringBehaviorType& behaviorType) {
+		return behaviorType == SteeringBehaviorType::Arrive;
+	}
+
+	template<typename Lanes>
+	static void RunLanes(SteeringAgents& agents, const unsigned int& index);
+};
+struct SeekSteering {
+	static void Run(SteeringAgents& agents, const unsigned int& first, const unsigned int& last);
+	static bool Steers(const SteeringBehaviorType& behaviorType) {
+		return behaviorType == SteeringBehaviorType::Seek || behaviorType == SteeringBehaviorType::Flee;
+	}
+
+	template<typename Lanes>
+	static void RunLanes(SteeringAgents& agents, const unsigned int& index);
+	template<typename Lanes>
+	static void Acceleration(const typename Lanes::Type& deltaX, const typename Lanes::Type& deltaY, const typename Lanes::Type& maxLinearAcceleration,
+		const typename Lanes::Type& maxSpeed, typename Lanes::Type& linearX, typename Lanes::Type& linearY);
+};
+struct PursueSteering {
+	static void Run(SteeringAgents& agents, const unsigned int& first, const unsigned int& last);
+	static bool Steers(const SteeringBehaviorType& behaviorType) {
+		return behaviorType == SteeringBehaviorType::Pursue || behaviorType == SteeringBehaviorType::Evade;
+	}
+
+	template<typename Lanes>
+	static void RunLanes(SteeringAgents& agents, const unsigned int& index);
+};
+struct AlignSteering {
+	static void Run(SteeringAgents& agents, const unsigned int& first, const unsigned int& last);
+	static bool Steers(const SteeringBehaviorType& behaviorType) {
+		return behaviorType == SteeringBehaviorType::Align;
+	}
+
+	static const float Steering(const SteeringAgents& agents, const unsigned int& index, const float& targetOrientation);
+};
+struct FaceSteering {
+	static void Run(SteeringAgents& agents, const unsigned int& first, const unsigned int& last);
+	static bool Steers(const SteeringBehaviorType& behaviorType) {
+		return behaviorType == SteeringBehaviorType::Face;
+	}
+};
+struct SeparationSteering {
+	static void Run(SteeringAgents& agents, const unsigned int& first, const unsigned int& last);
+	static bool Steers(const SteeringBehaviorType& behaviorType) {
+		return behaviorType == SteeringBehaviorType::Separation;
+	}
+};
+
+//Runs every behaviour over the range, each one adds to the same steering
+template<typename... Behaviors>
+struct Blend {
+	static void Run(SteeringAgents& agents, const unsigned int& first, const unsigned int& last) {
+		(Behaviors::Run(agents, first, last), ...);
+	}
+	static bool Steers(const SteeringBehaviorType& behaviorType) {
+		return (Behaviors::Steers(behaviorType) || ...);
+	}
+};
+
+/*Every agent uses the first group that steers it, the same rule as PrioritySteering.
+The later groups are only run if there is one, a pipeline with one group is just its blend.
+An agent has one weight per behaviour type, so the groups of one pipeline should not share a behaviour*/
+template<typename Group, typename... FallbackGroups>
+struct Priority {
+	static void Run(SteeringAgents& agents, const unsigned int& first, const unsigned int& last);
+	static bool Steers(const SteeringBehaviorType& behaviorType) {
+		if constexpr (sizeof...(FallbackGroups) > 0) {
+			return Group::Steers(behaviorType) || Priority<FallbackGroups...>::Steers(behaviorType);
+		}
+		return Group::Steers(behaviorType);
+	}
+};
+
+using HumanSurvivalSteering = Priority<Blend<ArriveSteering, FaceSteering, SeparationSteering>>;
+using HumanFormationSteering = Priority<Blend<ArriveSteering, AlignSteering, SeparationSteering>>;
+using BoarSteering = Priority<Blend<ArriveSteering, FaceSteering, SeparationSteering>>;
+using BoarBossSteering = Priority<Blend<ArriveSteering, FaceSteering>>;
+
+template<typename Group, typename... FallbackGroups>
+inline void Priority<Group, FallbackGroups...>::Run(SteeringAgents& agents, const unsigned int& first, const unsigned int& last) {
+	Group::Run(agents, first, last);
+	if constexpr (sizeof...(FallbackGroups) > 0) {
+		//Every worker keeps its own scratch and every depth of the priority is its own function, so nothing is allocated once it has grown
+		thread_local std::vector<SteeringOutput> groupSteering;
+		groupSteering.resize(last - first);
+		for (unsigned int i = first; i < last; i++) {
+			groupSteering[i - first] = agents.GetSteering(i);
+		}
+		agents.ClearSteering(first, last);
+		Priority<FallbackGroups...>::Run(agents, first, last);
+		for (unsigned int i = first; i < last; i++) {
+			const SteeringOutput& steeringOutput = groupSteering[i - first];
+			if (steeringOutput.linearVelocity.absolute() > FLT_EPSILON || std::abs(steeringOutput.angularVelocity) > FLT_EPSILON) {
+				agents.SetSteering(i, steeringOutput);
+			}
+		}
+	}
+}
@@ -1,17 +1,16 @@
 #include "textSprite.h"
 #include "gameEngine.h"
 
-#include <SDL2/SDL.h>
-
 void TextSprite::Init(const char* fontType, int fontSize, const char* text, const SDL_Color& color) {
-	_font = TTF_OpenFont(fontType, fontSize);
-	_textSurface = TTF_RenderText_Solid(_font, text, color);
-	_textTexture = SDL_CreateTextureFromSurface(renderer, _textSurface);
+	_fontType = fontType;
+	_fontSize = fontSize;
+	_textTexture = renderBackend->CreateTextTexture(_fontType, _fontSize, text, color);
 }
 
+//The texture of the old text is destroyed before the new one is made
 void TextSprite::ChangeText(const char* text, const SDL_Color& color) {
-	_textSurface = TTF_RenderText_Solid(_font, text, color);
-	_textTexture = SDL_CreateTextureFromSurface(renderer, _textSurface);
+	ClearText();
+	_textTexture = renderBackend->CreateTextTexture(_fontType, _fontSize, text, color);
 }
 
 void TextSprite::SetPosition(const Vector2<float>& position) {
@@ -19,16 +18,15 @@ void TextSprite::SetPosition(const Vector2<float>& position) {
 }
 
 void TextSprite::ClearText() {
-	SDL_FreeSurface(_textSurface);
-	SDL_DestroyTexture(_textTexture);
+	renderBackend->DestroyTexture(_textTexture);
 }
 
 void TextSprite::Render() {	
-	_textDist = { _position.x, _position.y, (float)_textSurface->w, (float)_textSurface->h };
-	SDL_RenderCopyF(renderer, _textTexture, nullptr, &_textDist);
+	_textDist = { _position.x, _position.y, (float)_textTexture.width, (float)_textTexture.height };
+	renderBackend->DrawTexture(_textTexture, nullptr, _textDist);
 }
 
 void TextSprite::RenderCentered() {
-	_textDist = { (_position.x - _textSurface->w / 2), _position.y - _textSurface->h / 2, (float)_textSurface->w, (float)_textSurface->h };
-	SDL_RenderCopyF(renderer, _textTexture, nullptr, &_textDist);
+	_textDist = { (_position.x - _textTexture.width / 2), _position.y - _textTexture.height / 2, (float)_textTexture.width, (float)_textTexture.height };
+	renderBackend->DrawTexture(_textTexture, nullptr, _textDist);
 }
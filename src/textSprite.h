@@ -1,12 +1,10 @@
 #pragma once
-#include <SDL2/SDL_ttf.h>
 #include <SDL2/SDL_pixels.h>
 
+#include "renderBackend.h"
 #include "vector2.h"
 
-class SDL_Surface;
-class SDL_Texture;
-
+//Text drawn through the renderBackend, the null backend only gives it an estimated size
 class TextSprite {
 public:
 	void Init(const char* fontType, int fontSize, const char* text, const SDL_Color& color);
@@ -21,9 +19,10 @@ public:
 	void RenderCentered();
 
 private:
-	TTF_Font* _font;
-	SDL_Surface * _textSurface;
-	SDL_Texture* _textTexture;
+	const char* _fontType = nullptr;
+	int _fontSize = 0;
+
+	RenderTexture _textTexture;
 	
 	SDL_FRect _textDist;
 
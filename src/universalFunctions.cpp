@@ -1,10 +1,12 @@
 #include "universalFunctions.h"
 #include "gameEngine.h"
 #include "objectBase.h"
+#include "renderBackend.h"
+
+#include <cfloat>
 
 Vector2<float> UniversalFunctions::GetCursorPosition() {
-	SDL_GetMouseState(&_intPosition.x, &_intPosition.y);
-	return Vector2<float>(_intPosition.x, _intPosition.y);
+	return renderBackend->GetCursorPosition();
 }
 
 bool UniversalFunctions::IsInDistance(const Vector2<float>& positionA, const Vector2<float>& positionB, const float& distance) {
@@ -36,6 +36,5 @@ private:
 	Vector2<float> _floatPosition;
 
 	Vector2<int> _cursorPosition;
-	Vector2<int> _intPosition;
 
 };
\ No newline at end of file
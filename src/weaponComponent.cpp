@@ -1,6 +1,8 @@
 #include "weaponComponent.h"
 
 #include "collision.h"
+#include "commandBuffer.h"
+#include "debugDrawer.h"
 #include "enemyBase.h"
 #include "gameEngine.h"
 #include "objectPool.h"
@@ -36,7 +38,7 @@ void WeaponComponent::Update() {
 
 void WeaponComponent::Render() {
 	if (_renderWeapon) {
-		_sprite->RenderWithOrientation(0, _position, _orientation);
+		_sprite->RenderWithOrientation(0, GetRenderPosition(), GetRenderOrientation());
 	}
 }
 
@@ -187,7 +189,7 @@ bool StaffComponent::UpdateAttack() {
 
 bool StaffComponent::ExecuteAttack() {
 	_direction = ((_owner->GetTargetObject()->GetPosition() - _owner->GetPosition()).normalized());
-	projectileManager->SpawnProjectile(_owner, _projectileType, universalFunctions->VectorAsOrientation(_direction),
+	commandBuffer->AddProjectileSpawn(_owner, _projectileType, universalFunctions->VectorAsOrientation(_direction),
 		_direction, _position, _attackDamage, _projectileSpeed);
 	_owner->SetVelocity({ 0.f, 0.f });
 	return true;
@@ -244,7 +246,7 @@ bool SuperStaffComponent::ExecuteAttack() {
 	for (unsigned int i = 0; i < _multiShotAmount; i++) {
 		_multiShotDirection = _direction.rotated(_multiShotAngle);
 
-		projectileManager->SpawnProjectile(_owner, _projectileType, universalFunctions->VectorAsOrientation(_direction) + _multiShotAngle,
+		commandBuffer->AddProjectileSpawn(_owner, _projectileType, universalFunctions->VectorAsOrientation(_direction) + _multiShotAngle,
 			_multiShotDirection, _position, _attackDamage, _projectileSpeed);
 		_multiShotAngle += _angleOffset;
 	}
@@ -301,7 +303,7 @@ bool SwordComponent::UpdateAttack() {
 
 bool SwordComponent::ExecuteAttack() {
 	if (universalFunctions->IsInDistance(_owner->GetTargetObject()->GetPosition(), _owner->GetPosition(), _attackRange)) {
-		_owner->GetTargetObject()->TakeDamage(_attackDamage);
+		commandBuffer->AddDamage(_owner->GetTargetObject(), _attackDamage);
 	}
 	_owner->SetVelocity({ 0.f, 0.f });
 	_owner->SetRotation(0.f);
@@ -360,7 +362,7 @@ bool WarstompComponent::UpdateAttack() {
 
 bool WarstompComponent::ExecuteAttack() {
 	if (universalFunctions->IsInDistance(_owner->GetTargetObject()->GetPosition(), _owner->GetPosition(), _attackRange)) {
-		_owner->GetTargetObject()->TakeDamage(_attackDamage);
+		commandBuffer->AddDamage(_owner->GetTargetObject(), _attackDamage);
 	}
 	_owner->SetVelocity({ 0.f, 0.f });
 	_owner->SetRotation(0.f);
@@ -435,9 +437,37 @@ bool TusksComponent::UpdateAttack() {
 	return false;
 }
 
+/*The dash step is swept against obstacles and the target's layer, so a fast dash or a long frame neither passes through an obstacle nor skips over the target.
+The dash ends where it first touches an obstacle and only damages the targets it reaches before that*/
 bool TusksComponent::ExecuteAttack() {
-	_owner->SetPosition(_owner->GetPosition() + _dashDirection * _dashSpeed * deltaTime);
-	_distanceTraveled += _dashSpeed * deltaTime;
+	const Vector2<float> displacement = _dashDirection * _dashSpeed * deltaTime;
+	const ObjectType targetType = _owner->GetTargetObject()->GetObjectType();
+	const bool canDamage = !_isJumpback && !_damageCooldown->GetIsActive();
+	float travelledFraction = 1.f;
+	bool hitObstacle = false;
+	_sweepHits.clear();
+	spatialIndex->SweepQuery(*std::static_pointer_cast<Circle>(_owner->GetCollider()), displacement, _sweepHits,
+		ToCollisionLayer(ObjectType::Obstacle) | ToCollisionLayer(targetType));
+	for (unsigned int i = 0; i < _sweepHits.size(); i++) {
+		if (_sweepHits[i].object == _owner) {
+			continue;
+		}
+		//An obstacle the owner already overlaps does not stop it, otherwise it could never dash out of it
+		if (_sweepHits[i].object->GetObjectType() == ObjectType::Obstacle) {
+			if (_sweepHits[i].timeOfImpact > 0.f) {
+				travelledFraction = _sweepHits[i].timeOfImpact;
+				hitObstacle = true;
+				break;
+			}
+			continue;
+		}
+		if (canDamage && _sweepHits[i].object->GetObjectType() == targetType) {
+			commandBuffer->AddDamage(_sweepHits[i].object, _attackDamage);
+			_damageCooldown->ResetTimer();
+		}
+	}
+	_owner->SetPosition(_owner->GetPosition() + displacement * travelledFraction);
+	_distanceTraveled += _dashSpeed * deltaTime * travelledFraction;
 	_formerPosition = _owner->GetPosition();
 	if (universalFunctions->OutsideBorderX(_owner->GetPosition().x, _owner->GetSprite()->GetHeight() * 0.25f)) {
 		_formerPosition.x = _oldPosition.x;
@@ -447,17 +477,7 @@ bool TusksComponent::ExecuteAttack() {
 		_formerPosition.y = _oldPosition.y;
 		_owner->SetPosition(_formerPosition);
 	}
-	if (!_isJumpback) {
-		if (!_damageCooldown->GetIsActive()) {
-			for (unsigned int i = 0; i < _owner->GetQueriedObjects().size(); i++) {
-				if (_owner->GetQueriedObjects()[i]->GetObjectType() == _owner->GetTargetObject()->GetObjectType()) {
-					_owner->GetQueriedObjects()[i]->TakeDamage(_attackDamage);
-					_damageCooldown->ResetTimer();
-				}
-			}
-		}
-	}
-	if (_distanceTraveled > _dashDistance) {
+	if (hitObstacle || _distanceTraveled > _dashDistance) {
 		return true;
 
 	} 
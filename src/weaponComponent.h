@@ -1,9 +1,11 @@
 #pragma once
 #include "objectBase.h"
 #include "projectile.h"
+#include "spatialIndex.h"
 #include "vector2.h"
 
 #include <memory>
+#include <vector>
 
 class Circle;
 class Sprite;
@@ -164,6 +166,7 @@ public:
 private:
 	const char* _path = "res/sprites/Tusks.png";
 	std::shared_ptr<Timer> _damageCooldown = nullptr;
+	std::vector<SweepHit<std::shared_ptr<ObjectBase>>> _sweepHits;
 
 	bool _isJumpback = false;
 
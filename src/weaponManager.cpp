@@ -1,8 +1,9 @@
 #include "weaponManager.h"
 
+#include "gameEngine.h"
 #include "objectBase.h"
 #include "objectPool.h"
-#include "quadTree.h"
+#include "spatialIndex.h"
 #include "weaponComponent.h"
 
 WeaponManager::WeaponManager() {
@@ -33,6 +34,7 @@ std::shared_ptr<WeaponComponent> WeaponManager::SpawnWeapon(const WeaponType& we
 	_currentWeapon = _weaponPools[weaponType]->SpawnObject();
 	_currentWeapon->SetOwner(owner);
 	_currentWeapon->SetValuesToDefault();
+	_currentWeapon->ResetPreviousState();
 	_activeObjects.insert(std::make_pair(_currentWeapon->GetObjectID(), _currentWeapon));
 	return _currentWeapon;
 }
@@ -62,18 +64,10 @@ void WeaponManager::CreateWeapon(const WeaponType& weaponType) {
 	}
 }
 
-void WeaponManager::InsertObjectsQuadtree() {
-	for (auto& object : _activeObjects) {
-		if (!object.second->GetCollider()->GetIsActive()) {
-			continue;
-		}
-		objectBaseQuadTree->Insert(object.second, object.second->GetCollider());
-	}
-}
-
 void WeaponManager::RemoveAllObjects() {
 	for (auto& weapon : _activeObjects) {
 		_currentWeapon = CastAsWeapon(weapon.second);
+		spatialIndex->Remove(weapon.second);
 		_currentWeapon->DeactivateObject();
 		_weaponPools[_currentWeapon->GetWeaponType()]->PoolObject(_currentWeapon);
 	}
@@ -86,6 +80,7 @@ void WeaponManager::RemoveObject(const unsigned int& objectID) {
 		return;
 	}
 	_currentWeapon = CastAsWeapon(_activeObjects[objectID]);
+	spatialIndex->Remove(_activeObjects[objectID]);
 	_currentWeapon->DeactivateObject();
 	_weaponPools[_currentWeapon->GetWeaponType()]->PoolObject(_currentWeapon);
 	_activeObjects.erase(objectID);
@@ -15,7 +15,6 @@ public:
 	void Init() override;
 	void Update() override;
 
-	void InsertObjectsQuadtree() override;
 	void RemoveAllObjects() override;
 	void RemoveObject(const unsigned int& objectID) override;
 	void Reset() override;
@@ -0,0 +1,227 @@
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include "../src/boundingVolumeHierarchy.h"
+#include "../src/collision.h"
+#include "../src/jobSystem.h"
+#include "../src/layeredSpatialIndex.h"
+#include "../src/linearQuadTree.h"
+#include "../src/quadTree.h"
+#include "../src/spatialHashGrid.h"
+
+/*Moves, removes and inserts circles and boxes in each spatial index and checks every kind of query against testing all colliders one by one.
+The regular quadtree is left out, it places a collider that straddles a split line on one side only and is not meant to find every overlap.
+The bounding volume hierarchy rebuilds its tree on every change, so like the obstacles it holds in the game its objects stay where they were inserted*/
+namespace {
+	const float worldWidth = 1280.f;
+	const float worldHeight = 720.f;
+	const unsigned int objectCount = 3000;
+	const unsigned int frameCount = 30;
+	const unsigned int queriesPerFrame = 200;
+	const unsigned int layerCount = 3;
+	//Range, nearest, ray and sweep queries
+	const unsigned int queryKindCount = 4;
+
+	struct TestObjects {
+		std::vector<std::shared_ptr<Collider>> colliders;
+		std::vector<unsigned int> layers;
+		std::vector<bool> inserted;
+	};
+
+	const std::shared_ptr<Collider> RandomCollider(std::mt19937& randomEngine, const float& minSize, const float& maxSize) {
+		std::uniform_real_distribution<float> x(maxSize, worldWidth - maxSize);
+		std::uniform_real_distribution<float> y(maxSize, worldHeight - maxSize);
+		std::uniform_real_distribution<float> size(minSize, maxSize);
+		if (randomEngine() % 4 == 0) {
+			std::shared_ptr<AABB> box = std::make_shared<AABB>();
+			box->Init(Vector2<float>(x(randomEngine), y(randomEngine)), size(randomEngine), size(randomEngine));
+			return box;
+		}
+		std::shared_ptr<Circle> circle = std::make_shared<Circle>();
+		circle->Init(Vector2<float>(x(randomEngine), y(randomEngine)), size(randomEngine) / 2);
+		return circle;
+	}
+
+	//The k objects whose centre is nearest to the point and within maxDistance, nearest first
+	bool NearestMatches(SpatialIndex<unsigned int>& spatialIndex, const TestObjects& objects, const Vector2<float>& point, const unsigned int& k, const float& maxDistance, const unsigned int& layerMask) {
+		std::vector<unsigned int> objectsFound;
+		spatialIndex.QueryNearest(point, k, maxDistance, objectsFound, layerMask);
+
+		std::vector<std::pair<float, unsigned int>> expected;
+		for (unsigned int i = 0; i < objectCount; i++) {
+			const Vector2<float> delta = objects.colliders[i]->GetPosition() - point;
+			const float distanceSquared = delta.x * delta.x + delta.y * delta.y;
+			if (objects.inserted[i] && (objects.layers[i] & layerMask) && distanceSquared <= maxDistance * maxDistance) {
+				expected.push_back(std::make_pair(distanceSquared, i));
+			}
+		}
+		std::sort(expected.begin(), expected.end());
+		expected.resize(std::min<unsigned int>(k, expected.size()));
+		if (objectsFound.size() != expected.size()) {
+			return false;
+		}
+		for (unsigned int i = 0; i < expected.size(); i++) {
+			if (objectsFound[i] != expected[i].second) {
+				return false;
+			}
+		}
+		return true;
+	}
+
+	//The first collider along the ray
+	bool RayMatches(SpatialIndex<unsigned int>& spatialIndex, const TestObjects& objects, const Ray& ray, const unsigned int& layerMask) {
+		const RayHit<unsigned int> rayHit = spatialIndex.RayQuery(ray, layerMask);
+
+		RayHit<unsigned int> expected;
+		float distance = 0.f;
+		Vector2<float> normal = { 0.f, 0.f };
+		for (unsigned int i = 0; i < objectCount; i++) {
+			if (objects.inserted[i] && (objects.layers[i] & layerMask) && SpatialIndex<unsigned int>::RayCastCollider(ray, *objects.colliders[i], distance, normal) &&
+				(!expected.hit || distance < expected.distance)) {
+				expected.object = i;
+				expected.distance = distance;
+				expected.hit = true;
+			}
+		}
+		return rayHit.hit == expected.hit && (!expected.hit || rayHit.object == expected.object);
+	}
+
+	//Every collider the moving circle touches, in order of time of impact
+	bool SweepMatches(SpatialIndex<unsigned int>& spatialIndex, const TestObjects& objects, const Circle& circle, const Vector2<float>& displacement, const unsigned int& layerMask) {
+		std::vector<SweepHit<unsigned int>> hits;
+		spatialIndex.SweepQuery(circle, displacement, hits, layerMask);
+		if (!std::is_sorted(hits.begin(), hits.end(), [](const SweepHit<unsigned int>& hitA, const SweepHit<unsigned int>& hitB) { return hitA.timeOfImpact < hitB.timeOfImpact; })) {
+			return false;
+		}
+		//Colliders touched at the same time can come in any order, so both sides are compared sorted by object as well
+		std::vector<std::pair<float, unsigned int>> hitsFound;
+		for (unsigned int i = 0; i < hits.size(); i++) {
+			hitsFound.push_back(std::make_pair(hits[i].timeOfImpact, hits[i].object));
+		}
+		std::sort(hitsFound.begin(), hitsFound.end());
+
+		std::vector<std::pair<float, unsigned int>> expected;
+		float timeOfImpact = 0.f;
+		for (unsigned int i = 0; i < objectCount; i++) {
+			if (objects.inserted[i] && (objects.layers[i] & layerMask) && SweptCircleIntersect(circle, displacement, *objects.colliders[i], timeOfImpact)) {
+				expected.push_back(std::make_pair(timeOfImpact, i));
+			}
+		}
+		std::sort(expected.begin(), expected.end());
+		return hitsFound == expected;
+	}
+
+	//Returns how many queries found something else than the brute force
+	unsigned int CheckAgainstBruteForce(SpatialIndex<unsigned int>& spatialIndex, const bool& moveObjects) {
+		std::mt19937 randomEngine(7);
+		std::uniform_real_distribution<float> step(-12.f, 12.f);
+		std::uniform_real_distribution<float> angle(0.f, 6.2831853f);
+		std::uniform_real_distribution<float> distance(20.f, 400.f);
+		std::uniform_real_distribution<float> radius(4.f, 20.f);
+		TestObjects objects;
+		for (unsigned int i = 0; i < objectCount; i++) {
+			objects.colliders.push_back(RandomCollider(randomEngine, 4.f, 40.f));
+			objects.layers.push_back(1 << (i % layerCount));
+			objects.inserted.push_back(spatialIndex.Insert(i, objects.colliders[i], objects.layers[i]));
+		}
+
+		unsigned int failedQueries = 0;
+		std::vector<unsigned int> objectsFound;
+		std::vector<unsigned int> expected;
+		for (unsigned int frame = 0; frame < frameCount; frame++) {
+			for (unsigned int i = 0; i < objectCount && moveObjects; i++) {
+				if (!objects.inserted[i]) {
+					continue;
+				}
+				const Vector2<float> position = objects.colliders[i]->GetPosition();
+				objects.colliders[i]->SetPosition(Vector2<float>(std::clamp(position.x + step(randomEngine), 40.f, worldWidth - 40.f), std::clamp(position.y + step(randomEngine), 40.f, worldHeight - 40.f)));
+				spatialIndex.Update(i, objects.colliders[i], objects.layers[i]);
+			}
+			//A tenth of the objects leaves and comes back every few frames so removed entries and reused slots are queried too
+			for (unsigned int i = frame % 10; i < objectCount && moveObjects; i += 10) {
+				if (frame % 3 == 0 && objects.inserted[i]) {
+					objects.inserted[i] = !spatialIndex.Remove(i);
+				} else if (frame % 3 == 1 && !objects.inserted[i]) {
+					objects.inserted[i] = spatialIndex.Insert(i, objects.colliders[i], objects.layers[i]);
+				}
+			}
+			spatialIndex.Rebuild();
+
+			for (unsigned int query = 0; query < queriesPerFrame; query++) {
+				const std::shared_ptr<Collider> range = RandomCollider(randomEngine, 10.f, 160.f);
+				const unsigned int layerMask = query % 4 == 0 ? allCollisionLayers : 1 << (query % layerCount);
+				objectsFound.clear();
+				spatialIndex.Query(range, objectsFound, layerMask);
+				std::sort(objectsFound.begin(), objectsFound.end());
+
+				expected.clear();
+				for (unsigned int i = 0; i < objectCount; i++) {
+					if (objects.inserted[i] && (objects.layers[i] & layerMask) && ColliderIntersect(*range, *objects.colliders[i])) {
+						expected.push_back(i);
+					}
+				}
+				failedQueries += objectsFound == expected ? 0 : 1;
+
+				const Vector2<float> point = range->GetPosition();
+				failedQueries += NearestMatches(spatialIndex, objects, point, 1 + query % 8, distance(randomEngine), layerMask) ? 0 : 1;
+
+				Ray ray;
+				const float rayAngle = angle(randomEngine);
+				ray.startPosition = point;
+				ray.direction = Vector2<float>(std::cos(rayAngle), std::sin(rayAngle));
+				ray.length = distance(randomEngine);
+				failedQueries += RayMatches(spatialIndex, objects, ray, layerMask) ? 0 : 1;
+
+				Circle circle;
+				circle.Init(point, radius(randomEngine));
+				const float sweepAngle = angle(randomEngine);
+				const Vector2<float> displacement = Vector2<float>(std::cos(sweepAngle), std::sin(sweepAngle)) * distance(randomEngine);
+				failedQueries += SweepMatches(spatialIndex, objects, circle, displacement, layerMask) ? 0 : 1;
+			}
+		}
+		return failedQueries;
+	}
+}
+
+int main() {
+	jobSystem = std::make_shared<JobSystem>();
+	jobSystem->Init(2);
+
+	QuadTreeNode boundary;
+	boundary.rectangle = std::make_shared<AABB>();
+	boundary.rectangle->Init(Vector2<float>(worldWidth / 2, worldHeight / 2), worldHeight, worldWidth);
+
+	QuadTree<unsigned int> looseQuadTree(boundary, 8, QuadTreeType::Loose);
+	SpatialHashGrid<unsigned int> spatialHashGrid(*boundary.rectangle, 32.f);
+	LinearQuadTree<unsigned int> linearQuadTree(8);
+	BoundingVolumeHierarchy<unsigned int> boundingVolumeHierarchy(4);
+	//One partition per test layer, each with another backend
+	LayeredSpatialIndex<unsigned int> layeredSpatialIndex;
+	layeredSpatialIndex.AddPartition(1 << 0, std::make_shared<SpatialHashGrid<unsigned int>>(*boundary.rectangle, 32.f));
+	layeredSpatialIndex.AddPartition(1 << 1, std::make_shared<LinearQuadTree<unsigned int>>(8));
+	layeredSpatialIndex.AddPartition(1 << 2, std::make_shared<QuadTree<unsigned int>>(boundary, 8, QuadTreeType::Loose));
+	//The name of every index, the index and whether its objects move
+	const std::vector<std::tuple<const char*, SpatialIndex<unsigned int>*, bool>> spatialIndexes = {
+		{ "Loose quadtree", &looseQuadTree, true },
+		{ "Spatial hash grid", &spatialHashGrid, true },
+		{ "Linear quadtree", &linearQuadTree, true },
+		{ "Bounding volume hierarchy", &boundingVolumeHierarchy, false },
+		{ "Layered spatial index", &layeredSpatialIndex, true }
+	};
+
+	unsigned int failedIndexes = 0;
+	for (const auto& [name, spatialIndex, moveObjects] : spatialIndexes) {
+		const unsigned int failedQueries = CheckAgainstBruteForce(*spatialIndex, moveObjects);
+		std::cout << name << ": " << failedQueries << " of " << frameCount * queriesPerFrame * queryKindCount << " queries differ from brute force" << std::endl;
+		failedIndexes += failedQueries == 0 ? 0 : 1;
+	}
+
+	jobSystem->ShutDown();
+	return failedIndexes == 0 ? 0 : 1;
+}